@@ -0,0 +1,56 @@
+// Lookups of URL-like string keys: the adaptive radix tree, whose cost
+// follows the key length, against the red-black map, whose cost grows with
+// log n string comparisons.
+// Usage: art_map_bench.out [keys]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../s21_containers/art_map/art_map.h"
+#include "../s21_containers/map/map.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Map>
+double lookupNs(const std::vector<std::string>& keys,
+                const std::vector<std::string>& probes) {
+  Map map;
+  for (const auto& key : keys) map.insert(key, 1);
+
+  std::size_t found = 0;
+  auto start = Clock::now();
+  for (int round = 0; round < 5; ++round) {
+    for (const auto& probe : probes) found += map.contains(probe);
+  }
+  double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  if (found != 5 * probes.size()) std::exit(1);
+  return ns / (5 * probes.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500000;
+  std::mt19937 gen(11);
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < count; ++i) {
+    keys.push_back("https://host" + std::to_string(gen() % 64) +
+                   ".example.com/item/" + std::to_string(gen()));
+  }
+  std::vector<std::string> probes = keys;
+  std::shuffle(probes.begin(), probes.end(), gen);
+
+  double art = lookupNs<s21::art_map<std::string, int>>(keys, probes);
+  double tree = lookupNs<s21::map<std::string, int>>(keys, probes);
+  std::cout << count << " URL keys\n"
+            << "art_map: " << art << " ns/lookup\n"
+            << "map:     " << tree << " ns/lookup\n";
+  return 0;
+}
@@ -0,0 +1,60 @@
+// Red-black, AVL and WAVL balancing behind the same set, under a read-heavy
+// (95% find) and a write-heavy (50% insert/erase) mix of random operations.
+// Reports ns per operation and the final tree height.
+// Usage: balance_bench.out [keys]
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../s21_containers/set/set.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Storage>
+void runMix(const char* name, int count, int read_percent) {
+  std::mt19937 gen(5);
+  s21::set<int, Storage> set;
+  for (int i = 0; i < count; ++i) set.insert(gen() % (2 * count));
+
+  std::vector<unsigned> ops(4 * count);
+  for (auto& op : ops) op = gen();
+
+  std::size_t hits = 0;
+  auto start = Clock::now();
+  for (unsigned op : ops) {
+    int key = static_cast<int>(op >> 8) % (2 * count);
+    if (static_cast<int>(op % 100) < read_percent) {
+      hits += set.contains(key);
+    } else if (op & 128) {
+      set.insert(key);
+    } else {
+      auto it = set.find(key);
+      if (it != set.end()) set.erase(it);
+    }
+  }
+  double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+      ops.size();
+  std::cout << std::setw(6) << name << "  " << std::setw(3) << read_percent
+            << "% reads  " << std::fixed << std::setprecision(1)
+            << std::setw(7) << ns << " ns/op  height "
+            << set.memory_stats(s21::stats_mode::full).height << "  hits "
+            << hits << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  for (int read_percent : {95, 50}) {
+    runMix<s21::node_storage>("rb", count, read_percent);
+    runMix<s21::avl_storage>("avl", count, read_percent);
+    runMix<s21::wavl_storage>("wavl", count, read_percent);
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+// disk_map with a working set four times larger than its page cache: random
+// inserts, random point lookups and a full ordered scan, with cache hit rates.
+// Usage: disk_map_bench.out [cache_pages]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../s21_containers/disk_map/disk_map.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using DiskMap = s21::disk_map<std::uint64_t, std::uint64_t>;
+
+constexpr std::size_t kPageSize = 4096;
+// Random inserts leave leaves about 70% full.
+constexpr std::size_t kEntriesPerPage =
+    kPageSize / (2 * sizeof(std::uint64_t)) * 7 / 10;
+
+double elapsedNs(Clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start)
+      .count();
+}
+
+void report(const char* phase, double ns, std::size_t ops,
+            DiskMap::cache_stats before, DiskMap::cache_stats after) {
+  std::size_t hits = after.hits - before.hits;
+  std::size_t misses = after.misses - before.misses;
+  std::cout << phase << ": " << ns / ops << " ns/op, cache hit rate "
+            << 100.0 * hits / (hits + misses) << "%\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t cache_pages =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+  std::size_t entries = 4 * cache_pages * kEntriesPerPage;
+  std::string path =
+      (std::filesystem::temp_directory_path() / "s21_disk_map_bench.bin")
+          .string();
+  std::remove(path.c_str());
+
+  std::vector<std::uint64_t> keys(entries);
+  std::mt19937_64 gen(42);
+  for (auto& key : keys) key = gen();
+
+  {
+    DiskMap map(path, cache_pages, kPageSize);
+    auto before = map.stats();
+    auto start = Clock::now();
+    for (std::uint64_t key : keys) map.insert(key, key ^ 0x5a5a);
+    report("insert", elapsedNs(start), entries, before, map.stats());
+
+    std::shuffle(keys.begin(), keys.end(), gen);
+    before = map.stats();
+    start = Clock::now();
+    std::uint64_t checksum = 0;
+    for (std::uint64_t key : keys) checksum += map.at(key);
+    report("find", elapsedNs(start), entries, before, map.stats());
+
+    before = map.stats();
+    start = Clock::now();
+    std::size_t scanned = 0;
+    for (auto entry : map) {
+      checksum ^= entry.second;
+      ++scanned;
+    }
+    report("scan", elapsedNs(start), scanned, before, map.stats());
+    if (scanned != map.size()) return 1;
+    map.flush();
+
+    std::cout << entries << " entries, " << cache_pages << " cached pages of "
+              << kPageSize << " bytes, file "
+              << std::filesystem::file_size(path) / kPageSize << " pages"
+              << " (checksum " << checksum << ")\n";
+  }
+  std::remove(path.c_str());
+  return 0;
+}
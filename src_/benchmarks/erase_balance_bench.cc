@@ -0,0 +1,103 @@
+// Adversarial erase patterns on the red-black tree: descending erase,
+// alternating ends and random insert/erase churn. Reports the tree height
+// against the 2 log2(n + 1) bound and the lookup latency at checkpoints;
+// exits non-zero if the bound is ever exceeded.
+// Usage: erase_balance_bench.out [keys]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../s21_containers/tree/tree.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Tree = s21::RBTree<int>;
+
+bool report(const Tree& tree, const std::vector<int>& probes,
+            const char* pattern, int step) {
+  int height = tree.memory_stats(s21::stats_mode::full).height;
+  double bound = 2 * std::log2(static_cast<double>(tree.size()) + 1);
+
+  std::size_t found = 0;
+  auto start = Clock::now();
+  for (int probe : probes) found += tree.contains(probe);
+  double ns = std::chrono::duration<double, std::nano>(Clock::now() - start)
+                  .count() /
+              probes.size();
+
+  std::cout << std::setw(12) << pattern << " step " << std::setw(8) << step
+            << "  size " << std::setw(8) << tree.size() << "  height "
+            << std::setw(3) << height << " / " << std::fixed
+            << std::setprecision(1) << bound << "  lookup " << ns
+            << " ns  hits " << found << "\n";
+  return height <= bound;
+}
+
+// Fills the tree with 0..count-1 in random order, then applies erase_one
+// steps times and reports eight times along the way.
+bool run(const char* pattern, int count,
+         const std::function<void(Tree&, std::mt19937&)>& erase_one,
+         int steps) {
+  std::mt19937 gen(1);
+  std::vector<int> keys(count);
+  for (int i = 0; i < count; ++i) keys[i] = i;
+  std::shuffle(keys.begin(), keys.end(), gen);
+  Tree tree;
+  for (int key : keys) tree.insert(key);
+
+  std::vector<int> probes(10000);
+  for (int& probe : probes) probe = gen() % count;
+
+  bool ok = report(tree, probes, pattern, 0);
+  for (int step = 1; step <= steps && !tree.empty(); ++step) {
+    erase_one(tree, gen);
+    if (step % (steps / 8) == 0) ok = report(tree, probes, pattern, step) && ok;
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  bool ok = true;
+
+  ok = run("descending", count,
+           [](Tree& tree, std::mt19937&) { tree.erase(--tree.end()); },
+           count - 1) &&
+       ok;
+
+  int side = 0;
+  ok = run("alternating", count,
+           [&side](Tree& tree, std::mt19937&) {
+             tree.erase(side++ % 2 ? --tree.end() : tree.begin());
+           },
+           count - 1) &&
+       ok;
+
+  ok = run("churn", count,
+           [count](Tree& tree, std::mt19937& gen) {
+             int value = gen() % count;
+             auto it = tree.find(value);
+             if (it != tree.end()) {
+               tree.erase(it);
+             } else {
+               tree.insert(value);
+             }
+           },
+           4 * count) &&
+       ok;
+
+  if (!ok) {
+    std::cerr << "height bound exceeded\n";
+    return 1;
+  }
+  return 0;
+}
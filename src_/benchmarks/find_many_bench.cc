@@ -0,0 +1,66 @@
+// Batched lookups against a loop of contains() on a map larger than the LLC.
+// Usage: find_many_bench.out [elements] [batch]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../s21_containers/map/map.h"
+
+namespace {
+
+struct KeySlice {
+  const std::uint64_t* first;
+  const std::uint64_t* last;
+  const std::uint64_t* begin() const { return first; }
+  const std::uint64_t* end() const { return last; }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t elements =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+  std::size_t batch = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 256;
+
+  std::mt19937_64 rng(1);
+  s21::map<std::uint64_t, std::uint64_t> map;
+  std::vector<std::uint64_t> inserted;
+  inserted.reserve(elements);
+  while (map.size() < elements) {
+    std::uint64_t key = rng();
+    if (map.insert(key, key).second) inserted.push_back(key);
+  }
+
+  const std::size_t lookups = 4000000;
+  std::vector<std::uint64_t> keys(lookups);
+  for (auto& key : keys) {
+    key = rng() % 2 ? inserted[rng() % inserted.size()] : rng();
+  }
+
+  using Clock = std::chrono::steady_clock;
+  std::size_t hits_loop = 0;
+  auto start = Clock::now();
+  for (std::uint64_t key : keys) hits_loop += map.contains(key);
+  double loop_ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+  std::size_t hits_batched = 0;
+  std::vector<char> present(batch);
+  start = Clock::now();
+  for (std::size_t i = 0; i < lookups; i += batch) {
+    std::size_t end = std::min(i + batch, lookups);
+    map.contains_many(KeySlice{&keys[i], &keys[0] + end}, present.begin());
+    hits_batched += std::count(present.begin(), present.begin() + (end - i), 1);
+  }
+  double batched_ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+  std::cout << "elements=" << elements << " batch=" << batch << "\n"
+            << "contains loop: " << loop_ns / lookups << " ns/lookup\n"
+            << "contains_many: " << batched_ns / lookups << " ns/lookup\n";
+  return hits_loop == hits_batched ? 0 : 1;
+}
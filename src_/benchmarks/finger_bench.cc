@@ -0,0 +1,81 @@
+// Ascending lookups d positions apart, as when merging a sorted stream
+// against a map: find(key) from the root against find(hint, key) and a
+// cursor that seeks from its last position.
+// Usage: finger_bench.out [keys]
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "../s21_containers/map/map.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Map = s21::map<int, int>;
+
+// Best of three runs, per lookup.
+template <typename Fn>
+double timeNs(std::size_t count, Fn&& fn) {
+  double best = 0;
+  for (int run = 0; run < 3; ++run) {
+    auto start = Clock::now();
+    std::size_t found = fn();
+    double ns =
+        std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    if (found != count) std::exit(1);
+    if (run == 0 || ns < best) best = ns;
+  }
+  return best / count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < count; ++i) items.emplace_back(2 * i, i);
+  // Random insertion order, so neighbours in key order are not neighbours
+  // in memory.
+  std::srand(5);
+  for (int i = count - 1; i > 0; --i) {
+    std::swap(items[i], items[std::rand() % (i + 1)]);
+  }
+  Map map;
+  for (const auto& item : items) map.insert(item);
+
+  std::cout << "distance     root   finger   cursor\n";
+  for (int distance : {1, 4, 16, 256, 4096, 65536}) {
+    std::vector<int> keys;
+    for (int rank = 0; rank < count; rank += distance) keys.push_back(2 * rank);
+
+    double root = timeNs(keys.size(), [&] {
+      std::size_t found = 0;
+      for (int key : keys) found += map.contains(key);
+      return found;
+    });
+    double finger = timeNs(keys.size(), [&] {
+      std::size_t found = 0;
+      Map::iterator hint = map.end();
+      for (int key : keys) {
+        Map::iterator it = map.find(hint, key);
+        if (it != map.end()) {
+          hint = it;
+          ++found;
+        }
+      }
+      return found;
+    });
+    double cursor = timeNs(keys.size(), [&] {
+      std::size_t found = 0;
+      Map::cursor position(map);
+      for (int key : keys) found += position.seek(key);
+      return found;
+    });
+    std::cout << std::fixed << std::setprecision(1) << std::setw(8) << distance
+              << std::setw(9) << root << std::setw(9) << finger << std::setw(9)
+              << cursor << "  ns\n";
+  }
+  return 0;
+}
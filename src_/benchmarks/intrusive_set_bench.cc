@@ -0,0 +1,162 @@
+// An RBTree of pointers into an object pool against s21::intrusive_set
+// linking the same objects through an embedded hook: churn (erase one, link
+// another) and lookups, with heap allocations counted during the churn.
+// Usage: intrusive_set_bench.out [objects]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "../s21_containers/intrusive_set/intrusive_set.h"
+#include "../s21_containers/tree/tree.h"
+
+namespace {
+
+std::size_t allocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* memory = std::malloc(size)) return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Order {
+  int id = 0;
+  char payload[40] = {};
+  s21::intrusive_set_hook hook;
+};
+
+struct OrderLess {
+  bool operator()(const Order& lhs, const Order& rhs) const {
+    return lhs.id < rhs.id;
+  }
+  bool operator()(int lhs, const Order& rhs) const { return lhs < rhs.id; }
+  bool operator()(const Order& lhs, int rhs) const { return lhs.id < rhs; }
+};
+
+struct PointerLess {
+  bool operator()(const Order* lhs, const Order* rhs) const {
+    return lhs->id < rhs->id;
+  }
+};
+
+using Intrusive = s21::intrusive_set<Order, &Order::hook, OrderLess>;
+using Pointers = s21::RBTree<Order*, PointerLess>;
+
+struct Result {
+  double churn_ns;
+  double find_ns;
+  double allocations_per_churn;
+  std::size_t found;
+};
+
+double nsSince(Clock::time_point start, std::size_t ops) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start)
+             .count() /
+         ops;
+}
+
+// Half the pool is linked; each churn step unlinks a linked object and
+// links an unlinked one, so the tree size stays put.
+Result runIntrusive(std::vector<Order>& pool, const std::vector<int>& swaps,
+                    const std::vector<int>& probes) {
+  Intrusive set;
+  std::vector<Order*> in, out;
+  for (std::size_t i = 0; i < pool.size(); ++i) {
+    (i % 2 ? out : in).push_back(&pool[i]);
+  }
+  for (Order* order : in) set.insert(*order);
+
+  std::size_t before = allocations;
+  auto start = Clock::now();
+  for (int slot : swaps) {
+    std::size_t i = slot % in.size();
+    set.erase(*in[i]);
+    set.insert(*out[i]);
+    std::swap(in[i], out[i]);
+  }
+  double churn = nsSince(start, swaps.size());
+  std::size_t churn_allocations = allocations - before;
+
+  std::size_t found = 0;
+  start = Clock::now();
+  for (int id : probes) found += set.contains(id);
+  double find = nsSince(start, probes.size());
+  return {churn, find, static_cast<double>(churn_allocations) / swaps.size(),
+          found};
+}
+
+Result runPointers(std::vector<Order>& pool, const std::vector<int>& swaps,
+                   const std::vector<int>& probes) {
+  Pointers tree;
+  std::vector<Order*> in, out;
+  for (std::size_t i = 0; i < pool.size(); ++i) {
+    (i % 2 ? out : in).push_back(&pool[i]);
+  }
+  for (Order* order : in) tree.insert(order);
+
+  std::size_t before = allocations;
+  auto start = Clock::now();
+  for (int slot : swaps) {
+    std::size_t i = slot % in.size();
+    tree.erase(tree.find(in[i]));
+    tree.insert(out[i]);
+    std::swap(in[i], out[i]);
+  }
+  double churn = nsSince(start, swaps.size());
+  std::size_t churn_allocations = allocations - before;
+
+  // The pointer tree needs a probe object to search by id.
+  Order probe;
+  std::size_t found = 0;
+  start = Clock::now();
+  for (int id : probes) {
+    probe.id = id;
+    found += tree.contains(&probe);
+  }
+  double find = nsSince(start, probes.size());
+  return {churn, find, static_cast<double>(churn_allocations) / swaps.size(),
+          found};
+}
+
+void print(const char* name, const Result& result) {
+  std::cout << name << result.churn_ns << " ns/churn, " << result.find_ns
+            << " ns/find, " << result.allocations_per_churn
+            << " allocations per churn\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int objects = argc > 1 ? std::atoi(argv[1]) : 400000;
+  std::mt19937 gen(31);
+  std::vector<Order> pool(objects);
+  std::vector<int> ids(objects);
+  for (int i = 0; i < objects; ++i) ids[i] = i;
+  std::shuffle(ids.begin(), ids.end(), gen);
+  for (int i = 0; i < objects; ++i) pool[i].id = ids[i];
+
+  std::vector<int> swaps(2 * objects), probes(2 * objects);
+  for (int& slot : swaps) slot = gen() % objects;
+  for (int& id : probes) id = gen() % objects;
+
+  Result pointers = runPointers(pool, swaps, probes);
+  Result intrusive = runIntrusive(pool, swaps, probes);
+  // Both end with the same objects linked.
+  if (pointers.found != intrusive.found) return 1;
+  print("RBTree<Order*>: ", pointers);
+  print("intrusive_set:  ", intrusive);
+  return 0;
+}
@@ -0,0 +1,67 @@
+// Lookups of heap-allocated string keys with the cached 4-byte key prefix in
+// each node against the same tree and three-way compare without it.
+// Usage: key_prefix_bench.out [keys]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../s21_containers/tree/tree.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Same order and one-call compare as std::less<std::string>, but without
+// key_prefix_traits.
+struct UncachedLess {
+  using is_three_way = void;
+  bool operator()(const std::string& lhs, const std::string& rhs) const {
+    return lhs < rhs;
+  }
+  int three_way(const std::string& lhs, const std::string& rhs) const {
+    return lhs.compare(rhs);
+  }
+};
+
+template <typename Compare>
+double lookupNs(const std::vector<std::string>& keys,
+                const std::vector<std::string>& probes) {
+  s21::RBTree<std::string, Compare> tree;
+  for (const auto& key : keys) tree.insert(key);
+
+  std::size_t found = 0;
+  auto start = Clock::now();
+  for (int round = 0; round < 5; ++round) {
+    for (const auto& probe : probes) found += tree.contains(probe);
+  }
+  double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  if (found != 5 * probes.size()) std::exit(1);
+  return ns / (5 * probes.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500000;
+  std::mt19937 gen(7);
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < count; ++i) {
+    std::string key(24, ' ');
+    for (auto& c : key) c = static_cast<char>('a' + gen() % 26);
+    keys.push_back(key);
+  }
+  std::vector<std::string> probes = keys;
+  std::shuffle(probes.begin(), probes.end(), gen);
+
+  double cached = lookupNs<std::less<std::string>>(keys, probes);
+  double uncached = lookupNs<UncachedLess>(keys, probes);
+  std::cout << count << " keys of 24 bytes\n"
+            << "cached prefix: " << cached << " ns/lookup\n"
+            << "key only:      " << uncached << " ns/lookup\n";
+  return 0;
+}
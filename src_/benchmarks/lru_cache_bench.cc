@@ -0,0 +1,110 @@
+// A hand-rolled LRU cache (s21::map into a std::list) against s21::lru_cache
+// on the same get/put stream: time per operation and heap allocations per
+// inserted entry.
+// Usage: lru_cache_bench.out [capacity]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "../s21_containers/lru_cache/lru_cache.h"
+#include "../s21_containers/map/map.h"
+
+namespace {
+
+std::size_t allocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* memory = std::malloc(size)) return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class ListLru {
+ public:
+  explicit ListLru(std::size_t capacity) : capacity_(capacity) {}
+
+  int* get(int key) {
+    auto found = index_.find(index_.end(), key);
+    if (found == index_.end()) return nullptr;
+    auto it = found->second;
+    order_.splice(order_.begin(), order_, it);
+    return &it->second;
+  }
+
+  void put(int key, int value) {
+    if (int* cached = get(key)) {
+      *cached = value;
+      return;
+    }
+    order_.emplace_front(key, value);
+    index_.insert(key, order_.begin());
+    if (order_.size() > capacity_) {
+      index_.erase(index_.find(index_.end(), order_.back().first));
+      order_.pop_back();
+    }
+  }
+
+ private:
+  using List = std::list<std::pair<int, int>>;
+  std::size_t capacity_;
+  List order_;
+  s21::map<int, List::iterator> index_;
+};
+
+struct Result {
+  double ns;
+  double allocations_per_put;
+};
+
+// 80% gets, 20% puts over keys skewed towards a hot quarter, twice as many
+// keys as the cache holds.
+template <typename Cache>
+Result run(Cache& cache, const std::vector<int>& keys) {
+  std::size_t before = allocations;
+  std::size_t misses = 0;
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    if (i % 5 == 0 || !cache.get(keys[i])) {
+      cache.put(keys[i], static_cast<int>(i));
+      ++misses;
+    }
+  }
+  double ns = std::chrono::duration<double, std::nano>(Clock::now() - start)
+                  .count();
+  return {ns / keys.size(),
+          static_cast<double>(allocations - before) / misses};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int capacity = argc > 1 ? std::atoi(argv[1]) : 100000;
+  std::mt19937 gen(29);
+  std::uniform_int_distribution<int> any(0, 2 * capacity - 1);
+  std::uniform_int_distribution<int> hot(0, capacity / 2 - 1);
+  std::vector<int> keys(20 * capacity);
+  for (int& key : keys) key = gen() % 2 ? hot(gen) : any(gen);
+
+  ListLru list_cache(capacity);
+  s21::lru_cache<int, int> lru(capacity);
+  Result list_result = run(list_cache, keys);
+  Result lru_result = run(lru, keys);
+  std::cout << "map + list:  " << list_result.ns << " ns/op, "
+            << list_result.allocations_per_put << " allocations per put\n"
+            << "lru_cache:   " << lru_result.ns << " ns/op, "
+            << lru_result.allocations_per_put << " allocations per put\n";
+  return 0;
+}
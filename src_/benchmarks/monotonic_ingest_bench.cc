@@ -0,0 +1,59 @@
+// Monotonic ingest of time-ordered events: insert() with the cached maximum
+// and push_back_ordered(), with std::map::insert as a full-walk reference.
+// Usage: monotonic_ingest_bench.out [events]
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+
+#include "../s21_containers/map/map.h"
+
+namespace {
+
+struct Event {
+  std::uint32_t kind;
+  std::uint32_t payload;
+};
+
+using Clock = std::chrono::steady_clock;
+using EventMap = s21::map<std::uint64_t, Event>;
+
+template <typename Map, typename Ingest>
+double measure(std::size_t events, Ingest ingest) {
+  Map map;
+  auto start = Clock::now();
+  for (std::uint64_t ts = 0; ts < events; ++ts) {
+    ingest(map, typename Map::value_type(ts * 10, Event{1, 2}));
+  }
+  double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  if (map.size() != events) std::exit(1);
+  return ns / events;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t events =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+  double insert_ns =
+      measure<EventMap>(events, [](EventMap& map, const auto& value) {
+        map.insert(value);
+      });
+  double ordered_ns =
+      measure<EventMap>(events, [](EventMap& map, const auto& value) {
+        map.push_back_ordered(value);
+      });
+  using StdMap = std::map<std::uint64_t, Event>;
+  double std_ns = measure<StdMap>(events, [](StdMap& map, const auto& value) {
+    map.insert(value);
+  });
+
+  std::cout << "events=" << events << "\n"
+            << "insert (cached max): " << insert_ns << " ns/event\n"
+            << "push_back_ordered:   " << ordered_ns << " ns/event\n"
+            << "std::map::insert:    " << std_ns << " ns/event\n";
+  return 0;
+}
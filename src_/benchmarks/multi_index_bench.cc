@@ -0,0 +1,152 @@
+// The same records kept three times (an s21::map by id and s21::multimaps
+// by timestamp and by priority) against one s21::multi_index with three
+// orderings: heap bytes per record, and the cost of inserting and of moving
+// a record to a new timestamp.
+// Usage: multi_index_bench.out [records]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../s21_containers/multi_index/multi_index.h"
+#include "../s21_containers/multimap/multimap.h"  // and map.h
+
+namespace {
+
+std::size_t allocated_bytes = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  allocated_bytes += size;
+  if (void* memory = std::malloc(size)) return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Record {
+  int id = 0;
+  long timestamp = 0;
+  int priority = 0;
+  std::string owner;
+};
+
+class ThreeMaps {
+ public:
+  void insert(const Record& record) {
+    by_id_.insert(record.id, record);
+    by_time_.insert(record.timestamp, record);
+    by_priority_.insert(record.priority, record);
+  }
+
+  // Three lookups, an erase/insert pair and a scan to refresh the copy
+  // under the unchanged priority; nothing ties the three steps together.
+  void touch(int id, long timestamp) {
+    Record& record = by_id_.at(id);
+    auto range = by_time_.equal_range(record.timestamp);
+    while (range.first->second.id != id) ++range.first;
+    by_time_.erase(range.first);
+    record.timestamp = timestamp;
+    by_time_.insert(timestamp, record);
+    auto ranks = by_priority_.equal_range(record.priority);
+    while (ranks.first->second.id != id) ++ranks.first;
+    ranks.first->second.timestamp = timestamp;
+  }
+
+  long oldest() const { return by_time_.begin()->first; }
+
+ private:
+  s21::map<int, Record> by_id_;
+  s21::multimap<long, Record> by_time_;
+  s21::multimap<int, Record> by_priority_;
+};
+
+class MultiIndex {
+ public:
+  void insert(const Record& record) { records_.insert(record); }
+
+  void touch(int id, long timestamp) {
+    records_.modify(records_.get<0>().find(id),
+                    [&](Record& record) { record.timestamp = timestamp; });
+  }
+
+  long oldest() const { return records_.get<1>().begin()->timestamp; }
+
+ private:
+  s21::multi_index<
+      Record, s21::ordered_unique<s21::member_key<&Record::id>>,
+      s21::ordered_non_unique<s21::member_key<&Record::timestamp>>,
+      s21::ordered_non_unique<s21::member_key<&Record::priority>>>
+      records_;
+};
+
+struct Result {
+  double bytes_per_record;
+  double insert_ns;
+  double touch_ns;
+  long oldest;
+};
+
+double nsSince(Clock::time_point start, std::size_t ops) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start)
+             .count() /
+         ops;
+}
+
+template <typename Store>
+Result run(const std::vector<Record>& records,
+           const std::vector<std::pair<int, long>>& touches) {
+  Store store;
+  std::size_t before = allocated_bytes;
+  auto start = Clock::now();
+  for (const Record& record : records) store.insert(record);
+  double insert_ns = nsSince(start, records.size());
+  double bytes = static_cast<double>(allocated_bytes - before) /
+                 records.size();
+
+  start = Clock::now();
+  for (auto [id, timestamp] : touches) store.touch(id, timestamp);
+  return {bytes, insert_ns, nsSince(start, touches.size()), store.oldest()};
+}
+
+void print(const char* name, const Result& result) {
+  std::cout << name << result.bytes_per_record << " bytes/record, "
+            << result.insert_ns << " ns/insert, " << result.touch_ns
+            << " ns/touch\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+  std::mt19937 gen(37);
+  std::vector<Record> records(count);
+  for (int i = 0; i < count; ++i) {
+    records[i] = {i, static_cast<long>(gen() % 1000000),
+                  static_cast<int>(gen() % 1000),
+                  "worker-" + std::to_string(i)};
+  }
+  std::shuffle(records.begin(), records.end(), gen);
+  std::vector<std::pair<int, long>> touches(2 * count);
+  for (auto& [id, timestamp] : touches) {
+    id = gen() % count;
+    timestamp = 1000000 + gen() % 1000000;
+  }
+
+  Result maps = run<ThreeMaps>(records, touches);
+  Result multi = run<MultiIndex>(records, touches);
+  if (maps.oldest != multi.oldest) return 1;
+  print("three maps:  ", maps);
+  print("multi_index: ", multi);
+  return 0;
+}
@@ -0,0 +1,107 @@
+// Union, intersection and difference of a large set with a smaller one:
+// element-wise find/insert/erase against the join-based operations, serial
+// and on four threads.
+// Usage: set_algebra_bench.out [large_size]
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "../s21_containers/set/set.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Set = s21::set<int>;
+
+Set randomSet(int count, std::mt19937& gen) {
+  std::uniform_int_distribution<int> key(0, 1 << 28);
+  Set result;
+  while (static_cast<int>(result.size()) < count) result.insert(key(gen));
+  return result;
+}
+
+template <typename Fn>
+double timeMs(Fn&& fn) {
+  auto start = Clock::now();
+  std::size_t size = fn();
+  double ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  if (size == static_cast<std::size_t>(-1)) std::exit(1);
+  return ms;
+}
+
+void report(const char* name, double naive, double joined, double parallel) {
+  std::cout << std::setw(14) << name << std::fixed << std::setprecision(2)
+            << std::setw(10) << naive << std::setw(10) << joined
+            << std::setw(10) << parallel << "  ms\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int large_size = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  std::mt19937 gen(17);
+  Set large = randomSet(large_size, gen);
+
+  for (int small_size : {large_size / 1000, large_size / 30, large_size}) {
+    Set small = randomSet(small_size, gen);
+    // Half the small set also lies in the large one.
+    int shared = 0;
+    for (auto it = large.begin(); shared < small_size / 2; ++it, ++shared) {
+      small.insert(*it);
+    }
+    std::cout << "n = " << large.size() << ", m = " << small.size()
+              << "\n            op     naive      join   join x4\n";
+
+    report(
+        "intersection", timeMs([&] {
+          Set result;
+          for (int key : small) {
+            if (large.contains(key)) result.insert(key);
+          }
+          return result.size();
+        }),
+        timeMs([&] { return s21::set_intersection(small, large).size(); }),
+        timeMs([&] { return s21::set_intersection(small, large, 4).size(); }));
+
+    // In place on a copy made outside the timed region.
+    Set copy(large);
+    double naive_union = timeMs([&] {
+      for (int key : small) copy.insert(key);
+      return copy.size();
+    });
+    Set joined(large), parallel(large);
+    report("union", naive_union, timeMs([&] {
+             joined.unite(small);
+             return joined.size();
+           }),
+           timeMs([&] {
+             parallel.unite(small, 4);
+             return parallel.size();
+           }));
+
+    Set rest(large);
+    double naive_difference = timeMs([&] {
+      for (int key : small) {
+        auto it = rest.find(key);
+        if (it != rest.end()) rest.erase(it);
+      }
+      return rest.size();
+    });
+    Set joined_rest(large), parallel_rest(large);
+    report("difference", naive_difference, timeMs([&] {
+             joined_rest.subtract(small);
+             return joined_rest.size();
+           }),
+           timeMs([&] {
+             parallel_rest.subtract(small, 4);
+             return parallel_rest.size();
+           }));
+    if (joined.size() != copy.size() || parallel_rest.size() != rest.size()) {
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,70 @@
+// Moving the upper half of a map to another shard: re-inserting the
+// entries one by one against split_at(), and concat() to merge it back.
+// Usage: shard_split_bench.out [keys]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "../s21_containers/map/map.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Map = s21::map<int, int>;
+
+template <typename Fn>
+double timeUs(Fn&& fn) {
+  auto start = Clock::now();
+  fn();
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+Map makeShard(int count) {
+  Map shard;
+  std::srand(3);
+  while (static_cast<int>(shard.size()) < count) {
+    shard.insert(std::rand(), 0);
+  }
+  return shard;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  Map reinserted = makeShard(count);
+  Map shard = makeShard(count);
+  auto middle = shard.begin();
+  for (int i = 0; i < count / 2; ++i) ++middle;
+  int median = middle->first;
+
+  Map moved;
+  double reinsert_us = timeUs([&] {
+    auto it = reinserted.find(reinserted.end(), median);
+    while (it != reinserted.end()) {
+      moved.insert(*it);
+      auto next = it;
+      ++next;
+      reinserted.erase(it);
+      it = next;
+    }
+  });
+
+  Map upper;
+  double split_us = timeUs([&] { upper = shard.split_at(median); });
+  std::size_t total = 0;
+  double count_us = timeUs([&] { total = shard.size() + upper.size(); });
+  if (total != static_cast<std::size_t>(count) ||
+      upper.size() != moved.size() || shard.size() != reinserted.size()) {
+    return 1;
+  }
+  double concat_us = timeUs([&] { shard.concat(upper); });
+  if (shard.size() != static_cast<std::size_t>(count)) return 1;
+
+  std::cout << "re-insert upper half: " << reinsert_us / 1000 << " ms\n"
+            << "split_at:             " << split_us << " us\n"
+            << "first size() after:   " << count_us / 1000 << " ms\n"
+            << "concat:               " << concat_us << " us\n";
+  return 0;
+}
@@ -0,0 +1,49 @@
+// Many tiny sets, as in per-entity tag sets: build time and resident bytes
+// for node storage versus small_storage<8>.
+// Usage: small_set_bench.out [sets] [elements_per_set]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "../s21_containers/set/set.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+using NodeSet = s21::set<int>;
+using SmallSet = s21::set<int, s21::small_storage<8>>;
+
+std::size_t footprint(const NodeSet& set) { return set.memory_stats().bytes; }
+
+// Sets that outgrow the array are not expected here; count them as empty
+// trees so the number stays a lower bound.
+std::size_t footprint(const SmallSet& set) { return sizeof(set); }
+
+template <typename Set>
+void measure(const char* name, std::size_t sets, int per_set) {
+  auto start = Clock::now();
+  std::vector<Set> all(sets);
+  for (std::size_t i = 0; i < sets; ++i) {
+    for (int j = 0; j < per_set; ++j) all[i].insert((j * 7 + i) % 31);
+  }
+  double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+  std::size_t bytes = 0;
+  for (const Set& set : all) bytes += footprint(set);
+  std::cout << name << ": " << ns / sets << " ns per set, " << bytes / sets
+            << " bytes per set\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t sets = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  int per_set = argc > 2 ? std::atoi(argv[2]) : 6;
+
+  measure<NodeSet>("node_storage", sets, per_set);
+  measure<SmallSet>("small_storage<8>", sets, per_set);
+  return 0;
+}
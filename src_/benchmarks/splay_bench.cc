@@ -0,0 +1,83 @@
+// Lookups drawn from a Zipf distribution over the keys: the splay policy
+// against the default red-black tree at increasing skew, and the skew at
+// which splaying starts to pay off.
+// Usage: splay_bench.out [keys]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../s21_containers/set/set.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Draws ranks 0..n-1 with probability proportional to 1 / (rank + 1)^skew.
+std::vector<int> zipfProbes(const std::vector<int>& keys, double skew,
+                            std::size_t count, std::mt19937& gen) {
+  std::vector<double> cdf(keys.size());
+  double total = 0;
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    total += 1 / std::pow(static_cast<double>(i + 1), skew);
+    cdf[i] = total;
+  }
+  std::uniform_real_distribution<double> uniform(0, total);
+  std::vector<int> probes(count);
+  for (auto& probe : probes) {
+    std::size_t rank =
+        std::lower_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin();
+    probe = keys[std::min(rank, keys.size() - 1)];
+  }
+  return probes;
+}
+
+template <typename Set>
+double lookupNs(Set& set, const std::vector<int>& probes) {
+  std::size_t found = 0;
+  auto start = Clock::now();
+  for (int probe : probes) found += set.contains(probe);
+  double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  if (found != probes.size()) std::exit(1);
+  return ns / probes.size();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::mt19937 gen(9);
+  std::vector<int> keys(count);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), gen);  // hot keys spread out
+
+  s21::set<int> balanced;
+  s21::set<int, s21::splay_storage> splay;
+  for (int key : keys) {
+    balanced.insert(key);
+    splay.insert(key);
+  }
+
+  double break_even = -1;
+  std::cout << "skew   red-black    splay\n";
+  for (double skew : {0.0, 0.6, 0.8, 0.9, 1.0, 1.1, 1.2, 1.5}) {
+    std::vector<int> probes = zipfProbes(keys, skew, 2 * count, gen);
+    double rb = lookupNs(balanced, probes);
+    double sp = lookupNs(splay, probes);
+    std::cout << std::fixed << std::setprecision(1) << std::setw(4) << skew
+              << std::setw(9) << rb << " ns" << std::setw(9) << sp << " ns\n";
+    if (break_even < 0 && sp < rb) break_even = skew;
+  }
+  if (break_even < 0) {
+    std::cout << "splay never faster in this range\n";
+  } else {
+    std::cout << "splay faster from skew " << break_even << "\n";
+  }
+  return 0;
+}
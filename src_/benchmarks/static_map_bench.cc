@@ -0,0 +1,125 @@
+// Lookups in a fixed 256-entry table: s21::map built at startup, its
+// frozen_map, and s21::static_map built at compile time with either the
+// branchless binary search or the perfect hash. Half the probes miss. A
+// second run repeats the two static_map lookups with string_view keys.
+// Usage: static_map_bench.out [probes]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../s21_containers/frozen_map/frozen_map.h"
+#include "../s21_containers/map/map.h"
+#include "../s21_containers/static_map/static_map.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kEntries = 256;
+
+// Distinct, sparse keys: 7919 and 100003 are coprime.
+constexpr int keyAt(std::size_t i) {
+  return static_cast<int>(i * 7919 % 100003);
+}
+
+template <s21::static_map_lookup Lookup, std::size_t... Is>
+constexpr auto makeTable(std::index_sequence<Is...>) {
+  const std::pair<int, int> items[] = {{keyAt(Is), static_cast<int>(Is)}...};
+  return s21::make_static_map<int, int, std::less<int>, Lookup>(items);
+}
+
+constexpr auto kSearched = makeTable<s21::static_map_lookup::binary_search>(
+    std::make_index_sequence<kEntries>());
+constexpr auto kHashed = makeTable<s21::static_map_lookup::perfect_hash>(
+    std::make_index_sequence<kEntries>());
+
+template <typename Table, typename Probe>
+double lookupNs(const Table& table, const std::vector<Probe>& probes,
+                std::size_t expected_hits) {
+  std::size_t hits = 0;
+  auto start = Clock::now();
+  for (int round = 0; round < 10; ++round) {
+    for (const Probe& probe : probes) hits += table.find(probe) != nullptr;
+  }
+  double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  if (hits != 10 * expected_hits) std::exit(1);
+  return ns / (10 * probes.size());
+}
+
+// s21::map::find returns an iterator; adapt it to the pointer interface.
+struct MapTable {
+  const int* find(int key) const {
+    auto it = map.find(map.end(), key);
+    return it == map.end() ? nullptr : &(*it).second;
+  }
+  s21::map<int, int> map;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  std::mt19937 gen(41);
+  std::vector<int> probes(count);
+  std::size_t hits = 0;
+  for (int& probe : probes) {
+    bool hit = gen() % 2;
+    probe = hit ? keyAt(gen() % kEntries)
+                : -1 - static_cast<int>(gen() % 100000);
+    hits += hit;
+  }
+
+  auto start = Clock::now();
+  MapTable map;
+  for (std::size_t i = 0; i < kEntries; ++i) {
+    map.map.insert(keyAt(i), static_cast<int>(i));
+  }
+  auto frozen = s21::freeze(map.map);
+  double startup_us =
+      std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+  std::cout << "map build + freeze at startup: " << startup_us << " us\n"
+            << "s21::map:                " << lookupNs(map, probes, hits)
+            << " ns/find\n"
+            << "frozen_map:              " << lookupNs(frozen, probes, hits)
+            << " ns/find\n"
+            << "static_map binary search: "
+            << lookupNs(kSearched, probes, hits) << " ns/find\n"
+            << "static_map perfect hash:  " << lookupNs(kHashed, probes, hits)
+            << " ns/find\n";
+
+  // Mnemonic-like names; the table is built at run time here, but the
+  // lookups are the same code.
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i < kEntries; ++i) {
+    names.push_back("op_" + std::to_string(keyAt(i)));
+  }
+  std::pair<std::string_view, int> items[kEntries];
+  for (std::size_t i = 0; i < kEntries; ++i) {
+    items[i] = {names[i], static_cast<int>(i)};
+  }
+  s21::static_map<std::string_view, int, kEntries, std::less<std::string_view>,
+                  s21::static_map_lookup::binary_search>
+      searched_names(items);
+  s21::static_map<std::string_view, int, kEntries, std::less<std::string_view>,
+                  s21::static_map_lookup::perfect_hash>
+      hashed_names(items);
+  std::vector<std::string> misses;
+  for (int i = 0; i < 1000; ++i) misses.push_back("op_x" + std::to_string(i));
+  std::vector<std::string_view> name_probes;
+  for (int probe : probes) {
+    name_probes.push_back(probe >= 0 ? std::string_view(names[probe % 256])
+                                     : std::string_view(misses[-probe % 1000]));
+  }
+  std::cout << "string keys, binary search: "
+            << lookupNs(searched_names, name_probes, hits) << " ns/find\n"
+            << "string keys, perfect hash:  "
+            << lookupNs(hashed_names, name_probes, hits) << " ns/find\n";
+  return 0;
+}
@@ -0,0 +1,60 @@
+// Lookups with long string keys that share a 64-byte prefix: the one-call
+// three-way path of std::less<std::string> against a plain two-call less.
+// Usage: three_way_bench.out [keys]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../s21_containers/tree/tree.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Same ordering as std::less<std::string>, but without the three-way trait.
+struct TwoCallLess {
+  bool operator()(const std::string& lhs, const std::string& rhs) const {
+    return lhs < rhs;
+  }
+};
+
+template <typename Compare>
+double lookupNs(const std::vector<std::string>& keys,
+                const std::vector<std::string>& probes) {
+  s21::RBTree<std::string, Compare> tree;
+  for (const auto& key : keys) tree.insert(key);
+
+  std::size_t found = 0;
+  auto start = Clock::now();
+  for (int round = 0; round < 5; ++round) {
+    for (const auto& probe : probes) found += tree.contains(probe);
+  }
+  double ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  if (found != 5 * probes.size()) std::exit(1);
+  return ns / (5 * probes.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+  const std::string prefix(64, 'k');
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < count; ++i) {
+    keys.push_back(prefix + std::to_string(i * 2654435761u % 1000000007u));
+  }
+  std::vector<std::string> probes = keys;
+  std::shuffle(probes.begin(), probes.end(), std::mt19937(3));
+
+  double three_way = lookupNs<std::less<std::string>>(keys, probes);
+  double two_call = lookupNs<TwoCallLess>(keys, probes);
+  std::cout << count << " keys of " << keys[0].size() << "+ bytes\n"
+            << "three-way compare: " << three_way << " ns/lookup\n"
+            << "two-call less:     " << two_call << " ns/lookup\n";
+  return 0;
+}
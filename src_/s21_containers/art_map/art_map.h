@@ -0,0 +1,66 @@
+#include <stdexcept>
+#include <utility>
+
+#include "../tree/art_tree.h"
+
+#ifndef art_map_h
+#define art_map_h
+
+namespace s21 {
+
+// Map on an adaptive radix tree: find, insert and erase cost O(key length)
+// however many keys there are, and keys iterate in order. Keys need an
+// art_key_traits specialization (std::string and integers have one).
+template <typename Key, typename T>
+class art_map : public ArtTree<Key, std::pair<const Key, T>, ArtPairFirst> {
+ public:
+  using MyBase = ArtTree<Key, std::pair<const Key, T>, ArtPairFirst>;
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = typename MyBase::iterator;
+  using const_iterator = typename MyBase::const_iterator;
+  using size_type = size_t;
+
+  using MyBase::MyBase;
+
+  T &at(const Key &key);
+  T &operator[](const Key &key);
+
+  using MyBase::insert;
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    return insert(value_type(key, obj));
+  }
+  std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj);
+};
+
+template <typename Key, typename T>
+T &art_map<Key, T>::at(const Key &key) {
+  iterator it = MyBase::find(key);
+  if (it == MyBase::end()) {
+    throw std::out_of_range("key not found");
+  }
+  return it->second;
+}
+
+template <typename Key, typename T>
+T &art_map<Key, T>::operator[](const Key &key) {
+  return insert(value_type(key, T())).first->second;
+}
+
+template <typename Key, typename T>
+std::pair<typename art_map<Key, T>::iterator, bool>
+art_map<Key, T>::insert_or_assign(const Key &key, const T &obj) {
+  iterator it = MyBase::find(key);
+  if (it != MyBase::end()) {
+    it->second = obj;
+    return std::make_pair(it, false);
+  }
+  return insert(value_type(key, obj));
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,26 @@
+#include "../tree/art_tree.h"
+
+#ifndef art_set_h
+#define art_set_h
+
+namespace s21 {
+
+// Set on an adaptive radix tree; see art_map.
+template <typename Key>
+class art_set : public ArtTree<Key, Key, ArtIdentity> {
+ public:
+  using MyBase = ArtTree<Key, Key, ArtIdentity>;
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = typename MyBase::iterator;
+  using const_iterator = typename MyBase::const_iterator;
+  using size_type = size_t;
+
+  using MyBase::MyBase;
+};
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,859 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "page_cache.h"
+
+#ifndef disk_map_h
+#define disk_map_h
+
+namespace s21 {
+
+// Ordered map stored as a B+tree in fixed-size pages of a file, so it can
+// hold more entries than fit in memory. Only cache_pages pages are resident
+// at a time. Entries live in the leaves, which are chained left to right for
+// iteration; inner pages hold separator keys and child page numbers.
+//
+// Keys and values are stored as raw bytes and must be trivially copyable.
+// Iterators yield entries by value, because the page they came from may be
+// evicted at any time; any insert or erase invalidates them. Erase folds a
+// page that drops below half full into a sibling when the two fit in one
+// page; freed pages go on a free list in the file and are reused before it
+// grows.
+//
+// Only flush() and the destructor leave a consistent file: in between,
+// evicted pages and the header are written in no particular order. The
+// first change after a flush marks the file unclean and syncs that mark to
+// disk, and opening an unclean file throws std::runtime_error instead of
+// reading a torn tree.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class disk_map {
+  static_assert(std::is_trivially_copyable<Key>::value &&
+                    std::is_trivially_copyable<T>::value,
+                "disk_map stores keys and values as raw bytes");
+
+ public:
+  class iterator;
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using size_type = std::size_t;
+  using const_iterator = iterator;
+  using page_id = PageCache::page_id;
+
+  struct cache_stats {
+    size_type hits;
+    size_type misses;
+    size_type evictions;
+  };
+
+  // Opens the map stored in path, creating the file when it does not exist.
+  // page_size only applies to a new file; an existing one keeps its own.
+  explicit disk_map(const std::string& path, size_type cache_pages = 1024,
+                    size_type page_size = 4096);
+  disk_map(const disk_map&) = delete;
+  disk_map& operator=(const disk_map&) = delete;
+  ~disk_map();
+
+  iterator begin() const;
+  iterator end() const { return iterator(this, 0, 0); }
+
+  bool empty() const { return meta_.size == 0; }
+  size_type size() const { return meta_.size; }
+  void clear();
+
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(const Key& key, const T& obj);
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj);
+  void erase(iterator pos) { erase((*pos).first); }
+  size_type erase(const Key& key);
+
+  T at(const Key& key) const;
+  iterator find(const Key& key) const;
+  iterator lower_bound(const Key& key) const;
+  bool contains(const Key& key) const { return find(key) != end(); }
+
+  // Writes every dirty page and the header page back to the file.
+  void flush();
+  cache_stats stats() const {
+    return {cache_.hits(), cache_.misses(), cache_.evictions()};
+  }
+
+ private:
+  // Page 0 of the file. Page number 0 doubles as the null link.
+  struct Meta {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t page_size;
+    std::uint32_t key_size;
+    std::uint32_t value_size;
+    std::uint32_t height;
+    std::uint64_t root;
+    std::uint64_t first_leaf;
+    std::uint64_t page_count;
+    std::uint64_t size;
+    std::uint64_t free_list;  // first free page, linked through next
+    std::uint32_t clean;      // 0 between the first change and flush()
+    std::uint32_t reserved;
+  };
+
+  // Leaf page:  PageHeader | keys[leaf_capacity_] | values[leaf_capacity_]
+  // Inner page: PageHeader | keys[inner_capacity_] | children[count + 1]
+  struct PageHeader {
+    std::uint16_t leaf;
+    std::uint16_t count;
+    std::uint32_t reserved;
+    page_id next;
+  };
+
+  static constexpr char kMagic[4] = {'S', '2', '1', 'D'};
+  static constexpr std::uint32_t kVersion = 2;
+  static constexpr size_type kMinCachePages = 8;
+
+  void openFile(const std::string& path, size_type page_size);
+  void writeMeta();
+  // fdatasync(), or fsync() where there is none.
+  void syncFile();
+  // Called before the first write to a page after a flush.
+  void markUnclean();
+  page_id allocatePage();
+  void freePage(page_id id);
+  page_id findLeaf(const Key& key, std::vector<page_id>* path) const;
+  void insertIntoParent(std::vector<page_id>& path, page_id left,
+                        Key separator, page_id right);
+  void splitLeaf(PinnedPage& leaf, size_type pos, const Key& key,
+                 const T& obj, page_id& at_leaf, size_type& at_slot,
+                 Key& separator, page_id& right_id);
+  void rebalance(std::vector<page_id>& path, page_id id);
+  bool mergePages(page_id left_id, const Key& separator, page_id right_id);
+  // Moves (leaf, slot) forward past the end of a leaf and past empty leaves.
+  void normalize(page_id& leaf, size_type& slot) const;
+  value_type entryAt(page_id leaf, size_type slot) const;
+
+  size_type lowerBound(const char* page, size_type count,
+                       const Key& key) const;
+  size_type upperBound(const char* page, size_type count,
+                       const Key& key) const;
+
+  static PageHeader header(const char* page) {
+    PageHeader result;
+    std::memcpy(&result, page, sizeof(result));
+    return result;
+  }
+  static void setHeader(char* page, const PageHeader& value) {
+    std::memcpy(page, &value, sizeof(value));
+  }
+  // Accessors copy through memcpy: slots are packed and may be unaligned.
+  static Key keyAt(const char* page, size_type i) {
+    Key result;
+    std::memcpy(&result, keySlot(page, i), sizeof(Key));
+    return result;
+  }
+  static void setKey(char* page, size_type i, const Key& key) {
+    std::memcpy(keySlot(page, i), &key, sizeof(Key));
+  }
+  T valueAt(const char* page, size_type i) const {
+    T result;
+    std::memcpy(&result, valueSlot(page, i), sizeof(T));
+    return result;
+  }
+  void setValue(char* page, size_type i, const T& obj) const {
+    std::memcpy(valueSlot(page, i), &obj, sizeof(T));
+  }
+  page_id childAt(const char* page, size_type i) const {
+    page_id result;
+    std::memcpy(&result, childSlot(page, i), sizeof(page_id));
+    return result;
+  }
+  void setChild(char* page, size_type i, page_id child) const {
+    std::memcpy(childSlot(page, i), &child, sizeof(page_id));
+  }
+
+  static char* keySlot(const char* page, size_type i) {
+    return const_cast<char*>(page) + sizeof(PageHeader) + i * sizeof(Key);
+  }
+  char* valueSlot(const char* page, size_type i) const {
+    return keySlot(page, leaf_capacity_) + i * sizeof(T);
+  }
+  char* childSlot(const char* page, size_type i) const {
+    return keySlot(page, inner_capacity_) + i * sizeof(page_id);
+  }
+
+  int fd_ = -1;
+  Meta meta_ = {};
+  size_type leaf_capacity_ = 0;
+  size_type inner_capacity_ = 0;
+  mutable PageCache cache_;
+  Compare comparator_;
+};
+
+template <typename Key, typename T, typename Compare>
+class disk_map<Key, T, Compare>::iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename disk_map::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = value_type;
+
+  // Keeps the copied entry alive for the duration of it->member.
+  class arrow_proxy {
+   public:
+    const value_type* operator->() const { return &value_; }
+
+   private:
+    friend class iterator;
+    explicit arrow_proxy(value_type value) : value_(std::move(value)) {}
+    value_type value_;
+  };
+
+  iterator() = default;
+
+  value_type operator*() const { return map_->entryAt(leaf_, slot_); }
+  arrow_proxy operator->() const { return arrow_proxy(**this); }
+
+  iterator& operator++() {
+    ++slot_;
+    map_->normalize(leaf_, slot_);
+    return *this;
+  }
+  iterator operator++(int) {
+    iterator old = *this;
+    ++*this;
+    return old;
+  }
+
+  bool operator==(const iterator& other) const {
+    return leaf_ == other.leaf_ && slot_ == other.slot_;
+  }
+  bool operator!=(const iterator& other) const { return !(*this == other); }
+
+ private:
+  friend class disk_map;
+  iterator(const disk_map* map, page_id leaf, size_type slot)
+      : map_(map), leaf_(leaf), slot_(slot) {}
+
+  const disk_map* map_ = nullptr;
+  page_id leaf_ = 0;
+  size_type slot_ = 0;
+};
+
+template <typename Key, typename T, typename Compare>
+disk_map<Key, T, Compare>::disk_map(const std::string& path,
+                                    size_type cache_pages, size_type page_size)
+    : cache_(cache_pages) {
+  if (cache_pages < kMinCachePages) {
+    throw std::invalid_argument("disk_map: cache too small");
+  }
+  openFile(path, page_size);
+  cache_.attach(fd_, meta_.page_size);
+}
+
+template <typename Key, typename T, typename Compare>
+disk_map<Key, T, Compare>::~disk_map() {
+  try {
+    flush();
+  } catch (...) {
+  }
+  ::close(fd_);
+}
+
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::openFile(const std::string& path,
+                                         size_type page_size) {
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    throw std::runtime_error("disk_map: cannot open " + path);
+  }
+  struct stat info;
+  if (::fstat(fd_, &info) != 0) {
+    ::close(fd_);
+    throw std::runtime_error("disk_map: cannot stat " + path);
+  }
+
+  if (info.st_size == 0) {
+    std::memcpy(meta_.magic, kMagic, sizeof(meta_.magic));
+    meta_.version = kVersion;
+    meta_.page_size = static_cast<std::uint32_t>(page_size);
+    meta_.key_size = sizeof(Key);
+    meta_.value_size = sizeof(T);
+    meta_.page_count = 1;
+    meta_.clean = 1;
+  } else if (::pread(fd_, &meta_, sizeof(meta_), 0) !=
+                 static_cast<ssize_t>(sizeof(meta_)) ||
+             std::memcmp(meta_.magic, kMagic, sizeof(kMagic)) != 0 ||
+             meta_.version != kVersion) {
+    ::close(fd_);
+    throw std::runtime_error("disk_map: bad header in " + path);
+  } else if (meta_.key_size != sizeof(Key) ||
+             meta_.value_size != sizeof(T)) {
+    ::close(fd_);
+    throw std::runtime_error("disk_map: key or value size mismatch");
+  } else if (!meta_.clean) {
+    ::close(fd_);
+    throw std::runtime_error("disk_map: " + path + " was not flushed");
+  }
+
+  size_type usable = meta_.page_size > sizeof(PageHeader) + sizeof(page_id)
+                         ? meta_.page_size - sizeof(PageHeader)
+                         : 0;
+  leaf_capacity_ = usable / (sizeof(Key) + sizeof(T));
+  inner_capacity_ =
+      usable ? (usable - sizeof(page_id)) / (sizeof(Key) + sizeof(page_id))
+             : 0;
+  if (meta_.page_size < sizeof(Meta) || meta_.page_size > 65536 ||
+      leaf_capacity_ < 3 || inner_capacity_ < 3) {
+    ::close(fd_);
+    throw std::invalid_argument("disk_map: page size too small");
+  }
+}
+
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::writeMeta() {
+  if (::pwrite(fd_, &meta_, sizeof(meta_), 0) !=
+      static_cast<ssize_t>(sizeof(meta_))) {
+    throw std::runtime_error("disk_map: cannot write header");
+  }
+}
+
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::syncFile() {
+#if defined(__APPLE__)
+  int result = ::fsync(fd_);
+#else
+  int result = ::fdatasync(fd_);
+#endif
+  if (result != 0) {
+    throw std::runtime_error("disk_map: cannot sync file");
+  }
+}
+
+// Synced before returning, so no page written after it can reach the disk
+// while the header still says clean.
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::markUnclean() {
+  if (meta_.clean) {
+    meta_.clean = 0;
+    writeMeta();
+    syncFile();
+  }
+}
+
+// The pages are synced before the header that marks them clean, and the
+// header before flush() returns.
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::flush() {
+  cache_.flush();
+  syncFile();
+  meta_.clean = 1;
+  writeMeta();
+  syncFile();
+}
+
+template <typename Key, typename T, typename Compare>
+typename disk_map<Key, T, Compare>::page_id
+disk_map<Key, T, Compare>::allocatePage() {
+  if (meta_.free_list == 0) {
+    return meta_.page_count++;
+  }
+  page_id id = meta_.free_list;
+  PinnedPage page(cache_, id);
+  meta_.free_list = header(page.data()).next;
+  return id;
+}
+
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::freePage(page_id id) {
+  PinnedPage page(cache_, id, true);
+  setHeader(page.data(), PageHeader{0, 0, 0, meta_.free_list});
+  meta_.free_list = id;
+}
+
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::clear() {
+  // Until the empty header is synced, a crash leaves an unclean file
+  // rather than a clean header over truncated pages.
+  markUnclean();
+  cache_.discard();
+  meta_.root = meta_.first_leaf = 0;
+  meta_.height = 0;
+  meta_.size = 0;
+  meta_.page_count = 1;
+  meta_.free_list = 0;
+  meta_.clean = 1;
+  if (::ftruncate(fd_, meta_.page_size) != 0) {
+    throw std::runtime_error("disk_map: cannot truncate file");
+  }
+  writeMeta();
+  syncFile();
+}
+
+template <typename Key, typename T, typename Compare>
+typename disk_map<Key, T, Compare>::size_type
+disk_map<Key, T, Compare>::lowerBound(const char* page, size_type count,
+                                      const Key& key) const {
+  size_type low = 0;
+  size_type high = count;
+  while (low < high) {
+    size_type middle = low + (high - low) / 2;
+    if (comparator_(keyAt(page, middle), key)) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+template <typename Key, typename T, typename Compare>
+typename disk_map<Key, T, Compare>::size_type
+disk_map<Key, T, Compare>::upperBound(const char* page, size_type count,
+                                      const Key& key) const {
+  size_type low = 0;
+  size_type high = count;
+  while (low < high) {
+    size_type middle = low + (high - low) / 2;
+    if (comparator_(key, keyAt(page, middle))) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return low;
+}
+
+// Descends from the root; a key equal to a separator goes right. When path
+// is given, it receives the inner pages on the way down.
+template <typename Key, typename T, typename Compare>
+typename disk_map<Key, T, Compare>::page_id
+disk_map<Key, T, Compare>::findLeaf(const Key& key,
+                                    std::vector<page_id>* path) const {
+  page_id id = meta_.root;
+  while (true) {
+    PinnedPage page(cache_, id);
+    PageHeader info = header(page.data());
+    if (info.leaf) {
+      return id;
+    }
+    if (path) {
+      path->push_back(id);
+    }
+    id = childAt(page.data(), upperBound(page.data(), info.count, key));
+  }
+}
+
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::normalize(page_id& leaf,
+                                          size_type& slot) const {
+  while (leaf != 0) {
+    PinnedPage page(cache_, leaf);
+    PageHeader info = header(page.data());
+    if (slot < info.count) {
+      return;
+    }
+    leaf = info.next;
+    slot = 0;
+  }
+  slot = 0;
+}
+
+template <typename Key, typename T, typename Compare>
+typename disk_map<Key, T, Compare>::value_type
+disk_map<Key, T, Compare>::entryAt(page_id leaf, size_type slot) const {
+  PinnedPage page(cache_, leaf);
+  return {keyAt(page.data(), slot), valueAt(page.data(), slot)};
+}
+
+template <typename Key, typename T, typename Compare>
+typename disk_map<Key, T, Compare>::iterator
+disk_map<Key, T, Compare>::begin() const {
+  page_id leaf = meta_.first_leaf;
+  size_type slot = 0;
+  normalize(leaf, slot);
+  return iterator(this, leaf, slot);
+}
+
+template <typename Key, typename T, typename Compare>
+typename disk_map<Key, T, Compare>::iterator
+disk_map<Key, T, Compare>::lower_bound(const Key& key) const {
+  if (meta_.root == 0) {
+    return end();
+  }
+  page_id leaf = findLeaf(key, nullptr);
+  size_type slot;
+  {
+    PinnedPage page(cache_, leaf);
+    slot = lowerBound(page.data(), header(page.data()).count, key);
+  }
+  normalize(leaf, slot);
+  return iterator(this, leaf, slot);
+}
+
+template <typename Key, typename T, typename Compare>
+typename disk_map<Key, T, Compare>::iterator disk_map<Key, T, Compare>::find(
+    const Key& key) const {
+  if (meta_.root == 0) {
+    return end();
+  }
+  page_id leaf = findLeaf(key, nullptr);
+  PinnedPage page(cache_, leaf);
+  size_type count = header(page.data()).count;
+  size_type slot = lowerBound(page.data(), count, key);
+  if (slot < count && !comparator_(key, keyAt(page.data(), slot))) {
+    return iterator(this, leaf, slot);
+  }
+  return end();
+}
+
+template <typename Key, typename T, typename Compare>
+T disk_map<Key, T, Compare>::at(const Key& key) const {
+  iterator found = find(key);
+  if (found == end()) {
+    throw std::out_of_range("disk_map::at: key not found");
+  }
+  return (*found).second;
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename disk_map<Key, T, Compare>::iterator, bool>
+disk_map<Key, T, Compare>::insert(const value_type& value) {
+  return insert(value.first, value.second);
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename disk_map<Key, T, Compare>::iterator, bool>
+disk_map<Key, T, Compare>::insert(const Key& key, const T& obj) {
+  if (meta_.root == 0) {
+    markUnclean();
+    page_id id = allocatePage();
+    PinnedPage page(cache_, id, true);
+    setHeader(page.data(), PageHeader{1, 0, 0, 0});
+    meta_.root = meta_.first_leaf = id;
+    meta_.height = 1;
+  }
+
+  std::vector<page_id> path;
+  page_id leaf_id = findLeaf(key, &path);
+  page_id at_leaf = leaf_id;
+  size_type at_slot;
+  Key separator;
+  page_id right_id;
+  {
+    PinnedPage leaf(cache_, leaf_id);
+    PageHeader info = header(leaf.data());
+    size_type pos = lowerBound(leaf.data(), info.count, key);
+    if (pos < info.count && !comparator_(key, keyAt(leaf.data(), pos))) {
+      return {iterator(this, leaf_id, pos), false};
+    }
+
+    markUnclean();
+    leaf.markDirty();
+    if (info.count < leaf_capacity_) {
+      size_type tail = info.count - pos;
+      std::memmove(keySlot(leaf.data(), pos + 1), keySlot(leaf.data(), pos),
+                   tail * sizeof(Key));
+      std::memmove(valueSlot(leaf.data(), pos + 1),
+                   valueSlot(leaf.data(), pos), tail * sizeof(T));
+      setKey(leaf.data(), pos, key);
+      setValue(leaf.data(), pos, obj);
+      ++info.count;
+      setHeader(leaf.data(), info);
+      ++meta_.size;
+      return {iterator(this, leaf_id, pos), true};
+    }
+    splitLeaf(leaf, pos, key, obj, at_leaf, at_slot, separator, right_id);
+  }
+  insertIntoParent(path, leaf_id, separator, right_id);
+  ++meta_.size;
+  return {iterator(this, at_leaf, at_slot), true};
+}
+
+// Spreads a full leaf plus the new entry over the leaf and a new right
+// sibling; reports where the entry landed and the separator to push up.
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::splitLeaf(PinnedPage& leaf, size_type pos,
+                                          const Key& key, const T& obj,
+                                          page_id& at_leaf, size_type& at_slot,
+                                          Key& separator, page_id& right_id) {
+  PageHeader info = header(leaf.data());
+  std::vector<Key> keys;
+  std::vector<T> values;
+  keys.reserve(info.count + 1);
+  values.reserve(info.count + 1);
+  for (size_type i = 0; i < info.count; ++i) {
+    if (i == pos) {
+      keys.push_back(key);
+      values.push_back(obj);
+    }
+    keys.push_back(keyAt(leaf.data(), i));
+    values.push_back(valueAt(leaf.data(), i));
+  }
+  if (pos == info.count) {
+    keys.push_back(key);
+    values.push_back(obj);
+  }
+
+  right_id = allocatePage();
+  PinnedPage right(cache_, right_id, true);
+  size_type left_count = keys.size() / 2;
+  size_type right_count = keys.size() - left_count;
+  for (size_type i = 0; i < right_count; ++i) {
+    setKey(right.data(), i, keys[left_count + i]);
+    setValue(right.data(), i, values[left_count + i]);
+  }
+  for (size_type i = 0; i < left_count; ++i) {
+    setKey(leaf.data(), i, keys[i]);
+    setValue(leaf.data(), i, values[i]);
+  }
+  setHeader(right.data(),
+            PageHeader{1, static_cast<std::uint16_t>(right_count), 0,
+                       info.next});
+  setHeader(leaf.data(), PageHeader{1, static_cast<std::uint16_t>(left_count),
+                                    0, right_id});
+
+  if (pos < left_count) {
+    at_slot = pos;
+  } else {
+    at_leaf = right_id;
+    at_slot = pos - left_count;
+  }
+  separator = keys[left_count];
+}
+
+// Adds (separator, right) next to left in the parent taken from path,
+// splitting inner pages upwards and growing a new root when needed.
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::insertIntoParent(std::vector<page_id>& path,
+                                                 page_id left, Key separator,
+                                                 page_id right) {
+  while (true) {
+    if (path.empty()) {
+      page_id id = allocatePage();
+      PinnedPage root(cache_, id, true);
+      setHeader(root.data(), PageHeader{0, 1, 0, 0});
+      setKey(root.data(), 0, separator);
+      setChild(root.data(), 0, left);
+      setChild(root.data(), 1, right);
+      meta_.root = id;
+      ++meta_.height;
+      return;
+    }
+
+    page_id parent_id = path.back();
+    path.pop_back();
+    PinnedPage parent(cache_, parent_id);
+    parent.markDirty();
+    PageHeader info = header(parent.data());
+    size_type pos = upperBound(parent.data(), info.count, separator);
+
+    if (info.count < inner_capacity_) {
+      size_type tail = info.count - pos;
+      std::memmove(keySlot(parent.data(), pos + 1),
+                   keySlot(parent.data(), pos), tail * sizeof(Key));
+      std::memmove(childSlot(parent.data(), pos + 2),
+                   childSlot(parent.data(), pos + 1),
+                   tail * sizeof(page_id));
+      setKey(parent.data(), pos, separator);
+      setChild(parent.data(), pos + 1, right);
+      ++info.count;
+      setHeader(parent.data(), info);
+      return;
+    }
+
+    std::vector<Key> keys;
+    std::vector<page_id> children;
+    for (size_type i = 0; i < info.count; ++i) {
+      keys.push_back(keyAt(parent.data(), i));
+    }
+    for (size_type i = 0; i <= info.count; ++i) {
+      children.push_back(childAt(parent.data(), i));
+    }
+    keys.insert(keys.begin() + pos, separator);
+    children.insert(children.begin() + pos + 1, right);
+
+    // The middle key moves up; it stays in neither half.
+    size_type middle = keys.size() / 2;
+    page_id sibling_id = allocatePage();
+    PinnedPage sibling(cache_, sibling_id, true);
+    size_type sibling_count = keys.size() - middle - 1;
+    for (size_type i = 0; i < sibling_count; ++i) {
+      setKey(sibling.data(), i, keys[middle + 1 + i]);
+    }
+    for (size_type i = 0; i <= sibling_count; ++i) {
+      setChild(sibling.data(), i, children[middle + 1 + i]);
+    }
+    for (size_type i = 0; i < middle; ++i) {
+      setKey(parent.data(), i, keys[i]);
+    }
+    for (size_type i = 0; i <= middle; ++i) {
+      setChild(parent.data(), i, children[i]);
+    }
+    setHeader(sibling.data(),
+              PageHeader{0, static_cast<std::uint16_t>(sibling_count), 0, 0});
+    setHeader(parent.data(),
+              PageHeader{0, static_cast<std::uint16_t>(middle), 0, 0});
+
+    left = parent_id;
+    separator = keys[middle];
+    right = sibling_id;
+  }
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename disk_map<Key, T, Compare>::iterator, bool>
+disk_map<Key, T, Compare>::insert_or_assign(const Key& key, const T& obj) {
+  std::pair<iterator, bool> result = insert(key, obj);
+  if (!result.second) {
+    markUnclean();
+    PinnedPage page(cache_, result.first.leaf_);
+    setValue(page.data(), result.first.slot_, obj);
+    page.markDirty();
+  }
+  return result;
+}
+
+template <typename Key, typename T, typename Compare>
+typename disk_map<Key, T, Compare>::size_type disk_map<Key, T, Compare>::erase(
+    const Key& key) {
+  if (meta_.root == 0) {
+    return 0;
+  }
+  std::vector<page_id> path;
+  page_id leaf_id = findLeaf(key, &path);
+  {
+    PinnedPage leaf(cache_, leaf_id);
+    PageHeader info = header(leaf.data());
+    size_type pos = lowerBound(leaf.data(), info.count, key);
+    if (pos == info.count || comparator_(key, keyAt(leaf.data(), pos))) {
+      return 0;
+    }
+
+    markUnclean();
+    size_type tail = info.count - pos - 1;
+    std::memmove(keySlot(leaf.data(), pos), keySlot(leaf.data(), pos + 1),
+                 tail * sizeof(Key));
+    std::memmove(valueSlot(leaf.data(), pos),
+                 valueSlot(leaf.data(), pos + 1), tail * sizeof(T));
+    --info.count;
+    setHeader(leaf.data(), info);
+    leaf.markDirty();
+  }
+  --meta_.size;
+  rebalance(path, leaf_id);
+  return 1;
+}
+
+// Walks up from a page that lost an entry: while it is under half full,
+// folds it and a sibling into the left one of the pair and drops their
+// separator from the parent, which may then be underfull in turn. A root
+// left with no keys gives way to its only child, an empty root leaf to an
+// empty tree. path holds the inner pages above id.
+template <typename Key, typename T, typename Compare>
+void disk_map<Key, T, Compare>::rebalance(std::vector<page_id>& path,
+                                          page_id id) {
+  while (!path.empty()) {
+    {
+      PinnedPage page(cache_, id);
+      PageHeader info = header(page.data());
+      size_type capacity = info.leaf ? leaf_capacity_ : inner_capacity_;
+      if (info.count >= capacity / 2) {
+        return;
+      }
+    }
+
+    page_id parent_id = path.back();
+    path.pop_back();
+    PinnedPage parent(cache_, parent_id);
+    PageHeader info = header(parent.data());
+    if (info.count == 0) {
+      return;
+    }
+    size_type index = 0;
+    while (childAt(parent.data(), index) != id) {
+      ++index;
+    }
+    size_type left = index == info.count ? index - 1 : index;
+    if (!mergePages(childAt(parent.data(), left), keyAt(parent.data(), left),
+                    childAt(parent.data(), left + 1))) {
+      return;
+    }
+
+    freePage(childAt(parent.data(), left + 1));
+    size_type tail = info.count - left - 1;
+    std::memmove(keySlot(parent.data(), left),
+                 keySlot(parent.data(), left + 1), tail * sizeof(Key));
+    std::memmove(childSlot(parent.data(), left + 1),
+                 childSlot(parent.data(), left + 2), tail * sizeof(page_id));
+    --info.count;
+    setHeader(parent.data(), info);
+    parent.markDirty();
+    id = parent_id;
+  }
+
+  PinnedPage root(cache_, id);
+  PageHeader info = header(root.data());
+  if (info.count > 0) {
+    return;
+  }
+  if (info.leaf) {
+    meta_.root = meta_.first_leaf = 0;
+    meta_.height = 0;
+  } else {
+    meta_.root = childAt(root.data(), 0);
+    --meta_.height;
+  }
+  freePage(id);
+}
+
+// Moves everything in right_id onto the end of left_id if it fits there;
+// inner pages also take the parent's separator between them.
+template <typename Key, typename T, typename Compare>
+bool disk_map<Key, T, Compare>::mergePages(page_id left_id,
+                                           const Key& separator,
+                                           page_id right_id) {
+  PinnedPage left(cache_, left_id);
+  PinnedPage right(cache_, right_id);
+  PageHeader left_info = header(left.data());
+  PageHeader right_info = header(right.data());
+  size_type count = left_info.count;
+
+  if (left_info.leaf) {
+    if (count + right_info.count > leaf_capacity_) {
+      return false;
+    }
+    std::memcpy(keySlot(left.data(), count), keySlot(right.data(), 0),
+                right_info.count * sizeof(Key));
+    std::memcpy(valueSlot(left.data(), count), valueSlot(right.data(), 0),
+                right_info.count * sizeof(T));
+    left_info.next = right_info.next;
+  } else {
+    if (count + 1 + right_info.count > inner_capacity_) {
+      return false;
+    }
+    setKey(left.data(), count, separator);
+    std::memcpy(keySlot(left.data(), count + 1), keySlot(right.data(), 0),
+                right_info.count * sizeof(Key));
+    std::memcpy(childSlot(left.data(), count + 1),
+                childSlot(right.data(), 0),
+                (right_info.count + 1) * sizeof(page_id));
+    ++count;
+  }
+  left_info.count = static_cast<std::uint16_t>(count + right_info.count);
+  setHeader(left.data(), left_info);
+  left.markDirty();
+  return true;
+}
+
+}  // namespace s21
+
+#endif
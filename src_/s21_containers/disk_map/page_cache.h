@@ -0,0 +1,207 @@
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifndef page_cache_h
+#define page_cache_h
+
+namespace s21 {
+
+// Fixed pool of page frames over a file descriptor, evicted with the CLOCK
+// algorithm. Pages are read with pread on a miss and written back with pwrite
+// when a dirty frame is evicted or on flush(). A pinned frame is never
+// evicted; callers pin through PinnedPage.
+class PageCache {
+ public:
+  using page_id = std::uint64_t;
+
+  explicit PageCache(std::size_t capacity) : frames_(capacity) {}
+
+  PageCache(const PageCache&) = delete;
+  PageCache& operator=(const PageCache&) = delete;
+
+  // Binds the cache to a file; must be called before the first pin().
+  void attach(int fd, std::size_t page_size) {
+    fd_ = fd;
+    page_size_ = page_size;
+    memory_.assign(page_size * frames_.size(), 0);
+  }
+  // Returns the frame holding the page; a fresh page is zero-filled instead
+  // of being read from the file.
+  char* pin(page_id id, bool fresh = false);
+  void unpin(page_id id, bool dirty);
+  void flush();
+  // Forgets every frame without writing anything back.
+  void discard();
+
+  std::size_t pageSize() const { return page_size_; }
+  std::size_t hits() const { return hits_; }
+  std::size_t misses() const { return misses_; }
+  std::size_t evictions() const { return evictions_; }
+
+ private:
+  struct Frame {
+    page_id id = 0;
+    bool used = false;
+    bool dirty = false;
+    bool referenced = false;
+    unsigned pins = 0;
+  };
+
+  char* frameData(std::size_t frame) {
+    return memory_.data() + frame * page_size_;
+  }
+  std::size_t claimFrame();
+  void readFrame(std::size_t frame, page_id id);
+  void writeFrame(std::size_t frame);
+
+  int fd_ = -1;
+  std::size_t page_size_ = 0;
+  std::vector<char> memory_;
+  std::vector<Frame> frames_;
+  std::unordered_map<page_id, std::size_t> index_;
+  std::size_t hand_ = 0;
+  std::size_t hits_ = 0;
+  std::size_t misses_ = 0;
+  std::size_t evictions_ = 0;
+};
+
+inline char* PageCache::pin(page_id id, bool fresh) {
+  std::size_t frame;
+  auto found = index_.find(id);
+  if (found != index_.end()) {
+    ++hits_;
+    frame = found->second;
+  } else {
+    ++misses_;
+    frame = claimFrame();
+    // The frame stays free until the page is in it and indexed, so a
+    // failed read leaves nothing behind.
+    if (fresh) {
+      std::memset(frameData(frame), 0, page_size_);
+    } else {
+      readFrame(frame, id);
+    }
+    index_[id] = frame;
+    frames_[frame] = Frame{id, true, false, false, 0};
+  }
+
+  Frame& entry = frames_[frame];
+  ++entry.pins;
+  entry.referenced = true;
+  return frameData(frame);
+}
+
+inline void PageCache::unpin(page_id id, bool dirty) {
+  Frame& entry = frames_[index_.at(id)];
+  entry.dirty = entry.dirty || dirty;
+  --entry.pins;
+}
+
+inline void PageCache::flush() {
+  for (std::size_t frame = 0; frame < frames_.size(); ++frame) {
+    if (frames_[frame].used && frames_[frame].dirty) {
+      writeFrame(frame);
+    }
+  }
+}
+
+inline void PageCache::discard() {
+  for (auto& entry : frames_) entry = Frame();
+  index_.clear();
+  hand_ = 0;
+}
+
+// Sweeps the clock hand: a referenced frame gets a second chance, the first
+// unreferenced and unpinned one is written back if dirty and reused.
+inline std::size_t PageCache::claimFrame() {
+  for (std::size_t scanned = 0; scanned <= 2 * frames_.size(); ++scanned) {
+    std::size_t frame = hand_;
+    hand_ = (hand_ + 1) % frames_.size();
+    Frame& entry = frames_[frame];
+    if (!entry.used) {
+      return frame;
+    }
+    if (entry.pins) {
+      continue;
+    }
+    if (entry.referenced) {
+      entry.referenced = false;
+      continue;
+    }
+    if (entry.dirty) {
+      writeFrame(frame);
+    }
+    index_.erase(entry.id);
+    entry.used = false;
+    ++evictions_;
+    return frame;
+  }
+  throw std::runtime_error("page cache: every frame is pinned");
+}
+
+inline void PageCache::readFrame(std::size_t frame, page_id id) {
+  char* data = frameData(frame);
+  off_t offset = static_cast<off_t>(id * page_size_);
+  std::size_t done = 0;
+  while (done < page_size_) {
+    ssize_t got = ::pread(fd_, data + done, page_size_ - done, offset + done);
+    if (got < 0 && errno == EINTR) continue;
+    if (got < 0) {
+      throw std::runtime_error("page cache: read failed");
+    }
+    if (got == 0) {
+      // Past the end of the file: the page was never written.
+      std::memset(data + done, 0, page_size_ - done);
+      break;
+    }
+    done += static_cast<std::size_t>(got);
+  }
+}
+
+inline void PageCache::writeFrame(std::size_t frame) {
+  const char* data = frameData(frame);
+  off_t offset = static_cast<off_t>(frames_[frame].id * page_size_);
+  std::size_t done = 0;
+  while (done < page_size_) {
+    ssize_t put = ::pwrite(fd_, data + done, page_size_ - done, offset + done);
+    if (put < 0 && errno == EINTR) continue;
+    if (put <= 0) {
+      throw std::runtime_error("page cache: write failed");
+    }
+    done += static_cast<std::size_t>(put);
+  }
+  frames_[frame].dirty = false;
+}
+
+// Keeps one page pinned for the lifetime of the object.
+class PinnedPage {
+ public:
+  PinnedPage(PageCache& cache, PageCache::page_id id, bool fresh = false)
+      : cache_(&cache), id_(id), data_(cache.pin(id, fresh)), dirty_(fresh) {}
+
+  PinnedPage(const PinnedPage&) = delete;
+  PinnedPage& operator=(const PinnedPage&) = delete;
+
+  ~PinnedPage() { cache_->unpin(id_, dirty_); }
+
+  char* data() { return data_; }
+  const char* data() const { return data_; }
+  PageCache::page_id id() const { return id_; }
+  void markDirty() { dirty_ = true; }
+
+ private:
+  PageCache* cache_;
+  PageCache::page_id id_;
+  char* data_;
+  bool dirty_;
+};
+
+}  // namespace s21
+
+#endif
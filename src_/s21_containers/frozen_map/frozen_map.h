@@ -0,0 +1,100 @@
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../tree/eytzinger.h"
+
+#ifndef frozen_map_h
+#define frozen_map_h
+
+namespace s21 {
+
+template <typename Key, typename T, typename Storage>
+class map;
+
+// Immutable map produced by freeze(map). Keys are searched in Eytzinger
+// order and values sit in a parallel array; both key and value must be
+// trivially copyable so the whole table can live in a mapped file.
+template <typename Key, typename T>
+class frozen_map : public EytzingerTable<Key> {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "frozen_map stores values as raw bytes");
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using size_type = std::size_t;
+
+  frozen_map() = default;
+  // [first, last) must yield pairs with strictly ascending keys.
+  template <typename InputIt>
+  frozen_map(InputIt first, InputIt last);
+
+  const T& at(const Key& key) const;
+  const T* find(const Key& key) const;
+
+  void save(const std::string& path) const;
+  static frozen_map open(const std::string& path);
+
+ private:
+  using Table = EytzingerTable<Key>;
+
+  const T* values() const {
+    return reinterpret_cast<const T*>(Table::valuesBase());
+  }
+};
+
+template <typename Key, typename T>
+template <typename InputIt>
+frozen_map<Key, T>::frozen_map(InputIt first, InputIt last) {
+  std::vector<Key> keys;
+  std::vector<T> values;
+  for (; first != last; ++first) {
+    keys.push_back(first->first);
+    values.push_back(first->second);
+  }
+  Table::build(keys.data(), reinterpret_cast<const char*>(values.data()),
+               sizeof(T), keys.size());
+}
+
+template <typename Key, typename T>
+const T* frozen_map<Key, T>::find(const Key& key) const {
+  size_type slot = Table::findSlot(key);
+  return slot ? values() + slot : nullptr;
+}
+
+template <typename Key, typename T>
+const T& frozen_map<Key, T>::at(const Key& key) const {
+  const T* value = find(key);
+  if (!value) {
+    throw std::out_of_range("key not found");
+  }
+  return *value;
+}
+
+template <typename Key, typename T>
+void frozen_map<Key, T>::save(const std::string& path) const {
+  Table::saveImage(path);
+}
+
+// Maps a file written by save(); lookups read straight from the mapping.
+template <typename Key, typename T>
+frozen_map<Key, T> frozen_map<Key, T>::open(const std::string& path) {
+  frozen_map result;
+  std::size_t image_size = 0;
+  auto image = Table::mapFile(path, image_size);
+  result.adopt(std::move(image), image_size, sizeof(T));
+  return result;
+}
+
+// Lives here rather than in map.h, so that maps do not pull in the POSIX
+// headers the file loader needs.
+template <typename Key, typename T, typename Storage>
+frozen_map<Key, T> freeze(const map<Key, T, Storage>& source) {
+  return frozen_map<Key, T>(source.begin(), source.end());
+}
+
+}  // namespace s21
+
+#endif
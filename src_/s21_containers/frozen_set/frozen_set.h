@@ -0,0 +1,63 @@
+#include <string>
+#include <vector>
+
+#include "../tree/eytzinger.h"
+
+#ifndef frozen_set_h
+#define frozen_set_h
+
+namespace s21 {
+
+template <typename Key, typename Storage>
+class set;
+
+// Immutable set produced by freeze(set); see frozen_map for the layout.
+template <typename Key>
+class frozen_set : public EytzingerTable<Key> {
+ public:
+  using key_type = Key;
+  using size_type = std::size_t;
+
+  frozen_set() = default;
+  // [first, last) must be strictly ascending.
+  template <typename InputIt>
+  frozen_set(InputIt first, InputIt last);
+
+  void save(const std::string& path) const;
+  static frozen_set open(const std::string& path);
+
+ private:
+  using Table = EytzingerTable<Key>;
+};
+
+template <typename Key>
+template <typename InputIt>
+frozen_set<Key>::frozen_set(InputIt first, InputIt last) {
+  std::vector<Key> keys(first, last);
+  Table::build(keys.data(), nullptr, 0, keys.size());
+}
+
+template <typename Key>
+void frozen_set<Key>::save(const std::string& path) const {
+  Table::saveImage(path);
+}
+
+template <typename Key>
+frozen_set<Key> frozen_set<Key>::open(const std::string& path) {
+  frozen_set result;
+  std::size_t image_size = 0;
+  auto image = Table::mapFile(path, image_size);
+  result.adopt(std::move(image), image_size, 0);
+  return result;
+}
+
+// Lives here rather than in set.h, so that sets do not pull in the POSIX
+// headers the file loader needs.
+template <typename Key, typename Storage>
+frozen_set<Key> freeze(const set<Key, Storage>& source) {
+  return frozen_set<Key>(source.begin(), source.end());
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,311 @@
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "../tree/rb_algorithms.h"
+#include "../tree/three_way.h"
+
+#ifndef intrusive_set_h
+#define intrusive_set_h
+
+namespace s21 {
+
+// Embedded in an object to link it into one intrusive_set. An object with
+// several hooks can be in several sets at once, each keyed on its own hook.
+// Copying the object does not copy its membership.
+class intrusive_set_hook {
+ public:
+  intrusive_set_hook() = default;
+  intrusive_set_hook(const intrusive_set_hook &) {}
+  intrusive_set_hook &operator=(const intrusive_set_hook &) { return *this; }
+
+  bool is_linked() const { return linked_; }
+
+ private:
+  friend struct intrusive_hook_traits;
+
+  intrusive_set_hook *parent_ = nullptr;
+  intrusive_set_hook *left_ = nullptr;
+  intrusive_set_hook *right_ = nullptr;
+  bool red_ = false;
+  bool linked_ = false;
+};
+
+// rb_algorithms node traits over the hooks themselves.
+struct intrusive_hook_traits {
+  using node_ptr = intrusive_set_hook *;
+
+  static node_ptr parent(node_ptr node) { return node->parent_; }
+  static node_ptr left(node_ptr node) { return node->left_; }
+  static node_ptr right(node_ptr node) { return node->right_; }
+  static void setParent(node_ptr node, node_ptr parent) {
+    node->parent_ = parent;
+  }
+  static void setLeft(node_ptr node, node_ptr left) { node->left_ = left; }
+  static void setRight(node_ptr node, node_ptr right) {
+    node->right_ = right;
+  }
+  static bool isRed(node_ptr node) { return node->red_; }
+  static void setRed(node_ptr node, bool red) { node->red_ = red; }
+  static void copyBalance(node_ptr to, node_ptr from) { to->red_ = from->red_; }
+
+  static void setLinked(node_ptr node, bool linked) {
+    node->linked_ = linked;
+    if (!linked) {
+      node->parent_ = node->left_ = node->right_ = nullptr;
+      node->red_ = false;
+    }
+  }
+};
+
+// A red-black tree of objects the caller owns, linked through the hook
+// member Hook. Insert and erase never allocate, and searches compare the
+// objects directly instead of following a pointer per element. The set
+// never copies or destroys an object; an object must stay alive and keep
+// its key unchanged while it is linked.
+//
+// find(), contains() and lower_bound() accept any key Compare can order
+// against T, so a comparator with (Key, T) overloads searches by bare key.
+//
+// Iterators to objects stay valid until the object is erased, also across
+// a move or swap of the set. end() refers to the set object itself, so
+// as with std::set a move or swap invalidates it.
+template <typename T, intrusive_set_hook T::*Hook,
+          typename Compare = std::less<T>>
+class intrusive_set {
+  using Traits = intrusive_hook_traits;
+  using Algorithms = rb_algorithms<Traits>;
+  using node_ptr = intrusive_set_hook *;
+
+ public:
+  class iterator;
+
+  using value_type = T;
+  using reference = T &;
+  using const_iterator = iterator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  intrusive_set() = default;
+  explicit intrusive_set(const Compare &comparator)
+      : comparator_(comparator) {}
+  intrusive_set(const intrusive_set &) = delete;
+  intrusive_set &operator=(const intrusive_set &) = delete;
+  intrusive_set(intrusive_set &&other) { swap(other); }
+  intrusive_set &operator=(intrusive_set &&other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+  // Unlinks every object; none is destroyed.
+  ~intrusive_set() { clear(); }
+
+  iterator begin() const {
+    return iterator(Algorithms::minimum(root_), this);
+  }
+  iterator end() const { return iterator(nullptr, this); }
+
+  bool empty() const { return root_ == nullptr; }
+  size_type size() const { return size_; }
+
+  // Links object in unless an equal one is already there. Linking an object
+  // that is already in a set throws std::invalid_argument.
+  std::pair<iterator, bool> insert(T &object);
+  // Unlinks the object at pos and returns the next position.
+  iterator erase(iterator pos);
+  // object must be linked into this set.
+  void erase(T &object) { erase(iterator_to(object)); }
+  void clear();
+  void swap(intrusive_set &other);
+
+  template <typename K>
+  iterator find(const K &key) const;
+  template <typename K>
+  bool contains(const K &key) const {
+    return find(key) != end();
+  }
+  template <typename K>
+  iterator lower_bound(const K &key) const;
+  iterator iterator_to(T &object) const {
+    return iterator(&(object.*Hook), this);
+  }
+
+ private:
+  // Distance from the start of a T to its hook. A pointer to member gives
+  // no offset without an object, so insert() measures it on the object it
+  // links and stores it with the set.
+  static std::ptrdiff_t hookOffset(T &object) {
+    return reinterpret_cast<unsigned char *>(&(object.*Hook)) -
+           reinterpret_cast<unsigned char *>(&object);
+  }
+  static T &objectAt(node_ptr node, std::ptrdiff_t offset) {
+    return *reinterpret_cast<T *>(reinterpret_cast<unsigned char *>(node) -
+                                  offset);
+  }
+  T &objectOf(node_ptr node) const { return objectAt(node, hook_offset_); }
+
+  node_ptr root_ = nullptr;
+  size_type size_ = 0;
+  std::ptrdiff_t hook_offset_ = 0;
+  Compare comparator_ = Compare();
+};
+
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+class intrusive_set<T, Hook, Compare>::iterator {
+  friend intrusive_set;
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+
+  iterator() = default;
+
+  reference operator*() const { return objectAt(current_, hook_offset_); }
+  pointer operator->() const { return &objectAt(current_, hook_offset_); }
+
+  iterator &operator++() {
+    current_ = Algorithms::next(current_);
+    return *this;
+  }
+  iterator operator++(int) {
+    iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  iterator &operator--() {
+    current_ = current_ ? Algorithms::prev(current_)
+                        : Algorithms::maximum(set_->root_);
+    return *this;
+  }
+  iterator operator--(int) {
+    iterator tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const iterator &other) const {
+    return current_ == other.current_;
+  }
+  bool operator!=(const iterator &other) const {
+    return current_ != other.current_;
+  }
+
+ private:
+  iterator(node_ptr node, const intrusive_set *set)
+      : current_(node), set_(set), hook_offset_(set->hook_offset_) {}
+
+  node_ptr current_ = nullptr;
+  const intrusive_set *set_ = nullptr;  // for --end()
+  std::ptrdiff_t hook_offset_ = 0;
+};
+
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+std::pair<typename intrusive_set<T, Hook, Compare>::iterator, bool>
+intrusive_set<T, Hook, Compare>::insert(T &object) {
+  node_ptr node = &(object.*Hook);
+  if (node->is_linked()) {
+    throw std::invalid_argument("intrusive_set: object is already linked");
+  }
+  hook_offset_ = hookOffset(object);
+  node_ptr parent = nullptr;
+  bool as_left = false;
+  for (node_ptr current = root_; current;) {
+    int order = compareKeys(comparator_, object, objectOf(current));
+    if (order == 0) {
+      return {iterator(current, this), false};
+    }
+    parent = current;
+    as_left = order < 0;
+    current = as_left ? Traits::left(current) : Traits::right(current);
+  }
+
+  Algorithms::link(root_, node, parent, as_left);
+  Traits::setLinked(node, true);
+  Traits::setRed(node, true);
+  Algorithms::fixInsertion(root_, node);
+  ++size_;
+  return {iterator(node, this), true};
+}
+
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+typename intrusive_set<T, Hook, Compare>::iterator
+intrusive_set<T, Hook, Compare>::erase(iterator pos) {
+  node_ptr node = pos.current_;
+  iterator next(Algorithms::next(node), this);
+  auto [x, x_parent, removed_red] = Algorithms::unlink(root_, node);
+  if (!removed_red) {
+    Algorithms::deleteFixup(root_, x, x_parent);
+  }
+  Traits::setLinked(node, false);
+  --size_;
+  return next;
+}
+
+// Flattens the tree with right rotations while unlinking, as parent links
+// of nodes already reset cannot be followed.
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+void intrusive_set<T, Hook, Compare>::clear() {
+  node_ptr node = root_;
+  while (node) {
+    if (node_ptr left = Traits::left(node)) {
+      Traits::setLeft(node, Traits::right(left));
+      Traits::setRight(left, node);
+      node = left;
+    } else {
+      node_ptr right = Traits::right(node);
+      Traits::setLinked(node, false);
+      node = right;
+    }
+  }
+  root_ = nullptr;
+  size_ = 0;
+}
+
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+void intrusive_set<T, Hook, Compare>::swap(intrusive_set &other) {
+  std::swap(root_, other.root_);
+  std::swap(size_, other.size_);
+  std::swap(hook_offset_, other.hook_offset_);
+  std::swap(comparator_, other.comparator_);
+}
+
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+template <typename K>
+typename intrusive_set<T, Hook, Compare>::iterator
+intrusive_set<T, Hook, Compare>::find(const K &key) const {
+  node_ptr current = root_;
+  while (current) {
+    int order = compareKeys(comparator_, key, objectOf(current));
+    if (order == 0) break;
+    current = order < 0 ? Traits::left(current) : Traits::right(current);
+  }
+  return iterator(current, this);
+}
+
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+template <typename K>
+typename intrusive_set<T, Hook, Compare>::iterator
+intrusive_set<T, Hook, Compare>::lower_bound(const K &key) const {
+  node_ptr current = root_;
+  node_ptr result = nullptr;
+  while (current) {
+    if (comparator_(objectOf(current), key)) {
+      current = Traits::right(current);
+    } else {
+      result = current;
+      current = Traits::left(current);
+    }
+  }
+  return iterator(result, this);
+}
+
+}  // namespace s21
+
+#endif
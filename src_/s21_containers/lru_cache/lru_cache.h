@@ -0,0 +1,284 @@
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#include "../tree/tree.h"
+
+#ifndef lru_cache_h
+#define lru_cache_h
+
+namespace s21 {
+
+// Heap bytes an entry owns outside its node, for byte-bounded caches. The
+// default charges nothing beyond the node itself; a cache of strings would
+// return their capacity.
+struct lru_no_extra_bytes {
+  template <typename Key, typename T>
+  std::size_t operator()(const Key &, const T &) const {
+    return 0;
+  }
+};
+
+// Least-recently-used cache over a red-black tree. The recency list and the
+// write-order list are threaded through the tree nodes themselves, so an
+// entry is a single allocation. Touching and evicting are O(1) on top of the
+// O(log n) lookup.
+//
+// Capacity is bounded by entry count, by bytes (node size plus whatever
+// Weigher reports), or both. With a non-zero ttl an entry expires ttl after
+// it was last written; since the ttl is shared, write order is expiry order
+// and expire() only visits the entries it removes.
+template <typename Key, typename T, typename Weigher = lru_no_extra_bytes,
+          typename Clock = std::chrono::steady_clock>
+class lru_cache {
+  struct Entry;
+
+  struct EntryLess {
+    bool operator()(const Entry &lhs, const Entry &rhs) const {
+      return lhs.key < rhs.key;
+    }
+    bool operator()(const Key &lhs, const Entry &rhs) const {
+      return lhs < rhs.key;
+    }
+    bool operator()(const Entry &lhs, const Key &rhs) const {
+      return lhs.key < rhs;
+    }
+  };
+
+  using Base = RBTree<Entry, EntryLess>;
+  using Node = typename Base::Node;
+
+  struct Entry {
+    Key key;
+    T value;
+    std::size_t bytes = 0;
+    typename Clock::time_point expires{};
+    Node *newer = nullptr;  // recency list
+    Node *older = nullptr;
+    Node *next_written = nullptr;  // write-order list
+    Node *prev_written = nullptr;
+  };
+
+  // Opens the heterogeneous lookup and node access of the tree core.
+  struct Tree : Base {
+    using Base::findKey;
+    using Base::lowerBoundKey;
+    using Base::nodeOf;
+  };
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using size_type = std::size_t;
+  using duration = typename Clock::duration;
+
+  static constexpr size_type kUnlimited = std::numeric_limits<size_type>::max();
+
+  explicit lru_cache(size_type max_entries, size_type max_bytes = kUnlimited,
+                     duration ttl = duration::zero())
+      : max_entries_(max_entries), max_bytes_(max_bytes), ttl_(ttl) {}
+
+  lru_cache(const lru_cache &) = delete;
+  lru_cache &operator=(const lru_cache &) = delete;
+
+  // Returns the cached value and makes it the most recent, or nullptr on a
+  // miss; an expired entry is dropped and counts as a miss.
+  T *get(const Key &key);
+  // Looks without touching recency or the counters.
+  const T *peek(const Key &key) const;
+  bool contains(const Key &key) const { return peek(key) != nullptr; }
+
+  // Inserts or overwrites, makes the entry the most recent, restarts its
+  // ttl and evicts least recent entries while over capacity. An entry that
+  // alone exceeds max_bytes is evicted straight away.
+  void put(const Key &key, const T &value) { store(key, value); }
+  void put(const Key &key, T &&value) { store(key, std::move(value)); }
+  bool erase(const Key &key);
+  // Drops every expired entry, oldest write first; returns how many.
+  size_type expire();
+  void clear();
+
+  bool empty() const { return tree_.empty(); }
+  size_type size() const { return tree_.size(); }
+  size_type bytes() const { return bytes_; }
+
+  size_type hits() const { return hits_; }
+  size_type misses() const { return misses_; }
+  size_type evictions() const { return evictions_; }
+  size_type expirations() const { return expirations_; }
+
+ private:
+  bool expired(const Node *node, typename Clock::time_point now) const {
+    return ttl_ != duration::zero() && node->data.expires <= now;
+  }
+  void touch(Node *node);
+  void linkNewest(Node *node);
+  void unlinkRecency(Node *node);
+  void linkWritten(Node *node);
+  void unlinkWritten(Node *node);
+  void remove(Node *node);
+  template <typename V>
+  void store(const Key &key, V &&value);
+
+  Tree tree_;
+  Weigher weigher_;
+  size_type max_entries_;
+  size_type max_bytes_;
+  duration ttl_;
+  size_type bytes_ = 0;
+  Node *newest_ = nullptr;
+  Node *oldest_ = nullptr;
+  Node *first_written_ = nullptr;
+  Node *last_written_ = nullptr;
+  size_type hits_ = 0;
+  size_type misses_ = 0;
+  size_type evictions_ = 0;
+  size_type expirations_ = 0;
+};
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+T *lru_cache<Key, T, Weigher, Clock>::get(const Key &key) {
+  auto it = tree_.findKey(key);
+  if (it == tree_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  Node *node = Tree::nodeOf(it);
+  if (expired(node, Clock::now())) {
+    remove(node);
+    ++expirations_;
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  touch(node);
+  return &node->data.value;
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+const T *lru_cache<Key, T, Weigher, Clock>::peek(const Key &key) const {
+  auto it = tree_.findKey(key);
+  if (it == tree_.end() || expired(Tree::nodeOf(it), Clock::now())) {
+    return nullptr;
+  }
+  return &it->value;
+}
+
+// One descent: an existing key is overwritten in place, and for a new one
+// the lower bound is the insert hint, so no Entry is built on a hit and
+// value is copied or moved exactly once either way.
+template <typename Key, typename T, typename Weigher, typename Clock>
+template <typename V>
+void lru_cache<Key, T, Weigher, Clock>::store(const Key &key, V &&value) {
+  size_type entry_bytes = sizeof(Node) + weigher_(key, value);
+  auto it = tree_.lowerBoundKey(key);
+  Node *node = nullptr;
+  if (it != tree_.end() && !(key < it->key)) {
+    node = Tree::nodeOf(it);
+    bytes_ -= node->data.bytes;
+    node->data.value = std::forward<V>(value);
+    node->data.bytes = entry_bytes;
+    touch(node);
+    unlinkWritten(node);
+  } else {
+    it = tree_.insert(it, Entry{key, std::forward<V>(value), entry_bytes});
+    node = Tree::nodeOf(it);
+    linkNewest(node);
+  }
+  bytes_ += entry_bytes;
+  if (ttl_ != duration::zero()) node->data.expires = Clock::now() + ttl_;
+  linkWritten(node);
+
+  while (oldest_ && (tree_.size() > max_entries_ || bytes_ > max_bytes_)) {
+    remove(oldest_);
+    ++evictions_;
+  }
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+bool lru_cache<Key, T, Weigher, Clock>::erase(const Key &key) {
+  auto it = tree_.findKey(key);
+  if (it == tree_.end()) return false;
+  remove(Tree::nodeOf(it));
+  return true;
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+typename lru_cache<Key, T, Weigher, Clock>::size_type
+lru_cache<Key, T, Weigher, Clock>::expire() {
+  size_type removed = 0;
+  auto now = Clock::now();
+  while (first_written_ && expired(first_written_, now)) {
+    remove(first_written_);
+    ++removed;
+  }
+  expirations_ += removed;
+  return removed;
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+void lru_cache<Key, T, Weigher, Clock>::clear() {
+  tree_.clear();
+  bytes_ = 0;
+  newest_ = oldest_ = first_written_ = last_written_ = nullptr;
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+void lru_cache<Key, T, Weigher, Clock>::touch(Node *node) {
+  if (node == newest_) return;
+  unlinkRecency(node);
+  linkNewest(node);
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+void lru_cache<Key, T, Weigher, Clock>::linkNewest(Node *node) {
+  node->data.newer = nullptr;
+  node->data.older = newest_;
+  if (newest_) {
+    newest_->data.newer = node;
+  } else {
+    oldest_ = node;
+  }
+  newest_ = node;
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+void lru_cache<Key, T, Weigher, Clock>::unlinkRecency(Node *node) {
+  Entry &entry = node->data;
+  (entry.newer ? entry.newer->data.older : newest_) = entry.older;
+  (entry.older ? entry.older->data.newer : oldest_) = entry.newer;
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+void lru_cache<Key, T, Weigher, Clock>::linkWritten(Node *node) {
+  node->data.next_written = nullptr;
+  node->data.prev_written = last_written_;
+  if (last_written_) {
+    last_written_->data.next_written = node;
+  } else {
+    first_written_ = node;
+  }
+  last_written_ = node;
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+void lru_cache<Key, T, Weigher, Clock>::unlinkWritten(Node *node) {
+  Entry &entry = node->data;
+  (entry.next_written ? entry.next_written->data.prev_written
+                      : last_written_) = entry.prev_written;
+  (entry.prev_written ? entry.prev_written->data.next_written
+                      : first_written_) = entry.next_written;
+}
+
+template <typename Key, typename T, typename Weigher, typename Clock>
+void lru_cache<Key, T, Weigher, Clock>::remove(Node *node) {
+  unlinkRecency(node);
+  unlinkWritten(node);
+  bytes_ -= node->data.bytes;
+  tree_.erase(typename Tree::iterator(node));
+}
+
+}  // namespace s21
+
+#endif
@@ -1,6 +1,8 @@
 #include <iostream>
+#include <vector>
 
-#include "../tree/tree.h"
+#include "../tree/parallel.h"
+#include "../tree/storage.h"
 
 namespace s21 {
 
@@ -9,12 +11,95 @@ struct PairFirstComparator {
   bool operator()(const PairType &lhs, const PairType &rhs) const {
     return lhs.first < rhs.first;
   }
+
+  // Bare-key overloads for lookups that have no value_type at hand.
+  template <typename Key, typename T>
+  bool operator()(const Key &lhs, const std::pair<const Key, T> &rhs) const {
+    return lhs < rhs.first;
+  }
+
+  template <typename Key, typename T>
+  bool operator()(const std::pair<const Key, T> &lhs, const Key &rhs) const {
+    return lhs.first < rhs;
+  }
+};
+
+// PairFirstComparator that names its key type, so the traits below can be
+// specialized on the comparator alone.
+template <typename Key>
+struct PairKeyComparator : PairFirstComparator {};
+
+// Map searches compare keys only, so they take the one-call path whenever
+// std::less<Key> does.
+template <typename Key>
+struct three_way_traits<PairKeyComparator<Key>>
+    : three_way_traits<std::less<Key>> {
+  template <typename A, typename B>
+  static int compare(const PairKeyComparator<Key> &, const A &lhs,
+                     const B &rhs) {
+    return three_way_traits<std::less<Key>>::compare(
+        std::less<Key>(), keyOf(lhs), keyOf(rhs));
+  }
+
+ private:
+  static const Key &keyOf(const Key &key) { return key; }
+  template <typename PairType>
+  static const Key &keyOf(const PairType &pair) {
+    return pair.first;
+  }
+};
+
+// PairFirstComparator learns the key type from its arguments.
+template <>
+struct three_way_traits<PairFirstComparator> : std::true_type {
+  template <typename Key, typename T>
+  static int compare(const PairFirstComparator &, const Key &lhs,
+                     const std::pair<const Key, T> &rhs) {
+    return compareKeys(PairKeyComparator<Key>(), lhs, rhs);
+  }
+  template <typename Key, typename T>
+  static int compare(const PairFirstComparator &,
+                     const std::pair<const Key, T> &lhs, const Key &rhs) {
+    return compareKeys(PairKeyComparator<Key>(), lhs, rhs);
+  }
+  template <typename Key, typename T>
+  static int compare(const PairFirstComparator &,
+                     const std::pair<const Key, T> &lhs,
+                     const std::pair<const Key, T> &rhs) {
+    return compareKeys(PairKeyComparator<Key>(), lhs, rhs);
+  }
+  template <typename A, typename B>
+  static int compare(const PairFirstComparator &comparator, const A &lhs,
+                     const B &rhs) {
+    return comparator(lhs, rhs) ? -1 : (comparator(rhs, lhs) ? 1 : 0);
+  }
+};
+
+// Likewise the cached key prefix: map nodes cache the prefix of their key.
+template <typename Key>
+struct key_prefix_traits<
+    PairKeyComparator<Key>,
+    std::enable_if_t<key_prefix_traits<std::less<Key>>::value>>
+    : std::true_type {
+  static key_prefix_type prefix(const Key &key) {
+    return key_prefix_traits<std::less<Key>>::prefix(key);
+  }
+  template <typename PairType>
+  static key_prefix_type prefix(const PairType &pair) {
+    return key_prefix_traits<std::less<Key>>::prefix(pair.first);
+  }
 };
 
 template <typename Key, typename T>
-class map : public RBTree<std::pair<const Key, T>, PairFirstComparator> {
+struct tree_key_prefix_traits<PairFirstComparator, std::pair<const Key, T>>
+    : key_prefix_traits<PairKeyComparator<Key>> {};
+
+template <typename Key, typename T, typename Storage = node_storage>
+class map : public Storage::template tree<std::pair<const Key, T>,
+                                          PairFirstComparator> {
  public:
-  using MyBase = RBTree<std::pair<const Key, T>, PairFirstComparator>;
+  using MyBase = typename Storage::template tree<std::pair<const Key, T>,
+                                                 PairFirstComparator>;
   using key_type = Key;
   using mapped_type = T;
   using value_type = std::pair<const key_type, mapped_type>;
@@ -24,79 +109,112 @@ class map : public RBTree<std::pair<const Key, T>, PairFirstComparator> {
   using const_iterator = typename MyBase::const_iterator;
   using size_type = size_t;
   using Node = typename MyBase::Node;
+  // Seeks by Key from the last position; see RBTree::Cursor.
+  using cursor = typename cursor_traits<MyBase, Key>::type;
 
-  using MyBase::RBTree;
+  using MyBase::MyBase;
 
   T &at(const Key &key);
   T &operator[](const Key &key);
 
   bool contains(const Key &key);
+  iterator find(iterator hint, const Key &key);
+  iterator find(iterator hint, const Key &key) const;
 
   using MyBase::insert;
   std::pair<iterator, bool> insert(const Key &key, const T &obj);
   std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj);
 
+  template <typename InputIt>
+  static map from_unsorted(InputIt first, InputIt last,
+                           unsigned threads = defaultThreadCount());
+
+  map split_at(const Key &key);
+  void concat(map &other);
+
  private:
   using MyBase::find;  // delete
 };
 
-template <typename Key, typename T>
-T &map<Key, T>::at(const Key &key) {
-  Node *current = MyBase::root_;
-  while (current) {
-    if (key == current->data.first) {
-      return current->data.second;
-    } else if (key < current->data.first) {
-      current = current->left;
-    } else {
-      current = current->right;
-    }
+template <typename Key, typename T, typename Storage>
+T &map<Key, T, Storage>::at(const Key &key) {
+  iterator it = MyBase::findKey(key);
+  if (it == MyBase::end()) {
+    throw std::out_of_range("key not found");
   }
-  throw std::out_of_range("key not found");
+  return (*it).second;
 }
 
-template <typename Key, typename T>
-T &map<Key, T>::operator[](const Key &key) {
+template <typename Key, typename T, typename Storage>
+T &map<Key, T, Storage>::operator[](const Key &key) {
   return (*((insert(std::make_pair(key, T()))).first)).second;  // old version
 }
 
-template <typename Key, typename T>
-std::pair<typename map<Key, T>::iterator, bool> map<Key, T>::insert(
+template <typename Key, typename T, typename Storage>
+std::pair<typename map<Key, T, Storage>::iterator, bool>
+map<Key, T, Storage>::insert(
     const Key &key, const T &obj) {
   return insert(std::make_pair(key, obj));
 }
 
-template <typename Key, typename T>
-std::pair<typename map<Key, T>::iterator, bool> map<Key, T>::insert_or_assign(
-    const Key &key, const T &obj) {
-  Node *current = MyBase::root_;
-  while (current) {
-    if (key == current->data.first) {
-      current->data.second = obj;
-      return std::make_pair(iterator(current), false);
-    } else if (key < current->data.first) {
-      current = current->left;
-    } else {
-      current = current->right;
-    }
+template <typename Key, typename T, typename Storage>
+std::pair<typename map<Key, T, Storage>::iterator, bool>
+map<Key, T, Storage>::insert_or_assign(const Key &key, const T &obj) {
+  iterator it = MyBase::findKey(key);
+  if (it != MyBase::end()) {
+    (*it).second = obj;
+    return std::make_pair(it, false);
   }
   return insert(std::make_pair(key, obj));
 }
 
-template <typename Key, typename T>
-bool map<Key, T>::contains(const Key &key) {
-  Node *current = MyBase::root_;
-
-  while (current) {
-    if (key < current->data.first) {
-      current = current->left;
-    } else if (current->data.first < key) {
-      current = current->right;
-    } else {
-      return true;
-    }
-  }
-  return false;
+// Same as set::from_unsorted; for duplicate keys the first pair wins, as it
+// would with repeated insert().
+template <typename Key, typename T, typename Storage>
+template <typename InputIt>
+map<Key, T, Storage> map<Key, T, Storage>::from_unsorted(InputIt first,
+                                                         InputIt last,
+                                                         unsigned threads) {
+  map result;
+  std::vector<std::pair<Key, T>> items(first, last);
+  parallelSortUnique(items, result.comparator_, threads);
+  result.buildFromSorted(items.begin(), items.end(), threads);
+  return result;
+}
+
+// Finger search from hint; hint may be any iterator of this map.
+template <typename Key, typename T, typename Storage>
+typename map<Key, T, Storage>::iterator map<Key, T, Storage>::find(
+    iterator hint, const Key &key) {
+  return MyBase::findNear(hint, key);
+}
+
+template <typename Key, typename T, typename Storage>
+typename map<Key, T, Storage>::iterator map<Key, T, Storage>::find(
+    iterator hint, const Key &key) const {
+  return MyBase::findNear(hint, key);
+}
+
+// Cuts the tree at key in O(log n): the returned map holds every key not
+// less than key, this one keeps the rest. Neither knows its size yet, so
+// the first size() on each afterwards counts it in O(n).
+template <typename Key, typename T, typename Storage>
+map<Key, T, Storage> map<Key, T, Storage>::split_at(const Key &key) {
+  map upper;
+  MyBase::split_at(key, upper);
+  return upper;
+}
+
+// The inverse of split_at(): moves all of other, whose keys must all be
+// greater than this map's, to the end of this one in O(log n).
+template <typename Key, typename T, typename Storage>
+void map<Key, T, Storage>::concat(map &other) {
+  MyBase::concat(other);
+}
+
+template <typename Key, typename T, typename Storage>
+bool map<Key, T, Storage>::contains(const Key &key) {
+  return MyBase::findKey(key) != MyBase::end();
 }
 
 }  // namespace s21
\ No newline at end of file
@@ -0,0 +1,590 @@
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../intrusive_set/intrusive_set.h"
+#include "../tree/rb_algorithms.h"
+#include "../tree/three_way.h"
+
+#ifndef multi_index_h
+#define multi_index_h
+
+namespace s21 {
+
+// Key extractors for multi_index orderings.
+template <auto Member>
+struct member_key {
+  template <typename T>
+  const auto &operator()(const T &value) const {
+    return value.*Member;
+  }
+};
+
+struct identity_key {
+  template <typename T>
+  const T &operator()(const T &value) const {
+    return value;
+  }
+};
+
+// Index specifications: order elements by KeyFn(value) under Compare. Both
+// are default-constructed on use, so they must be stateless.
+template <typename KeyFn, typename Compare = std::less<>>
+struct ordered_unique {
+  using key_from_value = KeyFn;
+  using compare = Compare;
+  static constexpr bool unique = true;
+};
+
+template <typename KeyFn, typename Compare = std::less<>>
+struct ordered_non_unique {
+  using key_from_value = KeyFn;
+  using compare = Compare;
+  static constexpr bool unique = false;
+};
+
+// One set of elements under several orderings. Each element is allocated
+// once and carries a red-black hook per index, so insert, erase, modify and
+// replace update every index in one operation and an element costs one
+// node however many orderings it is in.
+//
+// Elements are read through const iterators; change them with modify() or
+// replace(), which move the element within each index whose order it broke.
+// An insert that would duplicate a key of any unique index changes nothing.
+//
+//   multi_index<Job, ordered_unique<member_key<&Job::id>>,
+//               ordered_non_unique<member_key<&Job::deadline>>> jobs;
+//   auto by_deadline = jobs.get<1>();
+//   for (auto it = by_deadline.begin(); it != by_deadline.end(); ++it) ...
+template <typename T, typename... Indices>
+class multi_index {
+  static_assert(sizeof...(Indices) > 0, "multi_index needs an index");
+
+  static constexpr std::size_t kIndices = sizeof...(Indices);
+
+  using Traits = intrusive_hook_traits;
+  using Algorithms = rb_algorithms<Traits>;
+  using node_ptr = intrusive_set_hook *;
+
+  template <std::size_t I>
+  using IndexAt = std::tuple_element_t<I, std::tuple<Indices...>>;
+
+  // The hooks come first in a base of their own, so a hook of index I finds
+  // its node by stepping back I hooks and casting down.
+  struct Links {
+    intrusive_set_hook hooks[kIndices];
+  };
+  struct Node : Links {
+    template <typename... Args>
+    explicit Node(Args &&...args) : value(std::forward<Args>(args)...) {}
+
+    T value;
+  };
+
+  // Where a descent would link a new element.
+  struct Slot {
+    node_ptr parent = nullptr;
+    bool as_left = false;
+  };
+
+ public:
+  template <std::size_t I>
+  class iterator;
+  template <std::size_t I>
+  class index_view;
+
+  using value_type = T;
+  using size_type = std::size_t;
+
+  multi_index() = default;
+  multi_index(std::initializer_list<value_type> const &items);
+  multi_index(const multi_index &other);
+  multi_index(multi_index &&other) { swap(other); }
+  multi_index &operator=(const multi_index &other);
+  multi_index &operator=(multi_index &&other);
+  ~multi_index() { clear(); }
+
+  // Lookups and iteration in the order of index I.
+  template <std::size_t I>
+  index_view<I> get() const {
+    return index_view<I>(this);
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+
+  // On a clash with a unique index, returns the element that holds the key
+  // (as seen by index 0) and false.
+  std::pair<iterator<0>, bool> insert(const value_type &value) {
+    return insertValue(value);
+  }
+  std::pair<iterator<0>, bool> insert(value_type &&value) {
+    return insertValue(std::move(value));
+  }
+  template <typename... Args>
+  std::pair<iterator<0>, bool> emplace(Args &&...args);
+
+  // Removes the element from every index; returns the next position in
+  // index I.
+  template <std::size_t I>
+  iterator<I> erase(iterator<I> pos);
+  // Removes every element whose key in index I equals key.
+  template <std::size_t I, typename K>
+  size_type erase(const K &key);
+  void clear();
+  void swap(multi_index &other);
+
+  // Calls fn on the element in place, then repositions it in the indices
+  // whose order changed. If the new keys clash with a unique index, or fn
+  // throws, the element is erased; modify returns whether it survived.
+  template <std::size_t I, typename Fn>
+  bool modify(iterator<I> pos, Fn fn);
+  // Overwrites the element unless value would clash with another element in
+  // a unique index; on a clash nothing changes and false is returned. If
+  // copying value throws nothing changes; if assigning it throws, the
+  // element is erased.
+  template <std::size_t I>
+  bool replace(iterator<I> pos, const value_type &value);
+
+  // The same element seen from index J.
+  template <std::size_t J, std::size_t I>
+  iterator<J> project(iterator<I> pos) const {
+    if (!pos.current_) return iterator<J>(nullptr, this);
+    return iterator<J>(&nodeOf<I>(pos.current_)->hooks[J], this);
+  }
+
+ private:
+  template <std::size_t I>
+  static Node *nodeOf(node_ptr hook) {
+    return static_cast<Node *>(reinterpret_cast<Links *>(hook - I));
+  }
+
+  template <std::size_t I, typename K>
+  static decltype(auto) keyOf(const K &value) {
+    return typename IndexAt<I>::key_from_value()(value);
+  }
+  template <std::size_t I>
+  static int compareValues(const T &lhs, const T &rhs) {
+    return compareKeys(typename IndexAt<I>::compare(), keyOf<I>(lhs),
+                       keyOf<I>(rhs));
+  }
+
+  template <typename Fn, std::size_t... Is>
+  static void forEachIndex(Fn &fn, std::index_sequence<Is...>) {
+    (fn(std::integral_constant<std::size_t, Is>()), ...);
+  }
+  // Calls fn(std::integral_constant<std::size_t, I>) for every index.
+  template <typename Fn>
+  static void forEachIndex(Fn &&fn) {
+    forEachIndex(fn, std::make_index_sequence<kIndices>());
+  }
+
+  template <std::size_t I>
+  node_ptr findSlot(const T &value, Slot &slot) const;
+  node_ptr findSlots(const T &value, Slot *slots) const;
+  template <std::size_t I>
+  bool inOrder(Node *node) const;
+
+  void linkAt(std::size_t index, Node *node, Slot slot);
+  void unlinkAt(std::size_t index, Node *node);
+  void linkAll(Node *node, const Slot *slots);
+  void destroy(Node *node);
+  bool relink(Node *node);
+
+  template <typename V>
+  std::pair<iterator<0>, bool> insertValue(V &&value);
+
+  node_ptr roots_[kIndices] = {};
+  size_type size_ = 0;
+};
+
+// A bidirectional iterator over const elements in the order of index I.
+template <typename T, typename... Indices>
+template <std::size_t I>
+class multi_index<T, Indices...>::iterator {
+  friend multi_index;
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const T *;
+  using reference = const T &;
+
+  iterator() = default;
+
+  reference operator*() const { return nodeOf<I>(current_)->value; }
+  pointer operator->() const { return &nodeOf<I>(current_)->value; }
+
+  iterator &operator++() {
+    current_ = Algorithms::next(current_);
+    return *this;
+  }
+  iterator operator++(int) {
+    iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  iterator &operator--() {
+    current_ = current_ ? Algorithms::prev(current_)
+                        : Algorithms::maximum(owner_->roots_[I]);
+    return *this;
+  }
+  iterator operator--(int) {
+    iterator tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const iterator &other) const {
+    return current_ == other.current_;
+  }
+  bool operator!=(const iterator &other) const {
+    return current_ != other.current_;
+  }
+
+ private:
+  iterator(node_ptr hook, const multi_index *owner)
+      : current_(hook), owner_(owner) {}
+
+  node_ptr current_ = nullptr;
+  const multi_index *owner_ = nullptr;  // for --end()
+};
+
+// Read-only view of index I. It stays valid while the container lives and
+// reflects later changes. Lookups take any key the index's Compare can
+// order against the extracted key.
+template <typename T, typename... Indices>
+template <std::size_t I>
+class multi_index<T, Indices...>::index_view {
+  friend multi_index;
+
+  using Spec = IndexAt<I>;
+
+ public:
+  using iterator = typename multi_index::template iterator<I>;
+  using const_iterator = iterator;
+
+  iterator begin() const {
+    return iterator(Algorithms::minimum(owner_->roots_[I]), owner_);
+  }
+  iterator end() const { return iterator(nullptr, owner_); }
+  bool empty() const { return owner_->empty(); }
+  size_type size() const { return owner_->size(); }
+
+  template <typename K>
+  iterator lower_bound(const K &key) const {
+    return bound(key, [](const auto &lhs, const auto &rhs) {
+      return typename Spec::compare()(lhs, rhs);
+    });
+  }
+  template <typename K>
+  iterator upper_bound(const K &key) const {
+    return bound(key, [](const auto &lhs, const auto &rhs) {
+      return !typename Spec::compare()(rhs, lhs);
+    });
+  }
+  template <typename K>
+  std::pair<iterator, iterator> equal_range(const K &key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  // The first element with an equal key, or end().
+  template <typename K>
+  iterator find(const K &key) const {
+    iterator it = lower_bound(key);
+    if (it != end() && typename Spec::compare()(key, keyOf<I>(*it))) {
+      return end();
+    }
+    return it;
+  }
+  template <typename K>
+  bool contains(const K &key) const {
+    return find(key) != end();
+  }
+  template <typename K>
+  size_type count(const K &key) const {
+    auto [first, last] = equal_range(key);
+    return static_cast<size_type>(std::distance(first, last));
+  }
+
+ private:
+  explicit index_view(const multi_index *owner) : owner_(owner) {}
+
+  // The first element for which before(extracted key, key) is false.
+  template <typename K, typename Before>
+  iterator bound(const K &key, Before before) const {
+    node_ptr current = owner_->roots_[I];
+    node_ptr result = nullptr;
+    while (current) {
+      if (before(keyOf<I>(nodeOf<I>(current)->value), key)) {
+        current = Traits::right(current);
+      } else {
+        result = current;
+        current = Traits::left(current);
+      }
+    }
+    return iterator(result, owner_);
+  }
+
+  const multi_index *owner_;
+};
+
+template <typename T, typename... Indices>
+multi_index<T, Indices...>::multi_index(
+    std::initializer_list<value_type> const &items) {
+  for (const value_type &item : items) insert(item);
+}
+
+template <typename T, typename... Indices>
+multi_index<T, Indices...>::multi_index(const multi_index &other) {
+  for (const value_type &value : other.template get<0>()) insert(value);
+}
+
+template <typename T, typename... Indices>
+multi_index<T, Indices...> &multi_index<T, Indices...>::operator=(
+    const multi_index &other) {
+  if (this != &other) {
+    multi_index copy(other);
+    swap(copy);
+  }
+  return *this;
+}
+
+template <typename T, typename... Indices>
+multi_index<T, Indices...> &multi_index<T, Indices...>::operator=(
+    multi_index &&other) {
+  if (this != &other) {
+    clear();
+    swap(other);
+  }
+  return *this;
+}
+
+template <typename T, typename... Indices>
+template <typename... Args>
+std::pair<typename multi_index<T, Indices...>::template iterator<0>, bool>
+multi_index<T, Indices...>::emplace(Args &&...args) {
+  Node *node = new Node(std::forward<Args>(args)...);
+  Slot slots[kIndices];
+  if (node_ptr clash = findSlots(node->value, slots)) {
+    delete node;
+    return {iterator<0>(clash, this), false};
+  }
+  linkAll(node, slots);
+  return {iterator<0>(&node->hooks[0], this), true};
+}
+
+// The slots are found before the node exists, so a rejected insert costs
+// no allocation.
+template <typename T, typename... Indices>
+template <typename V>
+std::pair<typename multi_index<T, Indices...>::template iterator<0>, bool>
+multi_index<T, Indices...>::insertValue(V &&value) {
+  Slot slots[kIndices];
+  if (node_ptr clash = findSlots(value, slots)) {
+    return {iterator<0>(clash, this), false};
+  }
+  Node *node = new Node(std::forward<V>(value));
+  linkAll(node, slots);
+  return {iterator<0>(&node->hooks[0], this), true};
+}
+
+template <typename T, typename... Indices>
+template <std::size_t I>
+typename multi_index<T, Indices...>::template iterator<I>
+multi_index<T, Indices...>::erase(iterator<I> pos) {
+  iterator<I> next = pos;
+  ++next;
+  destroy(nodeOf<I>(pos.current_));
+  return next;
+}
+
+template <typename T, typename... Indices>
+template <std::size_t I, typename K>
+typename multi_index<T, Indices...>::size_type
+multi_index<T, Indices...>::erase(const K &key) {
+  auto [first, last] = get<I>().equal_range(key);
+  size_type removed = 0;
+  while (first != last) {
+    first = erase(first);
+    ++removed;
+  }
+  return removed;
+}
+
+// Flattens index 0 with right rotations while freeing; the other indices
+// die with their nodes.
+template <typename T, typename... Indices>
+void multi_index<T, Indices...>::clear() {
+  node_ptr hook = roots_[0];
+  while (hook) {
+    if (node_ptr left = Traits::left(hook)) {
+      Traits::setLeft(hook, Traits::right(left));
+      Traits::setRight(left, hook);
+      hook = left;
+    } else {
+      node_ptr right = Traits::right(hook);
+      delete nodeOf<0>(hook);
+      hook = right;
+    }
+  }
+  for (node_ptr &root : roots_) root = nullptr;
+  size_ = 0;
+}
+
+template <typename T, typename... Indices>
+void multi_index<T, Indices...>::swap(multi_index &other) {
+  for (std::size_t i = 0; i < kIndices; ++i) {
+    std::swap(roots_[i], other.roots_[i]);
+  }
+  std::swap(size_, other.size_);
+}
+
+template <typename T, typename... Indices>
+template <std::size_t I, typename Fn>
+bool multi_index<T, Indices...>::modify(iterator<I> pos, Fn fn) {
+  Node *node = nodeOf<I>(pos.current_);
+  try {
+    fn(node->value);
+  } catch (...) {
+    destroy(node);
+    throw;
+  }
+  return relink(node);
+}
+
+// Clashes are checked on the intact indices first, so a refused replace
+// leaves the element as it was. The copy is made before the element is
+// touched; only a throwing assignment can leave it half written, and
+// then it is erased as in modify().
+template <typename T, typename... Indices>
+template <std::size_t I>
+bool multi_index<T, Indices...>::replace(iterator<I> pos,
+                                         const value_type &value) {
+  Node *node = nodeOf<I>(pos.current_);
+  bool clash = false;
+  forEachIndex([&](auto tag) {
+    constexpr std::size_t J = decltype(tag)::value;
+    if (clash || !IndexAt<J>::unique) return;
+    Slot slot;
+    node_ptr equal = findSlot<J>(value, slot);
+    clash = equal && equal != &node->hooks[J];
+  });
+  if (clash) return false;
+  T copy(value);
+  try {
+    node->value = std::move(copy);
+  } catch (...) {
+    destroy(node);
+    throw;
+  }
+  relink(node);
+  return true;
+}
+
+// Descends index I for value. A unique index stops at an equal key and
+// returns its hook; a non-unique one places value after its equals.
+template <typename T, typename... Indices>
+template <std::size_t I>
+typename multi_index<T, Indices...>::node_ptr
+multi_index<T, Indices...>::findSlot(const T &value, Slot &slot) const {
+  slot = Slot();
+  for (node_ptr current = roots_[I]; current;) {
+    int order = compareValues<I>(value, nodeOf<I>(current)->value);
+    if (order == 0 && IndexAt<I>::unique) return current;
+    slot.parent = current;
+    slot.as_left = order < 0;
+    current = slot.as_left ? Traits::left(current) : Traits::right(current);
+  }
+  return nullptr;
+}
+
+// Fills a slot per index, or returns the first clashing hook.
+template <typename T, typename... Indices>
+typename multi_index<T, Indices...>::node_ptr
+multi_index<T, Indices...>::findSlots(const T &value, Slot *slots) const {
+  node_ptr clash = nullptr;
+  forEachIndex([&](auto tag) {
+    constexpr std::size_t I = decltype(tag)::value;
+    if (clash) return;
+    if (node_ptr equal = findSlot<I>(value, slots[I])) {
+      clash = &nodeOf<I>(equal)->hooks[0];
+    }
+  });
+  return clash;
+}
+
+template <typename T, typename... Indices>
+template <std::size_t I>
+bool multi_index<T, Indices...>::inOrder(Node *node) const {
+  node_ptr hook = &node->hooks[I];
+  node_ptr prev = Algorithms::prev(hook);
+  node_ptr next = Algorithms::next(hook);
+  int after_prev = prev ? compareValues<I>(nodeOf<I>(prev)->value, node->value)
+                        : -1;
+  int before_next =
+      next ? compareValues<I>(node->value, nodeOf<I>(next)->value) : -1;
+  if (IndexAt<I>::unique) return after_prev < 0 && before_next < 0;
+  return after_prev <= 0 && before_next <= 0;
+}
+
+template <typename T, typename... Indices>
+void multi_index<T, Indices...>::linkAt(std::size_t index, Node *node,
+                                        Slot slot) {
+  node_ptr hook = &node->hooks[index];
+  Algorithms::link(roots_[index], hook, slot.parent, slot.as_left);
+  Traits::setLinked(hook, true);
+  Traits::setRed(hook, true);
+  Algorithms::fixInsertion(roots_[index], hook);
+}
+
+template <typename T, typename... Indices>
+void multi_index<T, Indices...>::unlinkAt(std::size_t index, Node *node) {
+  node_ptr hook = &node->hooks[index];
+  auto [x, x_parent, removed_red] = Algorithms::unlink(roots_[index], hook);
+  if (!removed_red) {
+    Algorithms::deleteFixup(roots_[index], x, x_parent);
+  }
+  Traits::setLinked(hook, false);
+}
+
+template <typename T, typename... Indices>
+void multi_index<T, Indices...>::linkAll(Node *node, const Slot *slots) {
+  for (std::size_t i = 0; i < kIndices; ++i) linkAt(i, node, slots[i]);
+  ++size_;
+}
+
+// Unlinks from whichever indices still hold the node, then frees it.
+template <typename T, typename... Indices>
+void multi_index<T, Indices...>::destroy(Node *node) {
+  for (std::size_t i = 0; i < kIndices; ++i) {
+    if (node->hooks[i].is_linked()) unlinkAt(i, node);
+  }
+  delete node;
+  --size_;
+}
+
+// Moves a changed element in each index whose order it broke; on a clash
+// with a unique index the element is destroyed and false returned.
+template <typename T, typename... Indices>
+bool multi_index<T, Indices...>::relink(Node *node) {
+  bool clash = false;
+  forEachIndex([&](auto tag) {
+    constexpr std::size_t I = decltype(tag)::value;
+    if (clash || inOrder<I>(node)) return;
+    unlinkAt(I, node);
+    Slot slot;
+    clash = findSlot<I>(node->value, slot) != nullptr;
+    if (!clash) linkAt(I, node, slot);
+  });
+  if (clash) destroy(node);
+  return !clash;
+}
+
+}  // namespace s21
+
+#endif
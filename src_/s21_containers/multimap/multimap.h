@@ -0,0 +1,133 @@
+#include <initializer_list>
+#include <utility>
+
+#include "../map/map.h"
+#include "../tree/tree.h"
+
+#ifndef multimap_h
+#define multimap_h
+
+namespace s21 {
+
+// Map with repeated keys on the same tree core as map, replacing the
+// map<Key, vector<T>> pattern. Entries with equal keys iterate in insertion
+// order.
+template <typename Key, typename T>
+class multimap
+    : public RBTree<std::pair<const Key, T>, PairKeyComparator<Key>> {
+ public:
+  using MyBase = RBTree<std::pair<const Key, T>, PairKeyComparator<Key>>;
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = typename MyBase::iterator;
+  using const_iterator = typename MyBase::const_iterator;
+  using size_type = size_t;
+
+  using MyBase::MyBase;
+  multimap(std::initializer_list<value_type> const &items);
+
+  iterator insert(const value_type &value) {
+    return MyBase::insertEqual(value);
+  }
+  iterator insert(const Key &key, const T &obj) {
+    return MyBase::insertEqual(value_type(key, obj));
+  }
+  using MyBase::erase;
+  size_type erase(const Key &key);
+  void merge(multimap &other);
+
+  iterator find(const Key &key) const;
+  bool contains(const Key &key) const { return find(key) != MyBase::end(); }
+  size_type count(const Key &key) const;
+  std::pair<iterator, iterator> equal_range(const Key &key) const;
+  iterator lower_bound(const Key &key) const {
+    return MyBase::lowerBoundKey(key);
+  }
+  iterator upper_bound(const Key &key) const {
+    return MyBase::upperBoundKey(key);
+  }
+
+ private:
+  // These assume unique keys: splitting or joining runs of equal keys,
+  // set algebra, batched and finger lookups and cursors would each pick
+  // or drop an arbitrary duplicate.
+  using MyBase::concat;
+  using MyBase::contains_many;
+  using MyBase::Cursor;
+  using MyBase::emplace_hint;
+  using MyBase::find_many;
+  using MyBase::intersect;
+  using MyBase::join;
+  using MyBase::load;
+  using MyBase::push_back_ordered;
+  using MyBase::split;
+  using MyBase::split_at;
+  using MyBase::subtract;
+  using MyBase::unite;
+};
+
+template <typename Key, typename T>
+multimap<Key, T>::multimap(std::initializer_list<value_type> const &items) {
+  for (const auto &item : items) {
+    insert(item);
+  }
+}
+
+// Walks the run of equal keys once: O(log n + k).
+template <typename Key, typename T>
+typename multimap<Key, T>::size_type multimap<Key, T>::erase(const Key &key) {
+  auto range = equal_range(key);
+  size_type erased = 0;
+  while (range.first != range.second) {
+    MyBase::erase(range.first++);
+    ++erased;
+  }
+  return erased;
+}
+
+template <typename Key, typename T>
+void multimap<Key, T>::merge(multimap &other) {
+  if (this == &other) {
+    return;
+  }
+  for (auto it = other.begin(); it != other.end(); ++it) {
+    insert(*it);
+  }
+  other.clear();
+}
+
+// Returns the first entry with the key.
+template <typename Key, typename T>
+typename multimap<Key, T>::iterator multimap<Key, T>::find(
+    const Key &key) const {
+  iterator it = lower_bound(key);
+  if (it == MyBase::end() || MyBase::comparator_(key, *it)) {
+    return MyBase::end();
+  }
+  return it;
+}
+
+template <typename Key, typename T>
+typename multimap<Key, T>::size_type multimap<Key, T>::count(
+    const Key &key) const {
+  auto range = equal_range(key);
+  size_type result = 0;
+  for (; range.first != range.second; ++range.first) {
+    ++result;
+  }
+  return result;
+}
+
+template <typename Key, typename T>
+std::pair<typename multimap<Key, T>::iterator,
+          typename multimap<Key, T>::iterator>
+multimap<Key, T>::equal_range(const Key &key) const {
+  return {lower_bound(key), upper_bound(key)};
+}
+
+}  // namespace s21
+
+#endif
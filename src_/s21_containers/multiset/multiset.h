@@ -0,0 +1,123 @@
+#include <initializer_list>
+#include <utility>
+
+#include "../tree/tree.h"
+
+#ifndef multiset_h
+#define multiset_h
+
+namespace s21 {
+
+// Sorted container that keeps equal keys side by side in one tree. A new
+// key goes after the ones already equal to it, so equal keys iterate in
+// insertion order.
+template <typename Key>
+class multiset : public RBTree<Key, std::less<Key>> {
+ public:
+  using MyBase = RBTree<Key, std::less<Key>>;
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = typename MyBase::iterator;
+  using const_iterator = typename MyBase::const_iterator;
+  using size_type = size_t;
+
+  using MyBase::MyBase;
+  multiset(std::initializer_list<value_type> const &items);
+
+  iterator insert(const value_type &value) {
+    return MyBase::insertEqual(value);
+  }
+  using MyBase::erase;
+  size_type erase(const Key &key);
+  void merge(multiset &other);
+
+  iterator find(const Key &key) const;
+  size_type count(const Key &key) const;
+  std::pair<iterator, iterator> equal_range(const Key &key) const;
+  iterator lower_bound(const Key &key) const {
+    return MyBase::lowerBoundKey(key);
+  }
+  iterator upper_bound(const Key &key) const {
+    return MyBase::upperBoundKey(key);
+  }
+
+ private:
+  // These assume unique keys: splitting or joining runs of equal keys,
+  // set algebra, batched and finger lookups and cursors would each pick
+  // or drop an arbitrary duplicate.
+  using MyBase::concat;
+  using MyBase::contains_many;
+  using MyBase::Cursor;
+  using MyBase::emplace_hint;
+  using MyBase::find_many;
+  using MyBase::intersect;
+  using MyBase::join;
+  using MyBase::load;
+  using MyBase::push_back_ordered;
+  using MyBase::split;
+  using MyBase::split_at;
+  using MyBase::subtract;
+  using MyBase::unite;
+};
+
+template <typename Key>
+multiset<Key>::multiset(std::initializer_list<value_type> const &items) {
+  for (const auto &item : items) {
+    insert(item);
+  }
+}
+
+// Walks the run of equal keys once: O(log n + k).
+template <typename Key>
+typename multiset<Key>::size_type multiset<Key>::erase(const Key &key) {
+  auto range = equal_range(key);
+  size_type erased = 0;
+  while (range.first != range.second) {
+    MyBase::erase(range.first++);
+    ++erased;
+  }
+  return erased;
+}
+
+template <typename Key>
+void multiset<Key>::merge(multiset &other) {
+  if (this == &other) {
+    return;
+  }
+  for (auto it = other.begin(); it != other.end(); ++it) {
+    insert(*it);
+  }
+  other.clear();
+}
+
+// Returns the first of the equal keys.
+template <typename Key>
+typename multiset<Key>::iterator multiset<Key>::find(const Key &key) const {
+  iterator it = lower_bound(key);
+  if (it == MyBase::end() || MyBase::comparator_(key, *it)) {
+    return MyBase::end();
+  }
+  return it;
+}
+
+template <typename Key>
+typename multiset<Key>::size_type multiset<Key>::count(const Key &key) const {
+  auto range = equal_range(key);
+  size_type result = 0;
+  for (; range.first != range.second; ++range.first) {
+    ++result;
+  }
+  return result;
+}
+
+template <typename Key>
+std::pair<typename multiset<Key>::iterator, typename multiset<Key>::iterator>
+multiset<Key>::equal_range(const Key &key) const {
+  return {lower_bound(key), upper_bound(key)};
+}
+
+}  // namespace s21
+
+#endif
@@ -1,18 +1,71 @@
+#include <vector>
 
-
-#include "../tree/tree.h"
+#include "../tree/parallel.h"
+#include "../tree/storage.h"
 namespace s21 {
-template <typename Key>
-class set : public RBTree<Key> {
+template <typename Key, typename Storage = node_storage>
+class set : public Storage::template tree<Key, std::less<Key>> {
  public:
+  using MyBase = typename Storage::template tree<Key, std::less<Key>>;
   using key_type = Key;
   using value_type = Key;
   using reference = value_type &;
   using const_reference = const value_type &;
-  using iterator = typename RBTree<Key>::iterator;  // const?
-  using const_iterator = typename RBTree<Key>::const_iterator;
+  using iterator = typename MyBase::iterator;  // const?
+  using const_iterator = typename MyBase::const_iterator;
   using size_type = size_t;
+  // Seeks by key from the last position; see RBTree::Cursor.
+  using cursor = typename cursor_traits<MyBase, Key>::type;
+
+  using MyBase::MyBase;
 
-  using RBTree<Key>::RBTree;
+  template <typename InputIt>
+  static set from_unsorted(InputIt first, InputIt last,
+                           unsigned threads = defaultThreadCount());
 };
+
+// Sorts and deduplicates a copy of the input in parallel, then links the
+// balanced tree bottom-up instead of inserting element by element.
+template <typename Key, typename Storage>
+template <typename InputIt>
+set<Key, Storage> set<Key, Storage>::from_unsorted(InputIt first, InputIt last,
+                                                   unsigned threads) {
+  set result;
+  std::vector<Key> items(first, last);
+  parallelSortUnique(items, result.comparator_, threads);
+  result.buildFromSorted(items.begin(), items.end(), threads);
+  return result;
+}
+
+// New-set forms of unite(), intersect() and subtract(). Each copies one
+// argument first: the larger for a union, the smaller for an intersection
+// and the left one for a difference.
+template <typename Key, typename Storage>
+set<Key, Storage> set_union(const set<Key, Storage> &lhs,
+                            const set<Key, Storage> &rhs,
+                            unsigned threads = 1) {
+  bool lhs_larger = lhs.size() >= rhs.size();
+  set<Key, Storage> result(lhs_larger ? lhs : rhs);
+  result.unite(lhs_larger ? rhs : lhs, threads);
+  return result;
+}
+
+template <typename Key, typename Storage>
+set<Key, Storage> set_intersection(const set<Key, Storage> &lhs,
+                                   const set<Key, Storage> &rhs,
+                                   unsigned threads = 1) {
+  bool lhs_smaller = lhs.size() <= rhs.size();
+  set<Key, Storage> result(lhs_smaller ? lhs : rhs);
+  result.intersect(lhs_smaller ? rhs : lhs, threads);
+  return result;
+}
+
+template <typename Key, typename Storage>
+set<Key, Storage> set_difference(const set<Key, Storage> &lhs,
+                                 const set<Key, Storage> &rhs,
+                                 unsigned threads = 1) {
+  set<Key, Storage> result(lhs);
+  result.subtract(rhs, threads);
+  return result;
+}
 }  // namespace s21
@@ -0,0 +1,280 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#ifndef static_map_h
+#define static_map_h
+
+namespace s21 {
+
+// How static_map answers find(): automatic picks perfect_hash for hashable
+// keys once the table has kStaticMapHashFrom entries, binary_search below.
+enum class static_map_lookup { automatic, binary_search, perfect_hash };
+
+inline constexpr std::size_t kStaticMapHashFrom = 8;
+
+// Keys the perfect hash can take: integers, enums and string_view ordered
+// by std::less, so that equality under Compare is plain ==.
+template <typename Key, typename Compare>
+struct static_map_hashable
+    : std::bool_constant<std::is_same_v<Compare, std::less<Key>> &&
+                         (std::is_integral_v<Key> || std::is_enum_v<Key> ||
+                          std::is_same_v<Key, std::string_view>)> {};
+
+// Immutable map for lookup tables known at compile time. It is built in a
+// constexpr context from a list of pairs, sorted there, and stored inline,
+// so a table costs no startup work and no heap:
+//
+//   constexpr auto kOpcodes = s21::make_static_map<int, std::string_view>(
+//       {{0x10, "load"}, {0x01, "nop"}, {0x20, "store"}});
+//   static_assert(kOpcodes.at(0x10) == "load");
+//
+// Entries stay sorted for iteration. find() either runs a branchless
+// binary search whose trip count is fixed by N, or probes a perfect hash
+// (hash and displace) built at compile time: one hash, one displacement
+// read, one key compare. Duplicate keys fail the build.
+template <typename Key, typename T, std::size_t N,
+          typename Compare = std::less<Key>,
+          static_map_lookup Lookup = static_map_lookup::automatic>
+class static_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using size_type = std::size_t;
+
+  struct value_type {
+    Key first{};
+    T second{};
+  };
+  using const_iterator = const value_type *;
+
+  static constexpr bool kHashed =
+      Lookup == static_map_lookup::perfect_hash ||
+      (Lookup == static_map_lookup::automatic &&
+       static_map_hashable<Key, Compare>::value && N >= kStaticMapHashFrom);
+  static_assert(!kHashed || static_map_hashable<Key, Compare>::value,
+                "perfect_hash needs integer, enum or string_view keys under "
+                "std::less");
+
+  constexpr explicit static_map(const std::pair<Key, T> (&items)[N]);
+
+  constexpr const_iterator begin() const { return entries_.data(); }
+  constexpr const_iterator end() const { return entries_.data() + N; }
+  constexpr bool empty() const { return N == 0; }
+  constexpr size_type size() const { return N; }
+
+  constexpr const T *find(const Key &key) const {
+    const value_type *entry = nullptr;
+    if constexpr (kHashed) {
+      entry = hashedEntry(key);
+    } else {
+      entry = searchedEntry(key);
+    }
+    return entry ? &entry->second : nullptr;
+  }
+  constexpr bool contains(const Key &key) const {
+    return find(key) != nullptr;
+  }
+  // A missing key throws, which in a constant expression fails the build.
+  constexpr const T &at(const Key &key) const {
+    const T *value = find(key);
+    if (!value) {
+      throw std::out_of_range("key not found");
+    }
+    return *value;
+  }
+  // The first entry whose key is not less than key, in sorted order.
+  constexpr const_iterator lower_bound(const Key &key) const;
+
+ private:
+  using Slot = std::conditional_t<(N < 0xFFFF), std::uint16_t, std::uint32_t>;
+
+  static constexpr unsigned log2Ceil(std::size_t n) {
+    unsigned bits = 0;
+    while ((std::size_t(1) << bits) < n) ++bits;
+    return bits;
+  }
+  // A half-full slot table and about two keys per bucket keep the
+  // displacement search short. Both are powers of two, indexed by the top
+  // bits of a multiplicative hash.
+  static constexpr unsigned kSlotBits = kHashed ? log2Ceil(2 * N) : 0;
+  static constexpr unsigned kBucketBits = kHashed ? log2Ceil(N / 2 + 1) : 0;
+  static constexpr std::size_t kSlots = std::size_t(1) << kSlotBits;
+  static constexpr std::size_t kBuckets = std::size_t(1) << kBucketBits;
+  static constexpr Slot kEmpty = static_cast<Slot>(N);
+  static constexpr std::uint32_t kMaxDisplacement = 1u << 20;
+
+  static constexpr std::uint64_t topBits(std::uint64_t h, unsigned bits) {
+    return bits ? h >> (64 - bits) : 0;
+  }
+  // Integers need one multiply; string hashes get a full finalizer so that
+  // their top bits are usable.
+  static constexpr std::uint64_t hashKey(const Key &key) {
+    if constexpr (std::is_same_v<Key, std::string_view>) {
+      std::uint64_t h = 0xCBF29CE484222325ull;  // FNV-1a
+      for (char c : key) {
+        h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+      }
+      h ^= h >> 33;
+      h *= 0xFF51AFD7ED558CCDull;
+      return h ^ (h >> 33);
+    } else if constexpr (std::is_enum_v<Key>) {
+      return static_cast<std::uint64_t>(
+                 static_cast<std::underlying_type_t<Key>>(key)) *
+             0x9E3779B97F4A7C15ull;
+    } else {
+      return static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+    }
+  }
+  static constexpr std::size_t bucketOf(std::uint64_t h) {
+    return topBits(h, kBucketBits);
+  }
+  static constexpr std::size_t slotOf(std::uint64_t h,
+                                      std::uint32_t displacement) {
+    return topBits((h ^ displacement) * 0xC4CEB9FE1A85EC53ull, kSlotBits);
+  }
+
+  constexpr void sortEntries();
+  constexpr void buildHash();
+  constexpr const value_type *searchedEntry(const Key &key) const;
+  constexpr const value_type *hashedEntry(const Key &key) const;
+
+  std::array<value_type, N> entries_{};
+  std::array<std::uint32_t, kBuckets> displacements_{};
+  std::array<Slot, kSlots> slots_{};
+  Compare comparator_{};
+};
+
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          static_map_lookup Lookup = static_map_lookup::automatic,
+          std::size_t N>
+constexpr static_map<Key, T, N, Compare, Lookup> make_static_map(
+    const std::pair<Key, T> (&items)[N]) {
+  return static_map<Key, T, N, Compare, Lookup>(items);
+}
+
+template <typename Key, typename T, std::size_t N, typename Compare,
+          static_map_lookup Lookup>
+constexpr static_map<Key, T, N, Compare, Lookup>::static_map(
+    const std::pair<Key, T> (&items)[N]) {
+  for (std::size_t i = 0; i < N; ++i) {
+    entries_[i].first = items[i].first;
+    entries_[i].second = items[i].second;
+  }
+  sortEntries();
+  if constexpr (kHashed) buildHash();
+}
+
+// Insertion sort: std::sort is not constexpr in C++17, and tables are small.
+template <typename Key, typename T, std::size_t N, typename Compare,
+          static_map_lookup Lookup>
+constexpr void static_map<Key, T, N, Compare, Lookup>::sortEntries() {
+  for (std::size_t i = 1; i < N; ++i) {
+    value_type entry = entries_[i];
+    std::size_t j = i;
+    for (; j > 0 && comparator_(entry.first, entries_[j - 1].first); --j) {
+      entries_[j] = entries_[j - 1];
+    }
+    entries_[j] = entry;
+  }
+  for (std::size_t i = 1; i < N; ++i) {
+    if (!comparator_(entries_[i - 1].first, entries_[i].first)) {
+      throw std::invalid_argument("static_map: duplicate key");
+    }
+  }
+}
+
+// Hash and displace: buckets are placed largest first, each trying
+// displacements until all its keys land in free slots.
+template <typename Key, typename T, std::size_t N, typename Compare,
+          static_map_lookup Lookup>
+constexpr void static_map<Key, T, N, Compare, Lookup>::buildHash() {
+  std::array<std::uint64_t, N> hashes{};
+  std::array<std::size_t, kBuckets + 1> starts{};
+  for (std::size_t i = 0; i < N; ++i) {
+    hashes[i] = hashKey(entries_[i].first);
+    ++starts[bucketOf(hashes[i]) + 1];
+  }
+  for (std::size_t b = 0; b < kBuckets; ++b) starts[b + 1] += starts[b];
+  std::array<std::size_t, N> members{};
+  std::array<std::size_t, kBuckets> filled{};
+  for (std::size_t i = 0; i < N; ++i) {
+    std::size_t b = bucketOf(hashes[i]);
+    members[starts[b] + filled[b]++] = i;
+  }
+
+  std::array<std::size_t, kBuckets> order{};
+  for (std::size_t b = 0; b < kBuckets; ++b) {
+    std::size_t j = b;
+    for (; j > 0 && filled[order[j - 1]] < filled[b]; --j) {
+      order[j] = order[j - 1];
+    }
+    order[j] = b;
+  }
+
+  for (Slot &slot : slots_) slot = kEmpty;
+  for (std::size_t b : order) {
+    if (filled[b] == 0) break;
+    for (std::uint32_t d = 0;; ++d) {
+      if (d == kMaxDisplacement) {
+        throw std::logic_error("static_map: no perfect hash found");
+      }
+      std::size_t placed = starts[b];
+      for (; placed < starts[b + 1]; ++placed) {
+        std::size_t slot = slotOf(hashes[members[placed]], d);
+        if (slots_[slot] != kEmpty) break;
+        slots_[slot] = static_cast<Slot>(members[placed]);
+      }
+      if (placed == starts[b + 1]) {
+        displacements_[b] = d;
+        break;
+      }
+      while (placed-- > starts[b]) {
+        slots_[slotOf(hashes[members[placed]], d)] = kEmpty;
+      }
+    }
+  }
+}
+
+// Halves the range with a select instead of a branch; the loop runs
+// log2(N) times whatever the key.
+template <typename Key, typename T, std::size_t N, typename Compare,
+          static_map_lookup Lookup>
+constexpr typename static_map<Key, T, N, Compare, Lookup>::const_iterator
+static_map<Key, T, N, Compare, Lookup>::lower_bound(const Key &key) const {
+  if (N == 0) return end();
+  const value_type *base = entries_.data();
+  for (std::size_t length = N; length > 1;) {
+    std::size_t half = length / 2;
+    base = comparator_(base[half].first, key) ? base + half : base;
+    length -= half;
+  }
+  return base + comparator_(base->first, key);
+}
+
+template <typename Key, typename T, std::size_t N, typename Compare,
+          static_map_lookup Lookup>
+constexpr const typename static_map<Key, T, N, Compare, Lookup>::value_type *
+static_map<Key, T, N, Compare, Lookup>::searchedEntry(const Key &key) const {
+  const value_type *entry = lower_bound(key);
+  return entry != end() && !comparator_(key, entry->first) ? entry : nullptr;
+}
+
+template <typename Key, typename T, std::size_t N, typename Compare,
+          static_map_lookup Lookup>
+constexpr const typename static_map<Key, T, N, Compare, Lookup>::value_type *
+static_map<Key, T, N, Compare, Lookup>::hashedEntry(const Key &key) const {
+  std::uint64_t h = hashKey(key);
+  Slot index = slots_[slotOf(h, displacements_[bucketOf(h)])];
+  return index != kEmpty && entries_[index].first == key ? &entries_[index]
+                                                         : nullptr;
+}
+
+}  // namespace s21
+
+#endif
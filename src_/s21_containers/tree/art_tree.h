@@ -0,0 +1,915 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#ifndef art_tree_h
+#define art_tree_h
+
+namespace s21 {
+
+// Maps a key to bytes whose lexicographic order (as unsigned chars) matches
+// the key order. Specialize it to index other key types.
+template <typename Key, typename Enable = void>
+struct art_key_traits;
+
+template <>
+struct art_key_traits<std::string> {
+  struct buffer_type {};
+  static std::string_view bytes(const std::string& key, buffer_type&) {
+    return key;
+  }
+};
+
+// Integers are stored big-endian; signed ones with the sign bit flipped so
+// negative values sort first.
+template <typename Key>
+struct art_key_traits<Key, std::enable_if_t<std::is_integral<Key>::value &&
+                                            !std::is_same<Key, bool>::value>> {
+  using buffer_type = std::array<char, sizeof(Key)>;
+  static std::string_view bytes(Key key, buffer_type& buffer) {
+    using Unsigned = std::make_unsigned_t<Key>;
+    constexpr int kBits = 8 * sizeof(Key);
+    Unsigned bits = static_cast<Unsigned>(key);
+    if (std::is_signed<Key>::value) {
+      bits ^= Unsigned(1) << (kBits - 1);
+    }
+    for (std::size_t i = 0; i < sizeof(Key); ++i) {
+      buffer[i] = static_cast<char>(bits >> (kBits - 8 * (i + 1)));
+    }
+    return std::string_view(buffer.data(), buffer.size());
+  }
+};
+
+struct ArtIdentity {
+  template <typename Value>
+  const Value& operator()(const Value& value) const {
+    return value;
+  }
+};
+
+struct ArtPairFirst {
+  template <typename Pair>
+  const typename Pair::first_type& operator()(const Pair& pair) const {
+    return pair.first;
+  }
+};
+
+// Adaptive radix tree: the key bytes select the path, so a lookup costs
+// O(key length) whatever the number of keys.
+//  - Inner nodes come in four sizes (4, 16, 48 and 256 children) and grow
+//    or shrink with their fan-out.
+//  - Path compression: an inner node stores the bytes shared by its whole
+//    subtree as a prefix.
+//  - Lazy expansion: a subtree holding a single key is just its leaf.
+//  - A key that ends inside the tree, such as "ab" next to "abc", is the
+//    terminal leaf of the inner node at that depth.
+// Leaves are linked in key order, so iteration and ranges do not walk the
+// inner nodes.
+template <typename Key, typename Value, typename KeyOf>
+class ArtTree {
+ public:
+  class iterator;
+
+  using key_type = Key;
+  using value_type = Value;
+  using const_iterator = iterator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  ArtTree() = default;
+  ArtTree(std::initializer_list<value_type> const& items);
+  ArtTree(const ArtTree& other);
+  ArtTree(ArtTree&& other);
+
+  ArtTree& operator=(const ArtTree& other);
+  ArtTree& operator=(ArtTree&& other);
+
+  ~ArtTree() { clear(); }
+
+  iterator begin() const { return iterator(head_, this); }
+  iterator end() const { return iterator(nullptr, this); }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  size_type max_size() const {
+    return std::numeric_limits<difference_type>::max() / sizeof(Leaf);
+  }
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type& value);
+  void erase(iterator pos);
+  size_type erase(const Key& key);
+  void swap(ArtTree& other);
+  void merge(ArtTree& other);
+
+  iterator find(const Key& key) const;
+  bool contains(const Key& key) const { return find(key) != end(); }
+  iterator lower_bound(const Key& key) const;
+  // Every key whose byte form starts with the byte form of prefix; for
+  // string keys, the keys that start with prefix.
+  std::pair<iterator, iterator> prefix_range(const Key& prefix) const;
+
+ private:
+  using Traits = art_key_traits<Key>;
+  using Buffer = typename Traits::buffer_type;
+
+  enum NodeType : std::uint8_t { kLeaf, kNode4, kNode16, kNode48, kNode256 };
+
+  struct Node {
+    NodeType type;
+  };
+
+  struct Leaf : Node {
+    explicit Leaf(const value_type& item) : Node{kLeaf}, value(item) {}
+    value_type value;
+    Leaf* prev = nullptr;
+    Leaf* next = nullptr;
+  };
+
+  struct Inner : Node {
+    explicit Inner(NodeType node_type) : Node{node_type} {}
+    std::string prefix;
+    Leaf* terminal = nullptr;
+    std::uint16_t count = 0;
+  };
+
+  // Node4 and Node16: byte keys kept sorted next to their children.
+  template <int Capacity, NodeType Type>
+  struct SortedNode : Inner {
+    SortedNode() : Inner(Type) {}
+    unsigned char keys[Capacity];
+    Node* children[Capacity];
+  };
+  using Node4 = SortedNode<4, kNode4>;
+  using Node16 = SortedNode<16, kNode16>;
+
+  // index[byte] is the child slot plus one, 0 when there is no child.
+  struct Node48 : Inner {
+    Node48() : Inner(kNode48) {}
+    unsigned char index[256] = {};
+    Node* children[48] = {};
+  };
+
+  struct Node256 : Inner {
+    Node256() : Inner(kNode256) {}
+    Node* children[256] = {};
+  };
+
+  static unsigned char byteAt(std::string_view bytes, size_type i) {
+    return static_cast<unsigned char>(bytes[i]);
+  }
+  static std::string_view leafBytes(const Leaf* leaf, Buffer& buffer) {
+    return Traits::bytes(KeyOf()(leaf->value), buffer);
+  }
+
+  // Node4 and Node16 differ only in capacity; these hide which one it is.
+  static unsigned char* sortedKeys(const Inner* node);
+  static Node** sortedChildren(const Inner* node);
+
+  static Node** findChild(Inner* node, unsigned char byte);
+  // First child with a byte above after (-1 for the first child).
+  static Node* childAfter(const Inner* node, int after, int* byte = nullptr);
+  static Node* lastChild(const Inner* node);
+  static Leaf* minimum(Node* node);
+  static Leaf* maximum(Node* node);
+
+  static void insertChild(Inner* node, unsigned char byte, Node* child);
+  static void addChild(Node** ref, unsigned char byte, Node* child);
+  static void removeChild(Inner* node, unsigned char byte);
+  static Inner* grow(Inner* node);
+  static Inner* shrink(Inner* node);
+  static void compact(Node** ref);
+  template <typename Target>
+  static Target* copyInto(Inner* node);
+  static void freeNode(Node* node);
+  static void freeTree(Node* node);
+
+  Leaf* findLeaf(std::string_view key) const;
+  Leaf* lowerBoundIn(Node* node, size_type depth, std::string_view key) const;
+  void insertLeaf(std::string_view key, Leaf* leaf);
+  void eraseLeaf(Leaf* leaf);
+  void linkBefore(Leaf* leaf, Leaf* successor);
+
+  Node* root_ = nullptr;
+  Leaf* head_ = nullptr;
+  Leaf* tail_ = nullptr;
+  size_type size_ = 0;
+};
+
+template <typename Key, typename Value, typename KeyOf>
+class ArtTree<Key, Value, KeyOf>::iterator {
+  friend ArtTree;
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = Value;
+  using difference_type = std::ptrdiff_t;
+  using pointer = value_type*;
+  using reference = value_type&;
+
+  iterator() = default;
+
+  reference operator*() const { return leaf_->value; }
+  pointer operator->() const { return &leaf_->value; }
+
+  iterator& operator++() {
+    leaf_ = leaf_->next;
+    return *this;
+  }
+  iterator operator++(int) {
+    iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  iterator& operator--() {
+    leaf_ = leaf_ ? leaf_->prev : tree_->tail_;
+    return *this;
+  }
+  iterator operator--(int) {
+    iterator tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const iterator& other) const {
+    return leaf_ == other.leaf_;
+  }
+  bool operator!=(const iterator& other) const {
+    return leaf_ != other.leaf_;
+  }
+
+ private:
+  iterator(Leaf* leaf, const ArtTree* tree) : leaf_(leaf), tree_(tree) {}
+
+  Leaf* leaf_ = nullptr;
+  const ArtTree* tree_ = nullptr;  // for --end()
+};
+
+template <typename Key, typename Value, typename KeyOf>
+ArtTree<Key, Value, KeyOf>::ArtTree(
+    std::initializer_list<value_type> const& items) {
+  for (const auto& item : items) {
+    insert(item);
+  }
+}
+
+template <typename Key, typename Value, typename KeyOf>
+ArtTree<Key, Value, KeyOf>::ArtTree(const ArtTree& other) {
+  for (Leaf* leaf = other.head_; leaf; leaf = leaf->next) {
+    insert(leaf->value);
+  }
+}
+
+template <typename Key, typename Value, typename KeyOf>
+ArtTree<Key, Value, KeyOf>::ArtTree(ArtTree&& other) {
+  swap(other);
+}
+
+template <typename Key, typename Value, typename KeyOf>
+ArtTree<Key, Value, KeyOf>& ArtTree<Key, Value, KeyOf>::operator=(
+    const ArtTree& other) {
+  if (this != &other) {
+    ArtTree copy(other);
+    swap(copy);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+ArtTree<Key, Value, KeyOf>& ArtTree<Key, Value, KeyOf>::operator=(
+    ArtTree&& other) {
+  if (this != &other) {
+    clear();
+    swap(other);
+  }
+  return *this;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::clear() {
+  freeTree(root_);
+  root_ = nullptr;
+  head_ = tail_ = nullptr;
+  size_ = 0;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::swap(ArtTree& other) {
+  std::swap(root_, other.root_);
+  std::swap(head_, other.head_);
+  std::swap(tail_, other.tail_);
+  std::swap(size_, other.size_);
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::merge(ArtTree& other) {
+  ArtTree extra;
+  for (Leaf* leaf = other.head_; leaf; leaf = leaf->next) {
+    if (insert(leaf->value).second == false) extra.insert(leaf->value);
+  }
+  other = std::move(extra);
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::iterator ArtTree<Key, Value, KeyOf>::find(
+    const Key& key) const {
+  Buffer buffer;
+  return iterator(findLeaf(Traits::bytes(key, buffer)), this);
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::iterator
+ArtTree<Key, Value, KeyOf>::lower_bound(const Key& key) const {
+  Buffer buffer;
+  Leaf* leaf = root_ ? lowerBoundIn(root_, 0, Traits::bytes(key, buffer))
+                     : nullptr;
+  return iterator(leaf, this);
+}
+
+template <typename Key, typename Value, typename KeyOf>
+std::pair<typename ArtTree<Key, Value, KeyOf>::iterator,
+          typename ArtTree<Key, Value, KeyOf>::iterator>
+ArtTree<Key, Value, KeyOf>::prefix_range(const Key& prefix) const {
+  Buffer buffer;
+  std::string_view bytes = Traits::bytes(prefix, buffer);
+  Node* node = root_;
+  size_type depth = 0;
+  // Find the smallest subtree holding every key that starts with bytes.
+  while (node && node->type != kLeaf) {
+    Inner* inner = static_cast<Inner*>(node);
+    size_type shared = std::min(inner->prefix.size(), bytes.size() - depth);
+    if (bytes.compare(depth, shared, inner->prefix, 0, shared) != 0) {
+      return {end(), end()};
+    }
+    depth += shared;
+    if (depth == bytes.size()) {
+      break;
+    }
+    Node** child = findChild(inner, byteAt(bytes, depth));
+    node = child ? *child : nullptr;
+    ++depth;
+  }
+  if (!node) {
+    return {end(), end()};
+  }
+  if (node->type == kLeaf) {
+    Buffer leaf_buffer;
+    std::string_view leaf = leafBytes(static_cast<Leaf*>(node), leaf_buffer);
+    if (leaf.substr(0, bytes.size()) != bytes) {
+      return {end(), end()};
+    }
+  }
+  return {iterator(minimum(node), this), iterator(maximum(node)->next, this)};
+}
+
+template <typename Key, typename Value, typename KeyOf>
+std::pair<typename ArtTree<Key, Value, KeyOf>::iterator, bool>
+ArtTree<Key, Value, KeyOf>::insert(const value_type& value) {
+  Buffer buffer;
+  std::string_view key = Traits::bytes(KeyOf()(value), buffer);
+
+  // The lower bound is either the key itself or the successor of the new
+  // leaf in the ordered list.
+  Leaf* successor = root_ ? lowerBoundIn(root_, 0, key) : nullptr;
+  if (successor) {
+    Buffer found_buffer;
+    if (leafBytes(successor, found_buffer) == key) {
+      return {iterator(successor, this), false};
+    }
+  }
+
+  Leaf* leaf = new Leaf(value);
+  // Leaf keys may live inside leaf->value (strings): view that copy.
+  key = leafBytes(leaf, buffer);
+  insertLeaf(key, leaf);
+  linkBefore(leaf, successor);
+  ++size_;
+  return {iterator(leaf, this), true};
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::erase(iterator pos) {
+  if (pos.leaf_) {
+    eraseLeaf(pos.leaf_);
+  }
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::size_type
+ArtTree<Key, Value, KeyOf>::erase(const Key& key) {
+  Buffer buffer;
+  Leaf* leaf = findLeaf(Traits::bytes(key, buffer));
+  if (!leaf) {
+    return 0;
+  }
+  eraseLeaf(leaf);
+  return 1;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Leaf*
+ArtTree<Key, Value, KeyOf>::findLeaf(std::string_view key) const {
+  Node* node = root_;
+  size_type depth = 0;
+  while (node) {
+    if (node->type == kLeaf) {
+      Leaf* leaf = static_cast<Leaf*>(node);
+      Buffer buffer;
+      return leafBytes(leaf, buffer) == key ? leaf : nullptr;
+    }
+    Inner* inner = static_cast<Inner*>(node);
+    const std::string& prefix = inner->prefix;
+    if (key.size() - depth < prefix.size() ||
+        key.compare(depth, prefix.size(), prefix) != 0) {
+      return nullptr;
+    }
+    depth += prefix.size();
+    if (depth == key.size()) {
+      return inner->terminal;
+    }
+    Node** child = findChild(inner, byteAt(key, depth));
+    node = child ? *child : nullptr;
+    ++depth;
+  }
+  return nullptr;
+}
+
+// First leaf in the subtree of node whose key is not less than key, or null
+// when the whole subtree is smaller.
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Leaf*
+ArtTree<Key, Value, KeyOf>::lowerBoundIn(Node* node, size_type depth,
+                                         std::string_view key) const {
+  if (node->type == kLeaf) {
+    Leaf* leaf = static_cast<Leaf*>(node);
+    Buffer buffer;
+    return leafBytes(leaf, buffer) >= key ? leaf : nullptr;
+  }
+
+  Inner* inner = static_cast<Inner*>(node);
+  const std::string& prefix = inner->prefix;
+  for (size_type i = 0; i < prefix.size(); ++i) {
+    if (depth + i == key.size()) {
+      // key is a proper prefix of every key below.
+      return minimum(inner);
+    }
+    unsigned char ours = prefix[i];
+    unsigned char theirs = byteAt(key, depth + i);
+    if (ours != theirs) {
+      return ours > theirs ? minimum(inner) : nullptr;
+    }
+  }
+  depth += prefix.size();
+  if (depth == key.size()) {
+    return minimum(inner);
+  }
+
+  // The terminal leaf is a proper prefix of key, hence smaller; skip it.
+  unsigned char byte = byteAt(key, depth);
+  if (Node** child = findChild(inner, byte)) {
+    if (Leaf* found = lowerBoundIn(*child, depth + 1, key)) {
+      return found;
+    }
+  }
+  Node* next = childAfter(inner, byte);
+  return next ? minimum(next) : nullptr;
+}
+
+// Adds a leaf whose key is known to be absent.
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::insertLeaf(std::string_view key, Leaf* leaf) {
+  Node** ref = &root_;
+  size_type depth = 0;
+  while (true) {
+    Node* node = *ref;
+    if (!node) {
+      *ref = leaf;
+      return;
+    }
+
+    if (node->type == kLeaf) {
+      // Lazy expansion ends here: both keys share bytes up to i.
+      Leaf* other = static_cast<Leaf*>(node);
+      Buffer buffer;
+      std::string_view other_key = leafBytes(other, buffer);
+      size_type i = depth;
+      while (i < key.size() && i < other_key.size() &&
+             key[i] == other_key[i]) {
+        ++i;
+      }
+      Node4* split = new Node4;
+      split->prefix.assign(key.data() + depth, i - depth);
+      auto place = [split, i](Leaf* item, std::string_view bytes) {
+        if (bytes.size() == i) {
+          split->terminal = item;
+        } else {
+          insertChild(split, byteAt(bytes, i), item);
+        }
+      };
+      place(other, other_key);
+      place(leaf, key);
+      *ref = split;
+      return;
+    }
+
+    Inner* inner = static_cast<Inner*>(node);
+    std::string& prefix = inner->prefix;
+    size_type matched = 0;
+    while (matched < prefix.size() && depth + matched < key.size() &&
+           prefix[matched] == key[depth + matched]) {
+      ++matched;
+    }
+    if (matched < prefix.size()) {
+      // The key leaves the compressed path: split it at the mismatch.
+      Node4* split = new Node4;
+      split->prefix = prefix.substr(0, matched);
+      unsigned char old_byte = prefix[matched];
+      prefix.erase(0, matched + 1);
+      insertChild(split, old_byte, inner);
+      if (depth + matched == key.size()) {
+        split->terminal = leaf;
+      } else {
+        insertChild(split, byteAt(key, depth + matched), leaf);
+      }
+      *ref = split;
+      return;
+    }
+
+    depth += prefix.size();
+    if (depth == key.size()) {
+      inner->terminal = leaf;
+      return;
+    }
+    Node** child = findChild(inner, byteAt(key, depth));
+    if (!child) {
+      addChild(ref, byteAt(key, depth), leaf);
+      return;
+    }
+    ref = child;
+    ++depth;
+  }
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::eraseLeaf(Leaf* leaf) {
+  Buffer buffer;
+  std::string_view key = leafBytes(leaf, buffer);
+  Node** ref = &root_;
+  Node** parent_ref = nullptr;
+  unsigned char parent_byte = 0;
+  size_type depth = 0;
+  while (*ref != leaf) {
+    Inner* inner = static_cast<Inner*>(*ref);
+    depth += inner->prefix.size();
+    if (depth == key.size()) {
+      inner->terminal = nullptr;
+      compact(ref);
+      break;
+    }
+    parent_ref = ref;
+    parent_byte = byteAt(key, depth);
+    ref = findChild(inner, parent_byte);
+    ++depth;
+  }
+  if (*ref == leaf) {
+    if (parent_ref) {
+      removeChild(static_cast<Inner*>(*parent_ref), parent_byte);
+      compact(parent_ref);
+    } else {
+      root_ = nullptr;
+    }
+  }
+
+  (leaf->prev ? leaf->prev->next : head_) = leaf->next;
+  (leaf->next ? leaf->next->prev : tail_) = leaf->prev;
+  delete leaf;
+  --size_;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::linkBefore(Leaf* leaf, Leaf* successor) {
+  leaf->next = successor;
+  leaf->prev = successor ? successor->prev : tail_;
+  (leaf->prev ? leaf->prev->next : head_) = leaf;
+  (successor ? successor->prev : tail_) = leaf;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+unsigned char* ArtTree<Key, Value, KeyOf>::sortedKeys(const Inner* node) {
+  Inner* inner = const_cast<Inner*>(node);
+  return node->type == kNode4 ? static_cast<Node4*>(inner)->keys
+                              : static_cast<Node16*>(inner)->keys;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Node**
+ArtTree<Key, Value, KeyOf>::sortedChildren(const Inner* node) {
+  Inner* inner = const_cast<Inner*>(node);
+  return node->type == kNode4 ? static_cast<Node4*>(inner)->children
+                              : static_cast<Node16*>(inner)->children;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Node**
+ArtTree<Key, Value, KeyOf>::findChild(Inner* node, unsigned char byte) {
+  switch (node->type) {
+    case kNode4:
+    case kNode16: {
+      unsigned char* keys = sortedKeys(node);
+      for (int i = 0; i < node->count && keys[i] <= byte; ++i) {
+        if (keys[i] == byte) return &sortedChildren(node)[i];
+      }
+      return nullptr;
+    }
+    case kNode48: {
+      auto* indexed = static_cast<Node48*>(node);
+      int slot = indexed->index[byte];
+      return slot ? &indexed->children[slot - 1] : nullptr;
+    }
+    default: {
+      auto* direct = static_cast<Node256*>(node);
+      return direct->children[byte] ? &direct->children[byte] : nullptr;
+    }
+  }
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Node*
+ArtTree<Key, Value, KeyOf>::childAfter(const Inner* node, int after,
+                                       int* byte) {
+  int found = -1;
+  Node* child = nullptr;
+  switch (node->type) {
+    case kNode4:
+    case kNode16: {
+      unsigned char* keys = sortedKeys(node);
+      for (int i = 0; i < node->count && !child; ++i) {
+        if (keys[i] > after) {
+          found = keys[i];
+          child = sortedChildren(node)[i];
+        }
+      }
+      break;
+    }
+    case kNode48: {
+      auto* indexed = static_cast<const Node48*>(node);
+      for (int b = after + 1; b < 256 && !child; ++b) {
+        if (indexed->index[b]) {
+          found = b;
+          child = indexed->children[indexed->index[b] - 1];
+        }
+      }
+      break;
+    }
+    default: {
+      auto* direct = static_cast<const Node256*>(node);
+      for (int b = after + 1; b < 256 && !child; ++b) {
+        if (direct->children[b]) {
+          found = b;
+          child = direct->children[b];
+        }
+      }
+    }
+  }
+  if (byte) *byte = found;
+  return child;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Node*
+ArtTree<Key, Value, KeyOf>::lastChild(const Inner* node) {
+  switch (node->type) {
+    case kNode4:
+    case kNode16: {
+      return node->count ? sortedChildren(node)[node->count - 1] : nullptr;
+    }
+    case kNode48: {
+      auto* indexed = static_cast<const Node48*>(node);
+      for (int b = 255; b >= 0; --b) {
+        if (indexed->index[b]) return indexed->children[indexed->index[b] - 1];
+      }
+      return nullptr;
+    }
+    default: {
+      auto* direct = static_cast<const Node256*>(node);
+      for (int b = 255; b >= 0; --b) {
+        if (direct->children[b]) return direct->children[b];
+      }
+      return nullptr;
+    }
+  }
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Leaf* ArtTree<Key, Value, KeyOf>::minimum(
+    Node* node) {
+  while (node->type != kLeaf) {
+    Inner* inner = static_cast<Inner*>(node);
+    if (inner->terminal) {
+      return inner->terminal;
+    }
+    node = childAfter(inner, -1);
+  }
+  return static_cast<Leaf*>(node);
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Leaf* ArtTree<Key, Value, KeyOf>::maximum(
+    Node* node) {
+  while (node->type != kLeaf) {
+    Inner* inner = static_cast<Inner*>(node);
+    if (!inner->count) {
+      return inner->terminal;
+    }
+    node = lastChild(inner);
+  }
+  return static_cast<Leaf*>(node);
+}
+
+// Assumes the node has room.
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::insertChild(Inner* node, unsigned char byte,
+                                             Node* child) {
+  switch (node->type) {
+    case kNode4:
+    case kNode16: {
+      unsigned char* keys = sortedKeys(node);
+      Node** children = sortedChildren(node);
+      int pos = node->count;
+      for (; pos > 0 && keys[pos - 1] > byte; --pos) {
+        keys[pos] = keys[pos - 1];
+        children[pos] = children[pos - 1];
+      }
+      keys[pos] = byte;
+      children[pos] = child;
+      break;
+    }
+    case kNode48: {
+      auto* indexed = static_cast<Node48*>(node);
+      int slot = 0;
+      while (indexed->children[slot]) ++slot;
+      indexed->children[slot] = child;
+      indexed->index[byte] = static_cast<unsigned char>(slot + 1);
+      break;
+    }
+    default:
+      static_cast<Node256*>(node)->children[byte] = child;
+  }
+  ++node->count;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::addChild(Node** ref, unsigned char byte,
+                                          Node* child) {
+  Inner* node = static_cast<Inner*>(*ref);
+  constexpr int kCapacity[] = {0, 4, 16, 48, 256};
+  if (node->count == kCapacity[node->type]) {
+    node = grow(node);
+    *ref = node;
+  }
+  insertChild(node, byte, child);
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::removeChild(Inner* node, unsigned char byte) {
+  switch (node->type) {
+    case kNode4:
+    case kNode16: {
+      unsigned char* keys = sortedKeys(node);
+      Node** children = sortedChildren(node);
+      int pos = 0;
+      while (keys[pos] != byte) ++pos;
+      for (; pos + 1 < node->count; ++pos) {
+        keys[pos] = keys[pos + 1];
+        children[pos] = children[pos + 1];
+      }
+      break;
+    }
+    case kNode48: {
+      auto* indexed = static_cast<Node48*>(node);
+      indexed->children[indexed->index[byte] - 1] = nullptr;
+      indexed->index[byte] = 0;
+      break;
+    }
+    default:
+      static_cast<Node256*>(node)->children[byte] = nullptr;
+  }
+  --node->count;
+}
+
+// Moves prefix, terminal and children of node into a new Target node and
+// frees node.
+template <typename Key, typename Value, typename KeyOf>
+template <typename Target>
+Target* ArtTree<Key, Value, KeyOf>::copyInto(Inner* node) {
+  Target* result = new Target;
+  result->prefix = std::move(node->prefix);
+  result->terminal = node->terminal;
+  int byte = -1;
+  while (Node* child = childAfter(node, byte, &byte)) {
+    insertChild(result, static_cast<unsigned char>(byte), child);
+  }
+  freeNode(node);
+  return result;
+}
+
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Inner* ArtTree<Key, Value, KeyOf>::grow(
+    Inner* node) {
+  switch (node->type) {
+    case kNode4:
+      return copyInto<Node16>(node);
+    case kNode16:
+      return copyInto<Node48>(node);
+    default:
+      return copyInto<Node256>(node);
+  }
+}
+
+// Steps down one size once the fan-out falls well below the smaller
+// capacity, so a node at the boundary does not flip on every update.
+template <typename Key, typename Value, typename KeyOf>
+typename ArtTree<Key, Value, KeyOf>::Inner* ArtTree<Key, Value, KeyOf>::shrink(
+    Inner* node) {
+  if (node->type == kNode256 && node->count <= 40) {
+    return copyInto<Node48>(node);
+  }
+  if (node->type == kNode48 && node->count <= 12) {
+    return copyInto<Node16>(node);
+  }
+  if (node->type == kNode16 && node->count <= 3) {
+    return copyInto<Node4>(node);
+  }
+  return node;
+}
+
+// Restores the shape invariants after a removal below *ref: an inner node
+// needs a terminal leaf or two children; a single child absorbs the node's
+// prefix.
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::compact(Node** ref) {
+  Inner* node = static_cast<Inner*>(*ref);
+  if (node->count == 0) {
+    *ref = node->terminal;
+    freeNode(node);
+  } else if (node->count == 1 && !node->terminal) {
+    int byte = -1;
+    Node* child = childAfter(node, -1, &byte);
+    if (child->type != kLeaf) {
+      Inner* inner = static_cast<Inner*>(child);
+      inner->prefix = node->prefix + static_cast<char>(byte) + inner->prefix;
+    }
+    *ref = child;
+    freeNode(node);
+  } else {
+    *ref = shrink(node);
+  }
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::freeNode(Node* node) {
+  switch (node->type) {
+    case kLeaf:
+      delete static_cast<Leaf*>(node);
+      break;
+    case kNode4:
+      delete static_cast<Node4*>(node);
+      break;
+    case kNode16:
+      delete static_cast<Node16*>(node);
+      break;
+    case kNode48:
+      delete static_cast<Node48*>(node);
+      break;
+    default:
+      delete static_cast<Node256*>(node);
+  }
+}
+
+template <typename Key, typename Value, typename KeyOf>
+void ArtTree<Key, Value, KeyOf>::freeTree(Node* node) {
+  if (!node) {
+    return;
+  }
+  if (node->type != kLeaf) {
+    Inner* inner = static_cast<Inner*>(node);
+    freeTree(inner->terminal);
+    int byte = -1;
+    while (Node* child = childAfter(inner, byte, &byte)) {
+      freeTree(child);
+    }
+  }
+  freeNode(node);
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,284 @@
+#include <algorithm>
+
+#ifndef balance_h
+#define balance_h
+
+namespace s21 {
+
+// Balancing policies for RBTree. The tree does the structural part of an
+// insert or erase and then calls the policy, which restores its invariant
+// with the tree's rotations:
+//
+//   afterInsert(tree, node)   node was just linked in as a leaf.
+//   afterErase(tree, x, parent, removed_color)
+//                             a node with at most one child was spliced out
+//                             from under parent and replaced by x (possibly
+//                             null); removed_color was its color.
+//
+// Every node carries a color and a small rank; a policy uses whichever it
+// needs. kUsesColor tells the tree whether bulk builds must paint colors.
+// A kSelfAdjusting policy also gets afterAccess(tree, node) for the node a
+// lookup ended on.
+
+// Red-black: height <= 2 log2(n + 1), at most 2 rotations per insert and
+// 3 per erase.
+struct rb_balance {
+  static constexpr bool kUsesColor = true;
+  static constexpr bool kSelfAdjusting = false;
+
+  template <typename Tree, typename Node>
+  static void afterInsert(Tree& tree, Node* node) {
+    tree.fixInsertion(node);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterErase(Tree& tree, Node* x, Node* parent,
+                         typename Node::Color removed_color) {
+    if (removed_color == Node::BLACK) {
+      tree.deleteFixup(x, parent);
+    }
+  }
+};
+
+// AVL: rank is the subtree height and sibling heights differ by at most
+// one, so height <= 1.44 log2(n + 2). Lookups visit fewer levels than in a
+// red-black tree; erase may rotate at every level on the way up.
+struct avl_balance {
+  static constexpr bool kUsesColor = false;
+  static constexpr bool kSelfAdjusting = false;
+
+  template <typename Tree, typename Node>
+  static void afterInsert(Tree& tree, Node* node) {
+    node->color = Node::BLACK;
+    retrace(tree, node->parent);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterErase(Tree& tree, Node*, Node* parent,
+                         typename Node::Color) {
+    retrace(tree, parent);
+  }
+
+ private:
+  template <typename Node>
+  static int height(const Node* node) {
+    return node ? node->rank : 0;
+  }
+
+  template <typename Node>
+  static void update(Node* node) {
+    node->rank = 1 + std::max(height(node->left), height(node->right));
+  }
+
+  // Walks up from node and stops once a subtree keeps its old height: the
+  // heights above it cannot have changed.
+  template <typename Tree, typename Node>
+  static void retrace(Tree& tree, Node* node) {
+    while (node) {
+      int old_height = node->rank;
+      Node* top = rebalance(tree, node);
+      if (top->rank == old_height) {
+        break;
+      }
+      node = top->parent;
+    }
+  }
+
+  // Returns the root of the subtree after at most a double rotation.
+  template <typename Tree, typename Node>
+  static Node* rebalance(Tree& tree, Node* node) {
+    update(node);
+    int balance = height(node->left) - height(node->right);
+    if (balance > 1) {
+      if (height(node->left->left) < height(node->left->right)) {
+        rotateLeft(tree, node->left);
+      }
+      return rotateRight(tree, node);
+    }
+    if (balance < -1) {
+      if (height(node->right->right) < height(node->right->left)) {
+        rotateRight(tree, node->right);
+      }
+      return rotateLeft(tree, node);
+    }
+    return node;
+  }
+
+  template <typename Tree, typename Node>
+  static Node* rotateLeft(Tree& tree, Node* node) {
+    Node* top = node->right;
+    tree.leftRotate(node);
+    update(node);
+    update(top);
+    return top;
+  }
+
+  template <typename Tree, typename Node>
+  static Node* rotateRight(Tree& tree, Node* node) {
+    Node* top = node->left;
+    tree.rightRotate(node);
+    update(node);
+    update(top);
+    return top;
+  }
+};
+
+// Weak AVL (Haeupler, Sen, Tarjan): every rank difference is 1 or 2 and
+// leaves have rank 1 (null counts as 0). Without erases the tree is an AVL
+// tree; with them height stays <= 2 log2(n + 1). Both insert and erase do
+// at most 2 rotations, and the rank updates they trigger are amortized O(1).
+struct wavl_balance {
+  static constexpr bool kUsesColor = false;
+  static constexpr bool kSelfAdjusting = false;
+
+  template <typename Tree, typename Node>
+  static void afterInsert(Tree& tree, Node* x);
+
+  template <typename Tree, typename Node>
+  static void afterErase(Tree& tree, Node* x, Node* parent,
+                         typename Node::Color);
+
+ private:
+  template <typename Node>
+  static int rank(const Node* node) {
+    return node ? node->rank : 0;
+  }
+};
+
+// Fixes a 0-child (a node as high as its parent): promote the parent while
+// the sibling is a 1-child, else one single or double rotation ends it.
+template <typename Tree, typename Node>
+void wavl_balance::afterInsert(Tree& tree, Node* x) {
+  x->color = Node::BLACK;
+  for (Node* p = x->parent; p && p->rank == x->rank; p = x->parent) {
+    Node* sibling = p->left == x ? p->right : p->left;
+    if (p->rank - rank(sibling) == 1) {
+      ++p->rank;
+      x = p;
+      continue;
+    }
+    if (x == p->left) {
+      Node* inner = x->right;
+      if (x->rank - rank(inner) == 2) {
+        tree.rightRotate(p);
+        --p->rank;
+      } else {
+        tree.leftRotate(x);
+        tree.rightRotate(p);
+        ++inner->rank;
+        --x->rank;
+        --p->rank;
+      }
+    } else {
+      Node* inner = x->left;
+      if (x->rank - rank(inner) == 2) {
+        tree.leftRotate(p);
+        --p->rank;
+      } else {
+        tree.rightRotate(x);
+        tree.leftRotate(p);
+        ++inner->rank;
+        --x->rank;
+        --p->rank;
+      }
+    }
+    break;
+  }
+}
+
+// Fixes a leaf left with rank 2 and then a 3-child: demote the parent (and
+// a 2,2 sibling) while that suffices, else one single or double rotation
+// ends it.
+template <typename Tree, typename Node>
+void wavl_balance::afterErase(Tree& tree, Node* x, Node* p,
+                              typename Node::Color) {
+  if (p && !p->left && !p->right && p->rank == 2) {
+    p->rank = 1;
+    x = p;
+    p = p->parent;
+  }
+  while (p && p->rank - rank(x) == 3) {
+    bool x_left = p->left == x;  // the sibling of a 3-child is never null
+    Node* y = x_left ? p->right : p->left;
+    if (p->rank - y->rank == 2) {
+      --p->rank;
+    } else if (y->rank - rank(y->left) == 2 && y->rank - rank(y->right) == 2) {
+      --p->rank;
+      --y->rank;
+    } else {
+      Node* inner = x_left ? y->left : y->right;
+      Node* outer = x_left ? y->right : y->left;
+      if (y->rank - rank(outer) == 1) {
+        x_left ? tree.leftRotate(p) : tree.rightRotate(p);
+        ++y->rank;
+        --p->rank;
+        if (!p->left && !p->right) {
+          --p->rank;
+        }
+      } else {
+        x_left ? tree.rightRotate(y) : tree.leftRotate(y);
+        x_left ? tree.leftRotate(p) : tree.rightRotate(p);
+        inner->rank += 2;
+        --y->rank;
+        p->rank -= 2;
+      }
+      return;
+    }
+    x = p;
+    p = p->parent;
+  }
+}
+
+// Splay (Sleator, Tarjan): every insert, erase and find rotates the node it
+// touched to the root. There is no height bound, but any access sequence
+// costs amortized O(log n) per operation, and a key accessed again soon is
+// found near the root. Skewed workloads therefore visit fewer levels than
+// in any balanced tree.
+//
+// Because find() restructures the tree, a splay tree only offers lookups
+// on a non-const container; lock around them as around writes.
+struct splay_balance {
+  static constexpr bool kUsesColor = false;
+  static constexpr bool kSelfAdjusting = true;
+
+  template <typename Tree, typename Node>
+  static void afterInsert(Tree& tree, Node* node) {
+    node->color = Node::BLACK;
+    splay(tree, node);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterErase(Tree& tree, Node*, Node* parent,
+                         typename Node::Color) {
+    if (parent) splay(tree, parent);
+  }
+
+  template <typename Tree, typename Node>
+  static void afterAccess(Tree& tree, Node* node) {
+    splay(tree, node);
+  }
+
+ private:
+  // Zig-zig rotates the grandparent first, which is what halves the depth
+  // of the whole access path instead of just moving x up.
+  template <typename Tree, typename Node>
+  static void splay(Tree& tree, Node* x) {
+    while (Node* p = x->parent) {
+      Node* g = p->parent;
+      bool x_left = p->left == x;
+      if (!g) {
+        x_left ? tree.rightRotate(p) : tree.leftRotate(p);
+      } else if (x_left == (g->left == p)) {
+        x_left ? tree.rightRotate(g) : tree.leftRotate(g);
+        x_left ? tree.rightRotate(p) : tree.leftRotate(p);
+      } else {
+        x_left ? tree.rightRotate(p) : tree.leftRotate(p);
+        x_left ? tree.leftRotate(g) : tree.rightRotate(g);
+      }
+    }
+  }
+};
+
+}  // namespace s21
+
+#endif
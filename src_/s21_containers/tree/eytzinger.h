@@ -0,0 +1,255 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "prefetch.h"
+
+#ifndef eytzinger_h
+#define eytzinger_h
+
+namespace s21 {
+
+// On-disk and in-memory image of a frozen container:
+//   FrozenHeader, padded to kFrozenAlignment
+//   keys   in Eytzinger (BFS) order, slots 1..count, slot 0 unused
+//   values in the same slot order (absent for sets)
+// The image is used as is in both places, so a mapped file needs no
+// deserialization.
+struct FrozenHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t key_size;
+  std::uint32_t value_size;
+  std::uint64_t count;
+  std::uint64_t keys_offset;
+  std::uint64_t values_offset;
+};
+
+constexpr char kFrozenMagic[4] = {'S', '2', '1', 'F'};
+constexpr std::uint32_t kFrozenVersion = 1;
+constexpr std::size_t kFrozenAlignment = 64;
+
+inline std::size_t alignFrozen(std::size_t offset) {
+  return (offset + kFrozenAlignment - 1) / kFrozenAlignment * kFrozenAlignment;
+}
+
+inline unsigned trailingOnes(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return value == ~std::uint64_t(0) ? 64 : __builtin_ctzll(~value);
+#else
+  unsigned count = 0;
+  while (value & 1) {
+    value >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+// Sorted keys laid out as an implicit binary search tree: the children of
+// slot k are 2k and 2k + 1. The top levels share a few cache lines, and the
+// descent is a fixed-shape loop with no data-dependent branch.
+template <typename Key>
+class EytzingerTable {
+  static_assert(std::is_trivially_copyable<Key>::value,
+                "frozen containers store keys as raw bytes");
+
+ public:
+  using size_type = std::size_t;
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  bool contains(const Key& key) const { return findSlot(key) != 0; }
+
+ protected:
+  // Returns the slot holding key, or 0 when it is absent.
+  size_type findSlot(const Key& key) const;
+
+  // Builds an owned image from count sorted unique keys; values (if any)
+  // are value_size bytes each, in the same order as keys.
+  void build(const Key* keys, const char* values, std::size_t value_size,
+             size_type count);
+  void adopt(std::shared_ptr<const char> image, std::size_t image_size,
+             std::size_t value_size);
+  void saveImage(const std::string& path) const;
+  static std::shared_ptr<const char> mapFile(const std::string& path,
+                                             std::size_t& image_size);
+
+  const char* valuesBase() const {
+    return image_.get() + header().values_offset;
+  }
+
+ private:
+  static constexpr size_type kPrefetchStride =
+      sizeof(Key) >= kFrozenAlignment ? 1 : kFrozenAlignment / sizeof(Key);
+
+  const FrozenHeader& header() const {
+    return *reinterpret_cast<const FrozenHeader*>(image_.get());
+  }
+  static void fillSlots(size_type slot, size_type count,
+                        std::vector<size_type>& order, size_type& next);
+
+  std::shared_ptr<const char> image_;
+  std::size_t image_size_ = 0;
+  const Key* keys_ = nullptr;
+  size_type size_ = 0;
+};
+
+template <typename Key>
+typename EytzingerTable<Key>::size_type EytzingerTable<Key>::findSlot(
+    const Key& key) const {
+  size_type slot = 1;
+  while (slot <= size_) {
+    // Four levels below `slot` sit in one cache line; fetch it early.
+    prefetchNode(keys_ + slot * kPrefetchStride);
+    slot = 2 * slot + (keys_[slot] < key);
+  }
+  // The walk ended past a leaf; drop the trailing right turns and the last
+  // left turn to land on the lower bound.
+  slot >>= trailingOnes(slot) + 1;
+  return slot != 0 && !(key < keys_[slot]) ? slot : 0;
+}
+
+template <typename Key>
+void EytzingerTable<Key>::fillSlots(size_type slot, size_type count,
+                                    std::vector<size_type>& order,
+                                    size_type& next) {
+  if (slot > count) {
+    return;
+  }
+  fillSlots(2 * slot, count, order, next);
+  order[slot] = next++;
+  fillSlots(2 * slot + 1, count, order, next);
+}
+
+template <typename Key>
+void EytzingerTable<Key>::build(const Key* keys, const char* values,
+                                std::size_t value_size, size_type count) {
+  FrozenHeader header = {};
+  std::memcpy(header.magic, kFrozenMagic, sizeof(header.magic));
+  header.version = kFrozenVersion;
+  header.key_size = sizeof(Key);
+  header.value_size = static_cast<std::uint32_t>(value_size);
+  header.count = count;
+  header.keys_offset = alignFrozen(sizeof(FrozenHeader));
+  header.values_offset =
+      alignFrozen(header.keys_offset + (count + 1) * sizeof(Key));
+  std::size_t image_size = header.values_offset + (count + 1) * value_size;
+
+  char* image = static_cast<char*>(
+      ::operator new(image_size, std::align_val_t(kFrozenAlignment)));
+  std::shared_ptr<const char> owner(image, [](const char* bytes) {
+    ::operator delete(const_cast<char*>(bytes),
+                      std::align_val_t(kFrozenAlignment));
+  });
+  std::memset(image, 0, image_size);
+  std::memcpy(image, &header, sizeof(header));
+
+  std::vector<size_type> order(count + 1);
+  size_type next = 0;
+  fillSlots(1, count, order, next);
+  for (size_type slot = 1; slot <= count; ++slot) {
+    std::memcpy(image + header.keys_offset + slot * sizeof(Key),
+                keys + order[slot], sizeof(Key));
+    if (value_size) {
+      std::memcpy(image + header.values_offset + slot * value_size,
+                  values + order[slot] * value_size, value_size);
+    }
+  }
+
+  adopt(std::move(owner), image_size, value_size);
+}
+
+// Checks the header against this instantiation and points into the image.
+template <typename Key>
+void EytzingerTable<Key>::adopt(std::shared_ptr<const char> image,
+                                std::size_t image_size,
+                                std::size_t value_size) {
+  if (image_size < sizeof(FrozenHeader)) {
+    throw std::runtime_error("frozen: image too small");
+  }
+  const auto* header = reinterpret_cast<const FrozenHeader*>(image.get());
+  if (std::memcmp(header->magic, kFrozenMagic, sizeof(header->magic)) != 0 ||
+      header->version != kFrozenVersion) {
+    throw std::runtime_error("frozen: bad header");
+  }
+  if (header->key_size != sizeof(Key) || header->value_size != value_size) {
+    throw std::runtime_error("frozen: key or value size mismatch");
+  }
+  if (header->keys_offset % kFrozenAlignment != 0 ||
+      header->values_offset % kFrozenAlignment != 0 ||
+      header->keys_offset < sizeof(FrozenHeader) ||
+      header->values_offset < header->keys_offset ||
+      header->values_offset > image_size) {
+    throw std::runtime_error("frozen: bad section offsets");
+  }
+  // Slots 0..count must fit; dividing the room instead of multiplying the
+  // count keeps a corrupt count from wrapping around.
+  std::uint64_t key_slots =
+      (header->values_offset - header->keys_offset) / sizeof(Key);
+  std::uint64_t value_slots =
+      value_size ? (image_size - header->values_offset) / value_size
+                 : key_slots;
+  if (header->count >= key_slots || header->count >= value_slots) {
+    throw std::runtime_error("frozen: truncated image");
+  }
+
+  image_ = std::move(image);
+  image_size_ = image_size;
+  keys_ = reinterpret_cast<const Key*>(image_.get() + header->keys_offset);
+  size_ = header->count;
+}
+
+template <typename Key>
+void EytzingerTable<Key>::saveImage(const std::string& path) const {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (image_) {
+    file.write(image_.get(), image_size_);
+  }
+  if (!file) {
+    throw std::runtime_error("frozen: cannot write " + path);
+  }
+}
+
+// Maps the file read-only and shared, so every process that opens the same
+// file reads one copy from the page cache.
+template <typename Key>
+std::shared_ptr<const char> EytzingerTable<Key>::mapFile(
+    const std::string& path, std::size_t& image_size) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("frozen: cannot open " + path);
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+    ::close(fd);
+    throw std::runtime_error("frozen: cannot stat " + path);
+  }
+  image_size = static_cast<std::size_t>(info.st_size);
+  void* address = ::mmap(nullptr, image_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    throw std::runtime_error("frozen: cannot map " + path);
+  }
+
+  std::size_t length = image_size;
+  return std::shared_ptr<const char>(
+      static_cast<const char*>(address), [length](const char* bytes) {
+        ::munmap(const_cast<char*>(bytes), length);
+      });
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,951 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "prefetch.h"
+#include "three_way.h"
+
+#ifndef index_tree_h
+#define index_tree_h
+
+namespace s21 {
+
+// Red-black tree whose nodes link to each other through 32-bit indices. Slots
+// come from a handful of chunks that double in size as the tree grows, so
+// most of a large tree is contiguous. Chunks never move and erased slots go
+// on a free list for later inserts. The chunk table lives on the heap and
+// iterators point at it, not at the tree: as with node storage, iterators
+// and references stay valid until their own element is erased, also across
+// moves and swaps of the tree.
+template <typename T, typename Compare = std::less<T>>
+class IndexRBTree {
+ public:
+  class Node;
+  class Segment;
+
+  template <bool IsConst>
+  class IndexRBTreeIteratorBase;
+
+  using value_type = T;
+  using iterator = IndexRBTreeIteratorBase<false>;
+  using const_iterator = IndexRBTreeIteratorBase<true>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using index_type = std::uint32_t;
+
+  static constexpr index_type kNil = std::numeric_limits<index_type>::max();
+
+ protected:
+  // Raw storage for one node; the node is built in place on insert and
+  // destroyed on erase, when the slot holds the next free index instead.
+  struct Slot;
+  // The chunks and the root. A move or swap hands the table over whole.
+  struct Table {
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    index_type root = kNil;
+  };
+
+  std::unique_ptr<Table> table_;
+  index_type used_ = 0;     // slots handed out so far, free or not
+  index_type free_ = kNil;  // head of the free list
+  size_type size_ = 0;
+  Compare comparator_ = Compare();
+
+ public:
+  IndexRBTree();
+  IndexRBTree(std::initializer_list<value_type> const& items);
+  IndexRBTree(const IndexRBTree& other);
+  IndexRBTree(IndexRBTree&& other);
+
+  IndexRBTree& operator=(const IndexRBTree& other);
+  IndexRBTree& operator=(IndexRBTree&& other);
+
+  ~IndexRBTree() { destroyNodes(); }
+
+  iterator begin() const;
+  iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type& value);
+  void erase(iterator pos);
+  void swap(IndexRBTree& other);
+  void merge(IndexRBTree& other);
+
+  iterator find(const T& key) const;
+  bool contains(const T& key) const;
+
+  template <typename Keys, typename OutputIt>
+  OutputIt find_many(const Keys& keys, OutputIt out) const;
+  template <typename Keys, typename OutputIt>
+  OutputIt contains_many(const Keys& keys, OutputIt out) const;
+
+  std::vector<Segment> segments(size_type max_count) const;
+
+ protected:
+  template <typename K>
+  iterator findKey(const K& key) const;
+  template <typename RandomIt>
+  void buildFromSorted(RandomIt first, RandomIt last, unsigned threads = 1);
+
+ private:
+  static constexpr std::size_t kSearchLanes = 16;
+  // Chunk c holds 2^(kFirstChunkBits + c) slots.
+  static constexpr unsigned kFirstChunkBits = 4;
+  // A red-black tree of 2^32 nodes is at most 64 levels deep.
+  static constexpr std::size_t kMaxDepth = 64;
+
+  static unsigned char* slot(const Table& table, index_type index);
+  unsigned char* slot(index_type index) const { return slot(*table_, index); }
+  // The object in a slot was built with placement new into raw storage.
+  static Node& node(const Table& table, index_type index) {
+    return *std::launder(reinterpret_cast<Node*>(slot(table, index)));
+  }
+  Node& node(index_type index) { return node(*table_, index); }
+  const Node& node(index_type index) const { return node(*table_, index); }
+  index_type allocateSlot();
+  void releaseSlot(index_type index);
+  template <typename Fn>
+  void forEachNode(Fn fn) const;
+  void destroyNodes();
+  void copyFrom(const IndexRBTree& other);
+  index_type linkSorted(index_type first, size_type count, int depth,
+                        int red_depth, index_type parent);
+  void splitSegments(index_type index, int depth,
+                     std::vector<Segment>& result) const;
+
+  template <typename Keys, typename Visitor>
+  void lockstepSearch(const Keys& keys, Visitor visit) const;
+
+  void fixInsertion(index_type node);
+  void leftRotate(index_type node);
+  void rightRotate(index_type node);
+
+  void transplant(index_type u, index_type v);
+  void deleteFixup(index_type x, index_type x_parent);
+  bool isBlack(index_type node) const;
+  bool isRed(index_type node) const;
+};
+
+template <typename T, typename Compare>
+class IndexRBTree<T, Compare>::Node {
+ public:
+  enum Color : std::uint8_t { RED, BLACK };
+
+  T data;
+  index_type parent;
+  index_type left;
+  index_type right;
+  Color color;
+
+  Node(const T& val)
+      : data(val), parent(kNil), left(kNil), right(kNil), color(Color::RED) {}
+};
+
+template <typename T, typename Compare>
+struct IndexRBTree<T, Compare>::Slot {
+  alignas(Node) unsigned char bytes[sizeof(Node)];
+};
+
+// One element, or a whole subtree walked in order; see RBTree::Segment.
+template <typename T, typename Compare>
+class IndexRBTree<T, Compare>::Segment {
+ public:
+  Segment(const Table* table, index_type index, bool whole_subtree)
+      : table_(table), index_(index), whole_subtree_(whole_subtree) {}
+
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    if (!whole_subtree_) {
+      fn(node(*table_, index_).data);
+      return;
+    }
+    index_type stack[kMaxDepth];
+    std::size_t depth = 0;
+    index_type current = index_;
+    while (current != kNil || depth > 0) {
+      while (current != kNil) {
+        stack[depth++] = current;
+        current = node(*table_, current).left;
+      }
+      current = stack[--depth];
+      fn(node(*table_, current).data);
+      current = node(*table_, current).right;
+    }
+  }
+
+ private:
+  const Table* table_;
+  index_type index_;
+  bool whole_subtree_;
+};
+
+template <typename T, typename Compare>
+template <bool IsConst>
+class IndexRBTree<T, Compare>::IndexRBTreeIteratorBase {
+  friend IndexRBTree;
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = std::conditional_t<IsConst, const T, T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = value_type*;
+  using reference = value_type&;
+
+  IndexRBTreeIteratorBase(const Table* table = nullptr,
+                          index_type index = kNil)
+      : table_(table), current_(index) {}
+
+  IndexRBTreeIteratorBase& operator++() {
+    if (node(current_).right != kNil) {
+      current_ = node(current_).right;
+      while (node(current_).left != kNil) {
+        current_ = node(current_).left;
+      }
+    } else {
+      index_type temp = node(current_).parent;
+      while (temp != kNil && current_ == node(temp).right) {
+        current_ = temp;
+        temp = node(temp).parent;
+      }
+      current_ = temp;
+    }
+    return *this;
+  }
+
+  IndexRBTreeIteratorBase operator++(int) {
+    IndexRBTreeIteratorBase tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  IndexRBTreeIteratorBase& operator--() {
+    if (current_ == kNil) {
+      current_ = table_->root;
+      while (current_ != kNil && node(current_).right != kNil) {
+        current_ = node(current_).right;
+      }
+    } else if (node(current_).left != kNil) {
+      current_ = node(current_).left;
+      while (node(current_).right != kNil) {
+        current_ = node(current_).right;
+      }
+    } else {
+      index_type temp = node(current_).parent;
+      while (temp != kNil && current_ == node(temp).left) {
+        current_ = temp;
+        temp = node(temp).parent;
+      }
+      current_ = temp;
+    }
+    return *this;
+  }
+
+  IndexRBTreeIteratorBase operator--(int) {
+    IndexRBTreeIteratorBase tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  reference operator*() { return node(current_).data; }
+
+  pointer operator->() { return &node(current_).data; }
+
+  bool operator==(const IndexRBTreeIteratorBase& other) const {
+    return current_ == other.current_;
+  }
+
+  bool operator!=(const IndexRBTreeIteratorBase& other) const {
+    return current_ != other.current_;
+  }
+
+ private:
+  Node& node(index_type index) const {
+    return IndexRBTree::node(*table_, index);
+  }
+
+  const Table* table_;
+  index_type current_;
+};
+
+template <typename T, typename Compare>
+IndexRBTree<T, Compare>::IndexRBTree() : table_(std::make_unique<Table>()) {}
+
+template <typename T, typename Compare>
+IndexRBTree<T, Compare>::IndexRBTree(
+    std::initializer_list<value_type> const& items)
+    : IndexRBTree() {
+  for (const auto& i : items) {
+    insert(i);
+  }
+}
+
+template <typename T, typename Compare>
+IndexRBTree<T, Compare>::IndexRBTree(const IndexRBTree& other)
+    : table_(std::make_unique<Table>()), comparator_(other.comparator_) {
+  copyFrom(other);
+}
+
+template <typename T, typename Compare>
+IndexRBTree<T, Compare>::IndexRBTree(IndexRBTree&& other)
+    : IndexRBTree() {
+  swap(other);
+}
+
+template <typename T, typename Compare>
+IndexRBTree<T, Compare>& IndexRBTree<T, Compare>::operator=(
+    const IndexRBTree& other) {
+  if (this != &other) {
+    IndexRBTree copy(other);
+    swap(copy);
+  }
+  return *this;
+}
+
+template <typename T, typename Compare>
+IndexRBTree<T, Compare>& IndexRBTree<T, Compare>::operator=(
+    IndexRBTree&& other) {
+  if (this != &other) {
+    clear();
+    swap(other);
+  }
+  return *this;
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::clear() {
+  destroyNodes();
+  table_->chunks.clear();
+  table_->root = kNil;
+  used_ = 0;
+  free_ = kNil;
+  size_ = 0;
+}
+
+template <typename T, typename Compare>
+bool IndexRBTree<T, Compare>::empty() const {
+  return size_ == 0;
+}
+
+template <typename T, typename Compare>
+typename IndexRBTree<T, Compare>::size_type IndexRBTree<T, Compare>::size()
+    const {
+  return size_;
+}
+
+template <typename T, typename Compare>
+typename IndexRBTree<T, Compare>::size_type IndexRBTree<T, Compare>::max_size()
+    const {
+  return kNil - 1;
+}
+
+// Chunk c starts at slot (2^c - 1) << kFirstChunkBits. The + 1 keeps
+// scaled at 1 or more for index 0 too, which __builtin_clzll needs.
+template <typename T, typename Compare>
+unsigned char* IndexRBTree<T, Compare>::slot(const Table& table,
+                                             index_type index) {
+  std::uint64_t scaled = (std::uint64_t(index) >> kFirstChunkBits) + 1;
+  assert(scaled != 0 && "slot: __builtin_clzll(0) is undefined");
+  unsigned chunk = 63 - __builtin_clzll(scaled);
+  std::uint64_t first = ((std::uint64_t(1) << chunk) - 1) << kFirstChunkBits;
+  return table.chunks[chunk][index - first].bytes;
+}
+
+template <typename T, typename Compare>
+typename IndexRBTree<T, Compare>::index_type
+IndexRBTree<T, Compare>::allocateSlot() {
+  if (free_ != kNil) {
+    index_type index = free_;
+    free_ = *std::launder(reinterpret_cast<index_type*>(slot(index)));
+    return index;
+  }
+  auto& chunks = table_->chunks;
+  std::uint64_t capacity = ((std::uint64_t(1) << chunks.size()) - 1)
+                           << kFirstChunkBits;
+  if (used_ == capacity) {
+    std::size_t slots = std::size_t(1) << (kFirstChunkBits + chunks.size());
+    std::unique_ptr<Slot[]> chunk(new Slot[slots]);
+    chunks.push_back(std::move(chunk));
+  }
+  return used_++;
+}
+
+// The freed slot stores the previous head, so releasing never allocates.
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::releaseSlot(index_type index) {
+  new (static_cast<void*>(slot(index))) index_type(free_);
+  free_ = index;
+}
+
+// Preorder walk over the live nodes; fn may destroy the node it is given,
+// whose children have been read by then.
+template <typename T, typename Compare>
+template <typename Fn>
+void IndexRBTree<T, Compare>::forEachNode(Fn fn) const {
+  index_type stack[kMaxDepth + 1];
+  std::size_t depth = 0;
+  if (table_->root != kNil) stack[depth++] = table_->root;
+  while (depth > 0) {
+    index_type current = stack[--depth];
+    const Node& n = node(current);
+    if (n.right != kNil) stack[depth++] = n.right;
+    if (n.left != kNil) stack[depth++] = n.left;
+    fn(current);
+  }
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::destroyNodes() {
+  if constexpr (!std::is_trivially_destructible<T>::value) {
+    forEachNode([this](index_type index) { node(index).~Node(); });
+  }
+}
+
+// Builds each node at its index in other, so links and the free list copy
+// verbatim. A throwing copy unwinds the nodes built so far.
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::copyFrom(const IndexRBTree& other) {
+  for (std::size_t c = 0; c < other.table_->chunks.size(); ++c) {
+    std::size_t slots = std::size_t(1) << (kFirstChunkBits + c);
+    table_->chunks.push_back(std::unique_ptr<Slot[]>(new Slot[slots]));
+  }
+  size_type built = 0;
+  try {
+    other.forEachNode([&](index_type index) {
+      new (static_cast<void*>(slot(index))) Node(other.node(index));
+      ++built;
+    });
+  } catch (...) {
+    other.forEachNode([&](index_type index) {
+      if (built > 0) {
+        node(index).~Node();
+        --built;
+      }
+    });
+    table_->chunks.clear();
+    throw;
+  }
+  for (index_type index = other.free_; index != kNil;) {
+    index_type next =
+        *std::launder(reinterpret_cast<const index_type*>(other.slot(index)));
+    new (static_cast<void*>(slot(index))) index_type(next);
+    index = next;
+  }
+  table_->root = other.table_->root;
+  used_ = other.used_;
+  free_ = other.free_;
+  size_ = other.size_;
+}
+
+// Builds element i into slot i, then links the slots as RBTree's
+// buildFromSorted() does: every subtree split at its middle, full levels
+// black and the partial last level red. Slot order is key order, so a
+// later in-order walk reads the chunks front to back. The nodes are built
+// on one thread; the sort before this is what runs in parallel.
+template <typename T, typename Compare>
+template <typename RandomIt>
+void IndexRBTree<T, Compare>::buildFromSorted(RandomIt first, RandomIt last,
+                                              unsigned) {
+  clear();
+  size_type count = last - first;
+  if (!count) return;
+  if (count > max_size()) {
+    throw std::length_error("IndexRBTree: too many elements");
+  }
+
+  size_type built = 0;
+  try {
+    for (; built < count; ++built) {
+      index_type index = allocateSlot();
+      new (static_cast<void*>(slot(index))) Node(*(first + built));
+    }
+  } catch (...) {
+    for (size_type i = 0; i < built; ++i) node(index_type(i)).~Node();
+    table_->chunks.clear();
+    used_ = 0;
+    throw;
+  }
+
+  int red_depth = 0;
+  while ((size_type(2) << red_depth) - 1 <= count) {
+    ++red_depth;
+  }
+  table_->root = linkSorted(0, count, 0, red_depth, kNil);
+  size_ = count;
+}
+
+template <typename T, typename Compare>
+typename IndexRBTree<T, Compare>::index_type
+IndexRBTree<T, Compare>::linkSorted(index_type first, size_type count,
+                                    int depth, int red_depth,
+                                    index_type parent) {
+  if (!count) return kNil;
+  size_type middle = count / 2;
+  index_type index = first + index_type(middle);
+  Node& n = node(index);
+  n.parent = parent;
+  n.color = depth == red_depth ? Node::RED : Node::BLACK;
+  n.left = linkSorted(first, middle, depth + 1, red_depth, index);
+  n.right =
+      linkSorted(index + 1, count - middle - 1, depth + 1, red_depth, index);
+  return index;
+}
+
+// Same cut as RBTree::segments(): the top levels node by node, whole
+// subtrees below them.
+template <typename T, typename Compare>
+std::vector<typename IndexRBTree<T, Compare>::Segment>
+IndexRBTree<T, Compare>::segments(size_type max_count) const {
+  int depth = 0;
+  while ((size_type(4) << depth) <= max_count + 1) {
+    ++depth;
+  }
+  std::vector<Segment> result;
+  splitSegments(table_->root, depth, result);
+  return result;
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::splitSegments(
+    index_type index, int depth, std::vector<Segment>& result) const {
+  if (index == kNil) return;
+  if (depth == 0) {
+    result.emplace_back(table_.get(), index, true);
+    return;
+  }
+  splitSegments(node(index).left, depth - 1, result);
+  result.emplace_back(table_.get(), index, false);
+  splitSegments(node(index).right, depth - 1, result);
+}
+
+template <typename T, typename Compare>
+typename IndexRBTree<T, Compare>::iterator IndexRBTree<T, Compare>::begin()
+    const {
+  index_type current = table_->root;
+  while (current != kNil && node(current).left != kNil) {
+    current = node(current).left;
+  }
+  return iterator(table_.get(), current);
+}
+
+template <typename T, typename Compare>
+typename IndexRBTree<T, Compare>::iterator IndexRBTree<T, Compare>::end()
+    const {
+  return iterator(table_.get(), kNil);
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::swap(IndexRBTree& other) {
+  std::swap(table_, other.table_);
+  std::swap(used_, other.used_);
+  std::swap(free_, other.free_);
+  std::swap(size_, other.size_);
+  std::swap(comparator_, other.comparator_);
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::merge(IndexRBTree& other) {
+  IndexRBTree<T, Compare> extra;
+  for (auto it = other.begin(); it != other.end(); ++it) {
+    if (insert(*it).second == false) extra.insert(*it);
+  }
+  other = std::move(extra);
+}
+
+template <typename T, typename Compare>
+typename IndexRBTree<T, Compare>::iterator IndexRBTree<T, Compare>::find(
+    const T& key) const {
+  return findKey(key);
+}
+
+template <typename T, typename Compare>
+template <typename K>
+typename IndexRBTree<T, Compare>::iterator IndexRBTree<T, Compare>::findKey(
+    const K& key) const {
+  index_type current = table_->root;
+
+  while (current != kNil) {
+    int order = compareKeys(comparator_, key, node(current).data);
+    if (order < 0) {
+      current = node(current).left;
+    } else if (order > 0) {
+      current = node(current).right;
+    } else {
+      break;
+    }
+  }
+  return iterator(table_.get(), current);
+}
+
+template <typename T, typename Compare>
+bool IndexRBTree<T, Compare>::contains(const T& key) const {
+  return find(key) != end();
+}
+
+template <typename T, typename Compare>
+template <typename Keys, typename OutputIt>
+OutputIt IndexRBTree<T, Compare>::find_many(const Keys& keys,
+                                            OutputIt out) const {
+  lockstepSearch(keys, [this, &out](index_type index) {
+    *out++ = iterator(table_.get(), index);
+  });
+  return out;
+}
+
+template <typename T, typename Compare>
+template <typename Keys, typename OutputIt>
+OutputIt IndexRBTree<T, Compare>::contains_many(const Keys& keys,
+                                                OutputIt out) const {
+  lockstepSearch(keys, [&out](index_type index) { *out++ = index != kNil; });
+  return out;
+}
+
+// Same lockstep descent as RBTree::lockstepSearch, over array slots.
+template <typename T, typename Compare>
+template <typename Keys, typename Visitor>
+void IndexRBTree<T, Compare>::lockstepSearch(const Keys& keys,
+                                             Visitor visit) const {
+  auto first = std::begin(keys);
+  auto last = std::end(keys);
+  using KeyType = std::remove_reference_t<decltype(*first)>;
+
+  while (first != last) {
+    const KeyType* lane_key[kSearchLanes];
+    index_type lane_node[kSearchLanes];
+    index_type found[kSearchLanes];
+    std::size_t lanes = 0;
+    for (; first != last && lanes < kSearchLanes; ++first, ++lanes) {
+      lane_key[lanes] = &*first;
+      lane_node[lanes] = table_->root;
+      found[lanes] = kNil;
+    }
+
+    bool pending = table_->root != kNil;
+    while (pending) {
+      pending = false;
+      for (std::size_t i = 0; i < lanes; ++i) {
+        index_type current = lane_node[i];
+        if (current == kNil) continue;
+        const Node& n = node(current);
+        int order = compareKeys(comparator_, *lane_key[i], n.data);
+        if (order < 0) {
+          current = n.left;
+        } else if (order > 0) {
+          current = n.right;
+        } else {
+          found[i] = current;
+          current = kNil;
+        }
+        if (current != kNil) {
+          prefetchNode(&node(current));
+          pending = true;
+        }
+        lane_node[i] = current;
+      }
+    }
+
+    for (std::size_t i = 0; i < lanes; ++i) visit(found[i]);
+  }
+}
+
+template <typename T, typename Compare>
+std::pair<typename IndexRBTree<T, Compare>::iterator, bool>
+IndexRBTree<T, Compare>::insert(const value_type& value) {
+  index_type parent = kNil;
+  index_type current = table_->root;
+  bool go_left = false;
+  while (current != kNil) {
+    parent = current;
+    int order = compareKeys(comparator_, value, node(current).data);
+    if (order < 0) {
+      current = node(current).left;
+      go_left = true;
+    } else if (order > 0) {
+      current = node(current).right;
+      go_left = false;
+    } else {
+      return std::make_pair(iterator(table_.get(), current), false);
+    }
+  }
+
+  if (size_ >= max_size()) {
+    throw std::length_error("IndexRBTree: 32-bit index space exhausted");
+  }
+
+  index_type new_node = allocateSlot();
+  try {
+    new (static_cast<void*>(slot(new_node))) Node(value);
+  } catch (...) {
+    releaseSlot(new_node);
+    throw;
+  }
+  ++size_;
+  node(new_node).parent = parent;
+  if (parent == kNil) {
+    table_->root = new_node;
+  } else if (go_left) {
+    node(parent).left = new_node;
+  } else {
+    node(parent).right = new_node;
+  }
+  fixInsertion(new_node);
+
+  return std::make_pair(iterator(table_.get(), new_node), true);
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::fixInsertion(index_type n) {
+  while (n != table_->root && node(node(n).parent).color == Node::RED) {
+    index_type parent = node(n).parent;
+    index_type grandparent = node(parent).parent;
+    if (parent == node(grandparent).left) {
+      index_type uncle = node(grandparent).right;
+      if (isRed(uncle)) {
+        // Case 1: Uncle is red; recolor and move up.
+        node(parent).color = Node::BLACK;
+        node(uncle).color = Node::BLACK;
+        node(grandparent).color = Node::RED;
+        n = grandparent;
+      } else {
+        if (n == node(parent).right) {
+          // Case 2: Node is the right child; rotate into case 3.
+          n = parent;
+          leftRotate(n);
+        }
+        // Case 3: recolor and right-rotate the grandparent.
+        node(node(n).parent).color = Node::BLACK;
+        node(node(node(n).parent).parent).color = Node::RED;
+        rightRotate(node(node(n).parent).parent);
+      }
+    } else {
+      // Same cases as above with "left" and "right" swapped.
+      index_type uncle = node(grandparent).left;
+      if (isRed(uncle)) {
+        node(parent).color = Node::BLACK;
+        node(uncle).color = Node::BLACK;
+        node(grandparent).color = Node::RED;
+        n = grandparent;
+      } else {
+        if (n == node(parent).left) {
+          n = parent;
+          rightRotate(n);
+        }
+        node(node(n).parent).color = Node::BLACK;
+        node(node(node(n).parent).parent).color = Node::RED;
+        leftRotate(node(node(n).parent).parent);
+      }
+    }
+  }
+
+  node(table_->root).color = Node::BLACK;
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::leftRotate(index_type n) {
+  index_type right_child = node(n).right;
+  node(n).right = node(right_child).left;
+
+  if (node(right_child).left != kNil) {
+    node(node(right_child).left).parent = n;
+  }
+
+  index_type parent = node(n).parent;
+  node(right_child).parent = parent;
+
+  if (parent == kNil) {
+    table_->root = right_child;
+  } else if (n == node(parent).left) {
+    node(parent).left = right_child;
+  } else {
+    node(parent).right = right_child;
+  }
+
+  node(right_child).left = n;
+  node(n).parent = right_child;
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::rightRotate(index_type n) {
+  index_type left_child = node(n).left;
+  node(n).left = node(left_child).right;
+
+  if (node(left_child).right != kNil) {
+    node(node(left_child).right).parent = n;
+  }
+
+  index_type parent = node(n).parent;
+  node(left_child).parent = parent;
+
+  if (parent == kNil) {
+    table_->root = left_child;
+  } else if (n == node(parent).right) {
+    node(parent).right = left_child;
+  } else {
+    node(parent).left = left_child;
+  }
+
+  node(left_child).right = n;
+  node(n).parent = left_child;
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::erase(iterator pos) {
+  index_type z = pos.current_;
+  if (z == kNil) {
+    return;
+  }
+
+  index_type y = z;
+  typename Node::Color y_original_color = node(y).color;
+  index_type x;
+  index_type x_parent;
+
+  if (node(z).left == kNil) {
+    x = node(z).right;
+    x_parent = node(z).parent;
+    transplant(z, node(z).right);
+  } else if (node(z).right == kNil) {
+    x = node(z).left;
+    x_parent = node(z).parent;
+    transplant(z, node(z).left);
+  } else {
+    y = node(z).right;
+    while (node(y).left != kNil) {
+      y = node(y).left;
+    }
+    y_original_color = node(y).color;
+    x = node(y).right;
+
+    if (node(y).parent == z) {
+      x_parent = y;
+    } else {
+      x_parent = node(y).parent;
+      transplant(y, node(y).right);
+      node(y).right = node(z).right;
+      node(node(y).right).parent = y;
+    }
+
+    transplant(z, y);
+    node(y).left = node(z).left;
+    node(node(y).left).parent = y;
+    node(y).color = node(z).color;
+  }
+
+  if (y_original_color == Node::BLACK) {
+    deleteFixup(x, x_parent);
+  }
+
+  node(z).~Node();
+  releaseSlot(z);
+  --size_;
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::transplant(index_type u, index_type v) {
+  index_type parent = node(u).parent;
+  if (parent == kNil) {
+    table_->root = v;
+  } else if (u == node(parent).left) {
+    node(parent).left = v;
+  } else {
+    node(parent).right = v;
+  }
+  if (v != kNil) {
+    node(v).parent = parent;
+  }
+}
+
+template <typename T, typename Compare>
+bool IndexRBTree<T, Compare>::isBlack(index_type n) const {
+  return n == kNil || node(n).color == Node::BLACK;
+}
+
+template <typename T, typename Compare>
+bool IndexRBTree<T, Compare>::isRed(index_type n) const {
+  return !isBlack(n);
+}
+
+template <typename T, typename Compare>
+void IndexRBTree<T, Compare>::deleteFixup(index_type x, index_type x_parent) {
+  while (x != table_->root && isBlack(x)) {
+    if (x == node(x_parent).left) {
+      index_type w = node(x_parent).right;
+
+      if (isRed(w)) {
+        // Case 1: x's sibling is red
+        node(w).color = Node::BLACK;
+        node(x_parent).color = Node::RED;
+        leftRotate(x_parent);
+        w = node(x_parent).right;
+      }
+
+      if (isBlack(node(w).left) && isBlack(node(w).right)) {
+        // Case 2: x's sibling and both of its children are black
+        node(w).color = Node::RED;
+        x = x_parent;
+        x_parent = node(x).parent;
+      } else {
+        if (isBlack(node(w).right)) {
+          // Case 3: w's left child is red, its right child is black
+          node(node(w).left).color = Node::BLACK;
+          node(w).color = Node::RED;
+          rightRotate(w);
+          w = node(x_parent).right;
+        }
+
+        // Case 4: w's right child is red
+        node(w).color = node(x_parent).color;
+        node(x_parent).color = Node::BLACK;
+        node(node(w).right).color = Node::BLACK;
+        leftRotate(x_parent);
+        x = table_->root;
+      }
+    } else {
+      // Symmetric cases for x being a right child
+      index_type w = node(x_parent).left;
+
+      if (isRed(w)) {
+        node(w).color = Node::BLACK;
+        node(x_parent).color = Node::RED;
+        rightRotate(x_parent);
+        w = node(x_parent).left;
+      }
+
+      if (isBlack(node(w).right) && isBlack(node(w).left)) {
+        node(w).color = Node::RED;
+        x = x_parent;
+        x_parent = node(x).parent;
+      } else {
+        if (isBlack(node(w).left)) {
+          node(node(w).right).color = Node::BLACK;
+          node(w).color = Node::RED;
+          leftRotate(w);
+          w = node(x_parent).left;
+        }
+
+        node(w).color = node(x_parent).color;
+        node(x_parent).color = Node::BLACK;
+        node(node(w).left).color = Node::BLACK;
+        rightRotate(x_parent);
+        x = table_->root;
+      }
+    }
+  }
+
+  if (x != kNil) node(x).color = Node::BLACK;
+}
+
+}  // namespace s21
+
+#endif
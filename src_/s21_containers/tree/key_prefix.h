@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#ifndef key_prefix_h
+#define key_prefix_h
+
+namespace s21 {
+
+using key_prefix_type = std::uint32_t;
+
+// First 4 bytes of key, big-endian and zero-padded. If a's prefix is below
+// b's then a < b; equal prefixes settle nothing.
+inline key_prefix_type stringKeyPrefix(std::string_view key) {
+  key_prefix_type prefix = 0;
+  for (std::size_t i = 0; i < sizeof(prefix); ++i) {
+    unsigned char byte = i < key.size() ? key[i] : 0;
+    prefix = prefix << 8 | byte;
+  }
+  return prefix;
+}
+
+// Tells the trees whether Compare orders keys consistently with an integer
+// prefix. Nodes then cache that prefix next to their links, so a search
+// compares two integers at each level and reads the key itself (for strings,
+// a separate heap buffer) only when the prefixes tie.
+//
+// A specialization provides a static prefix(key) returning key_prefix_type.
+// The prefix is 4 bytes so that it fits in the padding after a node's
+// color and the node does not grow.
+template <typename Compare, typename Enable = void>
+struct key_prefix_traits : std::false_type {};
+
+template <>
+struct key_prefix_traits<std::less<std::string>> : std::true_type {
+  static key_prefix_type prefix(const std::string& key) {
+    return stringKeyPrefix(key);
+  }
+};
+
+template <>
+struct key_prefix_traits<std::less<std::string_view>> : std::true_type {
+  static key_prefix_type prefix(std::string_view key) {
+    return stringKeyPrefix(key);
+  }
+};
+
+// The traits a tree of T ordered by Compare uses. A comparator that orders
+// whole values without naming the key type specializes this on T instead.
+template <typename Compare, typename T>
+struct tree_key_prefix_traits : key_prefix_traits<Compare> {};
+
+// Storage for the cached prefix; empty when the comparator has no traits.
+template <bool Enabled>
+struct KeyPrefixSlot {};
+
+template <>
+struct KeyPrefixSlot<true> {
+  key_prefix_type value = 0;
+};
+
+}  // namespace s21
+
+#endif
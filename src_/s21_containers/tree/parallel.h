@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef parallel_h
+#define parallel_h
+
+namespace s21 {
+
+inline unsigned defaultThreadCount() {
+  unsigned threads = std::thread::hardware_concurrency();
+  return threads ? threads : 1;
+}
+
+// Sorts items on up to `threads` workers: each worker stable-sorts one chunk,
+// then neighbouring chunks are merged pairwise, also in parallel. Elements
+// equivalent under comp are dropped afterwards, keeping the first occurrence
+// in input order, which matches what repeated insert() would keep.
+template <typename T, typename Compare>
+void parallelSortUnique(std::vector<T>& items, const Compare& comp,
+                        unsigned threads) {
+  constexpr std::size_t kMinChunk = 1 << 14;
+  std::size_t chunks = std::max<std::size_t>(
+      1, std::min<std::size_t>(threads, items.size() / kMinChunk));
+
+  std::vector<std::size_t> bounds(chunks + 1);
+  for (std::size_t i = 0; i <= chunks; ++i) {
+    bounds[i] = items.size() * i / chunks;
+  }
+
+  std::vector<std::thread> workers;
+  for (std::size_t i = 0; i < chunks; ++i) {
+    workers.emplace_back([&items, &bounds, &comp, i] {
+      std::stable_sort(items.begin() + bounds[i], items.begin() + bounds[i + 1],
+                       comp);
+    });
+  }
+  for (auto& worker : workers) worker.join();
+
+  for (std::size_t width = 1; width < chunks; width *= 2) {
+    workers.clear();
+    for (std::size_t i = 0; i + width < chunks; i += 2 * width) {
+      std::size_t right = std::min(i + 2 * width, chunks);
+      workers.emplace_back([&items, &bounds, &comp, i, width, right] {
+        std::inplace_merge(items.begin() + bounds[i],
+                           items.begin() + bounds[i + width],
+                           items.begin() + bounds[right], comp);
+      });
+    }
+    for (auto& worker : workers) worker.join();
+  }
+
+  items.erase(std::unique(items.begin(), items.end(),
+                          [&comp](const T& kept, const T& next) {
+                            return !comp(kept, next);
+                          }),
+              items.end());
+}
+
+// Runs task(0) .. task(count - 1) on up to `threads` workers. Each worker
+// owns a contiguous block of task indices and takes them from the front;
+// a worker that runs dry steals from the back of another worker's block.
+template <typename Task>
+void runWorkStealing(std::size_t count, unsigned threads, Task task) {
+  struct Block {
+    std::mutex lock;
+    std::size_t next;
+    std::size_t end;
+  };
+
+  std::size_t workers_count =
+      std::max<std::size_t>(1, std::min<std::size_t>(threads, count));
+  std::vector<Block> blocks(workers_count);
+  for (std::size_t i = 0; i < workers_count; ++i) {
+    blocks[i].next = count * i / workers_count;
+    blocks[i].end = count * (i + 1) / workers_count;
+  }
+
+  auto work = [&blocks, &task, workers_count](std::size_t self) {
+    for (std::size_t victim = self, tried = 0; tried < workers_count;) {
+      std::size_t index = 0;
+      bool taken = false;
+      {
+        std::lock_guard<std::mutex> guard(blocks[victim].lock);
+        Block& block = blocks[victim];
+        if (block.next < block.end) {
+          index = victim == self ? block.next++ : --block.end;
+          taken = true;
+        }
+      }
+      if (taken) {
+        task(index);
+      } else {
+        victim = (victim + 1) % workers_count;
+        ++tried;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < workers_count; ++i) {
+    workers.emplace_back(work, i);
+  }
+  work(0);
+  for (auto& worker : workers) worker.join();
+}
+
+constexpr std::size_t kSegmentsPerThread = 8;
+// Per-task results sit this far apart so that workers never write to the
+// same cache line.
+constexpr std::size_t kCacheLineSize = 64;
+// Below this many elements, starting threads costs more than the walk they
+// would share, so the calling thread does it alone.
+constexpr std::size_t kMinParallelElements = 1 << 14;
+
+inline unsigned threadsFor(std::size_t elements, unsigned threads) {
+  return elements < kMinParallelElements ? 1 : threads;
+}
+
+// Calls fn on every element, spread over balanced subtree tasks. fn runs
+// concurrently and must be safe to call from several threads.
+template <typename Container, typename Fn>
+void parallel_for_each(Container& container, Fn fn,
+                       unsigned threads = defaultThreadCount()) {
+  threads = threadsFor(container.size(), threads);
+  auto segments = container.segments(threads * kSegmentsPerThread);
+  runWorkStealing(segments.size(), threads, [&segments, &fn](std::size_t i) {
+    segments[i].for_each(fn);
+  });
+}
+
+// Folds each subtree task with accumulate(Acc, element) starting from
+// identity, then combines the partial results left to right, so combine only
+// has to be associative.
+template <typename Container, typename Acc, typename Accumulate,
+          typename Combine>
+Acc parallel_reduce(const Container& container, Acc identity,
+                    Accumulate accumulate, Combine combine,
+                    unsigned threads = defaultThreadCount()) {
+  // A plain std::vector<Acc> would pack bool results into shared words.
+  struct alignas(kCacheLineSize) Slot {
+    Acc value;
+  };
+
+  threads = threadsFor(container.size(), threads);
+  auto segments = container.segments(threads * kSegmentsPerThread);
+  std::vector<Slot> partial(segments.size(), Slot{identity});
+  runWorkStealing(segments.size(), threads, [&](std::size_t i) {
+    Acc& acc = partial[i].value;
+    segments[i].for_each(
+        [&](const auto& value) { acc = accumulate(std::move(acc), value); });
+  });
+
+  Acc result = std::move(identity);
+  for (auto& part : partial) {
+    result = combine(std::move(result), std::move(part.value));
+  }
+  return result;
+}
+
+// Copies the elements into a vector in container order.
+template <typename Container>
+std::vector<typename Container::value_type> to_vector(
+    const Container& container, unsigned threads = defaultThreadCount()) {
+  using Value = typename Container::value_type;
+  threads = threadsFor(container.size(), threads);
+  auto segments = container.segments(threads * kSegmentsPerThread);
+  std::vector<std::vector<Value>> parts(segments.size());
+  runWorkStealing(segments.size(), threads, [&](std::size_t i) {
+    segments[i].for_each(
+        [&](const Value& value) { parts[i].push_back(value); });
+  });
+
+  std::vector<Value> result;
+  result.reserve(container.size());
+  for (auto& part : parts) {
+    for (auto& value : part) result.push_back(std::move(value));
+  }
+  return result;
+}
+
+}  // namespace s21
+
+#endif
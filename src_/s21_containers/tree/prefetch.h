@@ -0,0 +1,18 @@
+#ifndef prefetch_h
+#define prefetch_h
+
+namespace s21 {
+
+// Hints the CPU to pull a node into cache ahead of the comparison that
+// will read it. A no-op on compilers without the builtin.
+inline void prefetchNode(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address, 0, 3);
+#else
+  (void)address;
+#endif
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,257 @@
+#ifndef rb_algorithms_h
+#define rb_algorithms_h
+
+namespace s21 {
+
+// The red-black link surgery shared by RBTree and the intrusive containers,
+// written against NodeTraits instead of a node type:
+//
+//   using node_ptr;                          pointer to a node, null-able
+//   parent(n), left(n), right(n)             read a link
+//   setParent(n, p), setLeft(n, l), setRight(n, r)
+//   isRed(n), setRed(n, red)                 n is never null here
+//   copyBalance(to, from)                    what a successor taking a
+//                                            removed node's place inherits
+//
+// Every function takes the root by reference and updates it when the
+// root changes. A null node counts as black.
+template <typename NodeTraits>
+struct rb_algorithms {
+  using node_ptr = typename NodeTraits::node_ptr;
+
+  // Left behind by unlink(): x (possibly null) took the removed position
+  // under x_parent, and removed_red tells whether a rebalance is needed.
+  struct unlinked {
+    node_ptr x;
+    node_ptr x_parent;
+    bool removed_red;
+  };
+
+  static bool isRed(node_ptr node) {
+    return node && NodeTraits::isRed(node);
+  }
+  static bool isBlack(node_ptr node) { return !isRed(node); }
+
+  static node_ptr minimum(node_ptr node) {
+    while (node && NodeTraits::left(node)) node = NodeTraits::left(node);
+    return node;
+  }
+  static node_ptr maximum(node_ptr node) {
+    while (node && NodeTraits::right(node)) node = NodeTraits::right(node);
+    return node;
+  }
+  // In-order neighbours; null past either end.
+  static node_ptr next(node_ptr node);
+  static node_ptr prev(node_ptr node);
+
+  static void rotateLeft(node_ptr& root, node_ptr node);
+  static void rotateRight(node_ptr& root, node_ptr node);
+  // Hangs node, with no children, under parent (or as the root when
+  // parent is null).
+  static void link(node_ptr& root, node_ptr node, node_ptr parent,
+                   bool as_left);
+  static bool fixInsertion(node_ptr& root, node_ptr node);
+  // Puts v where u was under u's parent; u's own links are left alone.
+  static void transplant(node_ptr& root, node_ptr u, node_ptr v);
+  static unlinked unlink(node_ptr& root, node_ptr z);
+  static void deleteFixup(node_ptr& root, node_ptr x, node_ptr x_parent);
+
+ private:
+  static void paintBlack(node_ptr node) {
+    if (node) NodeTraits::setRed(node, false);
+  }
+};
+
+template <typename NodeTraits>
+typename rb_algorithms<NodeTraits>::node_ptr rb_algorithms<NodeTraits>::next(
+    node_ptr node) {
+  if (NodeTraits::right(node)) return minimum(NodeTraits::right(node));
+  node_ptr parent = NodeTraits::parent(node);
+  while (parent && node == NodeTraits::right(parent)) {
+    node = parent;
+    parent = NodeTraits::parent(parent);
+  }
+  return parent;
+}
+
+template <typename NodeTraits>
+typename rb_algorithms<NodeTraits>::node_ptr rb_algorithms<NodeTraits>::prev(
+    node_ptr node) {
+  if (NodeTraits::left(node)) return maximum(NodeTraits::left(node));
+  node_ptr parent = NodeTraits::parent(node);
+  while (parent && node == NodeTraits::left(parent)) {
+    node = parent;
+    parent = NodeTraits::parent(parent);
+  }
+  return parent;
+}
+
+template <typename NodeTraits>
+void rb_algorithms<NodeTraits>::rotateLeft(node_ptr& root, node_ptr node) {
+  node_ptr right_child = NodeTraits::right(node);
+  NodeTraits::setRight(node, NodeTraits::left(right_child));
+  if (NodeTraits::left(right_child)) {
+    NodeTraits::setParent(NodeTraits::left(right_child), node);
+  }
+  transplant(root, node, right_child);
+  NodeTraits::setLeft(right_child, node);
+  NodeTraits::setParent(node, right_child);
+}
+
+template <typename NodeTraits>
+void rb_algorithms<NodeTraits>::rotateRight(node_ptr& root, node_ptr node) {
+  node_ptr left_child = NodeTraits::left(node);
+  NodeTraits::setLeft(node, NodeTraits::right(left_child));
+  if (NodeTraits::right(left_child)) {
+    NodeTraits::setParent(NodeTraits::right(left_child), node);
+  }
+  transplant(root, node, left_child);
+  NodeTraits::setRight(left_child, node);
+  NodeTraits::setParent(node, left_child);
+}
+
+template <typename NodeTraits>
+void rb_algorithms<NodeTraits>::link(node_ptr& root, node_ptr node,
+                                     node_ptr parent, bool as_left) {
+  NodeTraits::setParent(node, parent);
+  NodeTraits::setLeft(node, nullptr);
+  NodeTraits::setRight(node, nullptr);
+  if (!parent) {
+    root = node;
+  } else if (as_left) {
+    NodeTraits::setLeft(parent, node);
+  } else {
+    NodeTraits::setRight(parent, node);
+  }
+}
+
+// Repairs a red node under a red parent: recolor while the uncle is red,
+// otherwise one or two rotations end it. Returns whether the root had to be
+// repainted black, which adds a level to every path.
+template <typename NodeTraits>
+bool rb_algorithms<NodeTraits>::fixInsertion(node_ptr& root, node_ptr node) {
+  while (node != root && isRed(NodeTraits::parent(node))) {
+    node_ptr parent = NodeTraits::parent(node);
+    node_ptr grandparent = NodeTraits::parent(parent);
+    bool parent_left = parent == NodeTraits::left(grandparent);
+    node_ptr uncle = parent_left ? NodeTraits::right(grandparent)
+                                 : NodeTraits::left(grandparent);
+    if (isRed(uncle)) {
+      NodeTraits::setRed(parent, false);
+      NodeTraits::setRed(uncle, false);
+      NodeTraits::setRed(grandparent, true);
+      node = grandparent;
+      continue;
+    }
+    if (parent_left && node == NodeTraits::right(parent)) {
+      node = parent;
+      rotateLeft(root, node);
+    } else if (!parent_left && node == NodeTraits::left(parent)) {
+      node = parent;
+      rotateRight(root, node);
+    }
+    NodeTraits::setRed(NodeTraits::parent(node), false);
+    NodeTraits::setRed(grandparent, true);
+    parent_left ? rotateRight(root, grandparent)
+                : rotateLeft(root, grandparent);
+  }
+
+  bool repainted = NodeTraits::isRed(root);
+  NodeTraits::setRed(root, false);
+  return repainted;
+}
+
+template <typename NodeTraits>
+void rb_algorithms<NodeTraits>::transplant(node_ptr& root, node_ptr u,
+                                           node_ptr v) {
+  node_ptr parent = NodeTraits::parent(u);
+  if (!parent) {
+    root = v;
+  } else if (u == NodeTraits::left(parent)) {
+    NodeTraits::setLeft(parent, v);
+  } else {
+    NodeTraits::setRight(parent, v);
+  }
+  if (v) NodeTraits::setParent(v, parent);
+}
+
+// Unlinks z as in CLRS: a node with two children is replaced by its
+// successor y, which inherits z's balance data. x_parent is tracked
+// separately because x may be null.
+template <typename NodeTraits>
+typename rb_algorithms<NodeTraits>::unlinked
+rb_algorithms<NodeTraits>::unlink(node_ptr& root, node_ptr z) {
+  node_ptr left = NodeTraits::left(z);
+  node_ptr right = NodeTraits::right(z);
+  if (!left || !right) {
+    node_ptr x = left ? left : right;
+    unlinked result{x, NodeTraits::parent(z), NodeTraits::isRed(z)};
+    transplant(root, z, x);
+    return result;
+  }
+
+  node_ptr y = minimum(right);
+  unlinked result{NodeTraits::right(y), y, NodeTraits::isRed(y)};
+  if (NodeTraits::parent(y) != z) {
+    result.x_parent = NodeTraits::parent(y);
+    transplant(root, y, NodeTraits::right(y));
+    NodeTraits::setRight(y, right);
+    NodeTraits::setParent(right, y);
+  }
+  transplant(root, z, y);
+  NodeTraits::setLeft(y, left);
+  NodeTraits::setParent(left, y);
+  NodeTraits::copyBalance(y, z);
+  return result;
+}
+
+// Pushes the extra black on x up the tree or absorbs it with at most three
+// rotations; the black height of every path is restored on exit.
+template <typename NodeTraits>
+void rb_algorithms<NodeTraits>::deleteFixup(node_ptr& root, node_ptr x,
+                                            node_ptr x_parent) {
+  while (x != root && isBlack(x)) {
+    bool x_left = x == NodeTraits::left(x_parent);
+    // x's sibling, never null here.
+    node_ptr w =
+        x_left ? NodeTraits::right(x_parent) : NodeTraits::left(x_parent);
+
+    if (isRed(w)) {
+      // Case 1: red sibling; rotate to get a black one.
+      NodeTraits::setRed(w, false);
+      NodeTraits::setRed(x_parent, true);
+      x_left ? rotateLeft(root, x_parent) : rotateRight(root, x_parent);
+      w = x_left ? NodeTraits::right(x_parent) : NodeTraits::left(x_parent);
+    }
+
+    node_ptr near = x_left ? NodeTraits::left(w) : NodeTraits::right(w);
+    node_ptr far = x_left ? NodeTraits::right(w) : NodeTraits::left(w);
+    if (isBlack(near) && isBlack(far)) {
+      // Case 2: both of w's children are black; move the extra black up.
+      NodeTraits::setRed(w, true);
+      x = x_parent;
+      x_parent = NodeTraits::parent(x);
+      continue;
+    }
+    if (isBlack(far)) {
+      // Case 3: only the near child is red; turn it into case 4.
+      NodeTraits::setRed(near, false);
+      NodeTraits::setRed(w, true);
+      x_left ? rotateRight(root, w) : rotateLeft(root, w);
+      w = x_left ? NodeTraits::right(x_parent) : NodeTraits::left(x_parent);
+      far = x_left ? NodeTraits::right(w) : NodeTraits::left(w);
+    }
+    // Case 4: the far child is red; one rotation absorbs the black.
+    NodeTraits::setRed(w, NodeTraits::isRed(x_parent));
+    NodeTraits::setRed(x_parent, false);
+    paintBlack(far);
+    x_left ? rotateLeft(root, x_parent) : rotateRight(root, x_parent);
+    x = root;
+  }
+
+  paintBlack(x);
+}
+
+}  // namespace s21
+
+#endif
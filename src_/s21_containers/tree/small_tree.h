@@ -0,0 +1,446 @@
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tree.h"
+
+#ifndef small_tree_h
+#define small_tree_h
+
+namespace s21 {
+
+// Keeps up to N elements in a sorted array inside the object and switches to
+// a red-black tree only when an insert would overflow it. Small sets cost no
+// heap allocation at all. The array and the tree share storage, so the
+// object is no larger than the bigger of the two. An emptied tree goes back
+// to the array.
+//
+// Iterators work the same in both modes. Any insert or erase in array mode,
+// and the switch to a tree, invalidates them.
+//
+// Array inserts and erases relocate elements with their move constructor.
+// If that can throw (a map pair with a const std::string key copies), a
+// throw in the middle drops the elements past the gap it leaves: the array
+// stays sorted but shorter, the basic guarantee std::vector::insert gives
+// for such types. A throwing copy of the inserted value and the switch to
+// a tree change nothing.
+template <typename T, typename Compare, std::size_t N>
+class SmallRBTree {
+  static_assert(N > 0, "SmallRBTree needs room for at least one element");
+
+  // Opens the protected bulk and heterogeneous paths of the tree core.
+  struct Tree : RBTree<T, Compare> {
+    using RBTree<T, Compare>::buildFromSorted;
+    using RBTree<T, Compare>::findKey;
+  };
+
+ public:
+  class iterator;
+
+  using value_type = T;
+  using const_iterator = iterator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using Node = typename Tree::Node;
+
+  static constexpr size_type kInlineCapacity = N;
+
+  SmallRBTree() {}
+  SmallRBTree(std::initializer_list<value_type> const& items);
+  SmallRBTree(const SmallRBTree& other);
+  SmallRBTree(SmallRBTree&& other);
+
+  SmallRBTree& operator=(const SmallRBTree& other);
+  SmallRBTree& operator=(SmallRBTree&& other);
+
+  ~SmallRBTree() { reset(); }
+
+  iterator begin() const;
+  iterator end() const;
+
+  bool empty() const { return size() == 0; }
+  size_type size() const { return small_ ? small_size_ : tree_.size(); }
+  size_type max_size() const {
+    return std::numeric_limits<difference_type>::max() / sizeof(Node);
+  }
+  // True while the elements live in the inline array.
+  bool is_inline() const { return small_; }
+
+  void clear() { reset(); }
+  std::pair<iterator, bool> insert(const value_type& value);
+  void erase(iterator pos);
+  void swap(SmallRBTree& other);
+  void merge(SmallRBTree& other);
+
+  iterator find(const T& key) const { return findKey(key); }
+  bool contains(const T& key) const { return find(key) != end(); }
+
+ protected:
+  template <typename K>
+  iterator findKey(const K& key) const;
+  template <typename RandomIt>
+  void buildFromSorted(RandomIt first, RandomIt last, unsigned threads = 1);
+
+ private:
+  T* slots() const {
+    return std::launder(
+        reinterpret_cast<T*>(const_cast<unsigned char*>(buffer_)));
+  }
+  // First slot not less than key.
+  template <typename K>
+  size_type slotLowerBound(const K& key) const;
+  void placeInSlot(size_type pos, T&& item);
+  void promote();
+  // Destroys whichever representation is active and leaves an empty array.
+  void reset();
+  void moveFrom(SmallRBTree& other);
+
+  union {
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+    Tree tree_;
+  };
+  size_type small_size_ = 0;
+  bool small_ = true;
+
+ protected:
+  // Declared last so an empty comparator shares padding with small_.
+  Compare comparator_ = Compare();
+};
+
+template <typename T, typename Compare, std::size_t N>
+class SmallRBTree<T, Compare, N>::iterator {
+  friend SmallRBTree;
+  using TreeIterator = typename Tree::iterator;
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = value_type*;
+  using reference = value_type&;
+
+  reference operator*() const {
+    if (owner_) return owner_->slots()[index_];
+    TreeIterator node = node_;
+    return *node;
+  }
+  pointer operator->() const { return &**this; }
+
+  iterator& operator++() {
+    if (owner_) {
+      ++index_;
+    } else {
+      ++node_;
+    }
+    return *this;
+  }
+  iterator operator++(int) {
+    iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  iterator& operator--() {
+    if (owner_) {
+      --index_;
+    } else {
+      --node_;
+    }
+    return *this;
+  }
+  iterator operator--(int) {
+    iterator tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const iterator& other) const {
+    return owner_ == other.owner_ &&
+           (owner_ ? index_ == other.index_ : node_ == other.node_);
+  }
+  bool operator!=(const iterator& other) const { return !(*this == other); }
+
+ private:
+  // Array mode: owner_ and a slot index. Tree mode: owner_ is null.
+  iterator(const SmallRBTree* owner, size_type index)
+      : owner_(owner), index_(index), node_(nullptr) {}
+  explicit iterator(TreeIterator node)
+      : owner_(nullptr), index_(0), node_(node) {}
+
+  const SmallRBTree* owner_;
+  size_type index_;
+  TreeIterator node_;
+};
+
+template <typename T, typename Compare, std::size_t N>
+SmallRBTree<T, Compare, N>::SmallRBTree(
+    std::initializer_list<value_type> const& items) {
+  for (const auto& item : items) {
+    insert(item);
+  }
+}
+
+template <typename T, typename Compare, std::size_t N>
+SmallRBTree<T, Compare, N>::SmallRBTree(const SmallRBTree& other)
+    : comparator_(other.comparator_) {
+  if (other.small_) {
+    try {
+      for (; small_size_ < other.small_size_; ++small_size_) {
+        new (slots() + small_size_) T(other.slots()[small_size_]);
+      }
+    } catch (...) {
+      reset();
+      throw;
+    }
+  } else {
+    new (&tree_) Tree(other.tree_);
+    small_ = false;
+  }
+}
+
+template <typename T, typename Compare, std::size_t N>
+SmallRBTree<T, Compare, N>::SmallRBTree(SmallRBTree&& other)
+    : comparator_(other.comparator_) {
+  moveFrom(other);
+}
+
+template <typename T, typename Compare, std::size_t N>
+SmallRBTree<T, Compare, N>& SmallRBTree<T, Compare, N>::operator=(
+    const SmallRBTree& other) {
+  if (this != &other) {
+    SmallRBTree copy(other);
+    reset();
+    comparator_ = copy.comparator_;
+    moveFrom(copy);
+  }
+  return *this;
+}
+
+template <typename T, typename Compare, std::size_t N>
+SmallRBTree<T, Compare, N>& SmallRBTree<T, Compare, N>::operator=(
+    SmallRBTree&& other) {
+  if (this != &other) {
+    reset();
+    comparator_ = other.comparator_;
+    moveFrom(other);
+  }
+  return *this;
+}
+
+// Expects *this to be an empty array; leaves other as one.
+template <typename T, typename Compare, std::size_t N>
+void SmallRBTree<T, Compare, N>::moveFrom(SmallRBTree& other) {
+  if (other.small_) {
+    try {
+      for (; small_size_ < other.small_size_; ++small_size_) {
+        new (slots() + small_size_) T(std::move(other.slots()[small_size_]));
+      }
+    } catch (...) {
+      reset();
+      throw;
+    }
+  } else {
+    new (&tree_) Tree(std::move(other.tree_));
+    small_ = false;
+  }
+  other.reset();
+}
+
+template <typename T, typename Compare, std::size_t N>
+void SmallRBTree<T, Compare, N>::reset() {
+  if (small_) {
+    for (size_type i = 0; i < small_size_; ++i) {
+      slots()[i].~T();
+    }
+  } else {
+    tree_.~Tree();
+  }
+  small_ = true;
+  small_size_ = 0;
+}
+
+template <typename T, typename Compare, std::size_t N>
+typename SmallRBTree<T, Compare, N>::iterator
+SmallRBTree<T, Compare, N>::begin() const {
+  return small_ ? iterator(this, 0) : iterator(tree_.begin());
+}
+
+template <typename T, typename Compare, std::size_t N>
+typename SmallRBTree<T, Compare, N>::iterator SmallRBTree<T, Compare, N>::end()
+    const {
+  return small_ ? iterator(this, small_size_) : iterator(tree_.end());
+}
+
+template <typename T, typename Compare, std::size_t N>
+template <typename K>
+typename SmallRBTree<T, Compare, N>::size_type
+SmallRBTree<T, Compare, N>::slotLowerBound(const K& key) const {
+  size_type low = 0;
+  size_type high = small_size_;
+  while (low < high) {
+    size_type middle = (low + high) / 2;
+    if (comparator_(slots()[middle], key)) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+template <typename T, typename Compare, std::size_t N>
+template <typename K>
+typename SmallRBTree<T, Compare, N>::iterator
+SmallRBTree<T, Compare, N>::findKey(const K& key) const {
+  if (!small_) {
+    return iterator(tree_.findKey(key));
+  }
+  size_type pos = slotLowerBound(key);
+  if (pos < small_size_ && !comparator_(key, slots()[pos])) {
+    return iterator(this, pos);
+  }
+  return end();
+}
+
+template <typename T, typename Compare, std::size_t N>
+std::pair<typename SmallRBTree<T, Compare, N>::iterator, bool>
+SmallRBTree<T, Compare, N>::insert(const value_type& value) {
+  if (small_) {
+    size_type pos = slotLowerBound(value);
+    if (pos < small_size_ && !comparator_(value, slots()[pos])) {
+      return {iterator(this, pos), false};
+    }
+    if (small_size_ < N) {
+      // Copied before anything moves, so a throwing copy changes nothing.
+      T item(value);
+      placeInSlot(pos, std::move(item));
+      return {iterator(this, pos), true};
+    }
+    promote();
+  }
+
+  auto result = tree_.insert(value);
+  return {iterator(result.first), result.second};
+}
+
+// Relocates items [pos, small_size_) one slot up and builds item at pos.
+// Elements are relocated rather than assigned: map keys are const. On a
+// throw the slots past the gap are destroyed; see the class comment.
+template <typename T, typename Compare, std::size_t N>
+void SmallRBTree<T, Compare, N>::placeInSlot(size_type pos, T&& item) {
+  T* items = slots();
+  size_type gap = small_size_;
+  try {
+    for (; gap > pos; --gap) {
+      new (items + gap) T(std::move(items[gap - 1]));
+      items[gap - 1].~T();
+    }
+    new (items + pos) T(std::move(item));
+  } catch (...) {
+    for (size_type i = gap + 1; i <= small_size_; ++i) {
+      items[i].~T();
+    }
+    small_size_ = gap;
+    throw;
+  }
+  ++small_size_;
+}
+
+// Moves the full array into a tree built bottom-up in O(N). The array is
+// only torn down once the tree is complete; elements whose move may throw
+// are copied out, the others are moved back if the build fails.
+template <typename T, typename Compare, std::size_t N>
+void SmallRBTree<T, Compare, N>::promote() {
+  std::vector<T> items;
+  items.reserve(small_size_);
+  for (size_type i = 0; i < small_size_; ++i) {
+    items.emplace_back(std::move_if_noexcept(slots()[i]));
+  }
+  Tree tree;
+  try {
+    tree.buildFromSorted(items.begin(), items.end());
+  } catch (...) {
+    if constexpr (std::is_nothrow_move_constructible<T>::value) {
+      for (size_type i = 0; i < small_size_; ++i) {
+        slots()[i].~T();
+        new (slots() + i) T(std::move(items[i]));
+      }
+    }
+    throw;
+  }
+  reset();
+  new (&tree_) Tree(std::move(tree));
+  small_ = false;
+}
+
+template <typename T, typename Compare, std::size_t N>
+void SmallRBTree<T, Compare, N>::erase(iterator pos) {
+  if (!small_) {
+    tree_.erase(pos.node_);
+    if (tree_.empty()) {
+      reset();
+    }
+    return;
+  }
+  if (pos.index_ >= small_size_) {
+    return;
+  }
+
+  T* items = slots();
+  items[pos.index_].~T();
+  size_type next = pos.index_ + 1;
+  try {
+    for (; next < small_size_; ++next) {
+      new (items + next - 1) T(std::move(items[next]));
+      items[next].~T();
+    }
+  } catch (...) {
+    for (size_type i = next; i < small_size_; ++i) {
+      items[i].~T();
+    }
+    small_size_ = next - 1;
+    throw;
+  }
+  --small_size_;
+}
+
+template <typename T, typename Compare, std::size_t N>
+void SmallRBTree<T, Compare, N>::swap(SmallRBTree& other) {
+  SmallRBTree tmp(std::move(other));
+  other = std::move(*this);
+  *this = std::move(tmp);
+}
+
+template <typename T, typename Compare, std::size_t N>
+void SmallRBTree<T, Compare, N>::merge(SmallRBTree& other) {
+  SmallRBTree extra;
+  for (auto it = other.begin(); it != other.end(); ++it) {
+    if (insert(*it).second == false) extra.insert(*it);
+  }
+  other = std::move(extra);
+}
+
+// Ranges that fit stay inline; longer ones are linked straight into a tree.
+template <typename T, typename Compare, std::size_t N>
+template <typename RandomIt>
+void SmallRBTree<T, Compare, N>::buildFromSorted(RandomIt first, RandomIt last,
+                                                 unsigned threads) {
+  reset();
+  if (static_cast<size_type>(last - first) <= N) {
+    for (; first != last; ++first, ++small_size_) {
+      new (slots() + small_size_) T(*first);
+    }
+    return;
+  }
+  new (&tree_) Tree();
+  small_ = false;
+  tree_.buildFromSorted(first, last, threads);
+}
+
+}  // namespace s21
+
+#endif
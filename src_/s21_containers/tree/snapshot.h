@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#ifndef snapshot_h
+#define snapshot_h
+
+namespace s21 {
+
+// Binary snapshot layout, all integers in native byte order:
+//   char[4]  magic "S21T"
+//   uint16   version
+//   uint16   byte order mark 0x0102
+//   uint32   key descriptor    (kind << 24 | fixed size in bytes)
+//   uint32   mapped descriptor (0 for sets)
+//   uint64   element count
+// followed by the elements in ascending order. Fixed-size elements are packed
+// back to back without padding; strings are a uint64 length plus the bytes.
+constexpr char kSnapshotMagic[4] = {'S', '2', '1', 'T'};
+constexpr std::uint16_t kSnapshotVersion = 1;
+constexpr std::uint16_t kSnapshotByteOrder = 0x0102;
+
+enum SnapshotKind : std::uint32_t { kTrivialKind = 1, kStringKind = 2 };
+
+template <typename T>
+struct IsPair : std::false_type {};
+
+template <typename A, typename B>
+struct IsPair<std::pair<A, B>> : std::true_type {};
+
+template <typename T, typename Enable = void>
+struct SnapshotCodec;
+
+// Trivially copyable values are copied byte for byte.
+template <typename T>
+struct SnapshotCodec<T, std::enable_if_t<std::is_trivially_copyable<T>::value &&
+                                         !IsPair<T>::value>> {
+  using plain_type = std::remove_const_t<T>;
+  static constexpr bool kFixedSize = true;
+  static constexpr std::size_t kSize = sizeof(T);
+  static constexpr std::uint32_t kDescriptor = kTrivialKind << 24 | sizeof(T);
+
+  static void encode(char* out, const T& value) {
+    std::memcpy(out, &value, sizeof(T));
+  }
+  static void decode(const char* in, plain_type& value) {
+    std::memcpy(&value, in, sizeof(T));
+  }
+  static void write(std::ostream& os, const T& value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  static void read(std::istream& is, plain_type& value) {
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+};
+
+template <typename T>
+struct SnapshotCodec<T, std::enable_if_t<std::is_same<
+                            std::remove_const_t<T>, std::string>::value>> {
+  using plain_type = std::string;
+  static constexpr bool kFixedSize = false;
+  static constexpr std::uint32_t kDescriptor = kStringKind << 24;
+
+  static void write(std::ostream& os, const std::string& value) {
+    std::uint64_t length = value.size();
+    os.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    os.write(value.data(), value.size());
+  }
+  // The length comes from the stream and may be corrupt, so the string
+  // only grows as bytes actually arrive: a length past the end of the data
+  // fails the stream instead of allocating it up front.
+  static void read(std::istream& is, std::string& value) {
+    constexpr std::uint64_t kChunk = 1 << 16;
+    std::uint64_t length = 0;
+    is.read(reinterpret_cast<char*>(&length), sizeof(length));
+    if (!is) return;
+    if (length > value.max_size()) {
+      is.setstate(std::ios::failbit);
+      return;
+    }
+    value.clear();
+    while (is && value.size() < length) {
+      std::size_t offset = value.size();
+      std::size_t part = std::min(kChunk, length - offset);
+      value.resize(offset + part);
+      is.read(&value[offset], part);
+    }
+  }
+};
+
+// Map entries: key then mapped value, each with its own codec.
+template <typename A, typename B>
+struct SnapshotCodec<std::pair<A, B>> {
+  using KeyCodec = SnapshotCodec<A>;
+  using MappedCodec = SnapshotCodec<B>;
+  using plain_type = std::pair<typename KeyCodec::plain_type,
+                               typename MappedCodec::plain_type>;
+  static constexpr bool kFixedSize =
+      KeyCodec::kFixedSize && MappedCodec::kFixedSize;
+
+  static void write(std::ostream& os, const std::pair<A, B>& value) {
+    KeyCodec::write(os, value.first);
+    MappedCodec::write(os, value.second);
+  }
+  static void read(std::istream& is, plain_type& value) {
+    KeyCodec::read(is, value.first);
+    MappedCodec::read(is, value.second);
+  }
+};
+
+// Block encoding for fixed-size pairs; only instantiated when both halves
+// have a fixed size.
+template <typename A, typename B>
+struct PairBlockCodec {
+  using KeyCodec = SnapshotCodec<A>;
+  using MappedCodec = SnapshotCodec<B>;
+  static constexpr std::size_t kSize = KeyCodec::kSize + MappedCodec::kSize;
+
+  static void encode(char* out, const std::pair<A, B>& value) {
+    KeyCodec::encode(out, value.first);
+    MappedCodec::encode(out + KeyCodec::kSize, value.second);
+  }
+  template <typename Plain>
+  static void decode(const char* in, Plain& value) {
+    KeyCodec::decode(in, value.first);
+    MappedCodec::decode(in + KeyCodec::kSize, value.second);
+  }
+};
+
+template <typename T>
+struct SnapshotBlockCodec {
+  using type = SnapshotCodec<T>;
+};
+
+template <typename A, typename B>
+struct SnapshotBlockCodec<std::pair<A, B>> {
+  using type = PairBlockCodec<A, B>;
+};
+
+template <typename T>
+struct SnapshotLayout {
+  static constexpr std::uint32_t kKey = SnapshotCodec<T>::kDescriptor;
+  static constexpr std::uint32_t kMapped = 0;
+};
+
+template <typename A, typename B>
+struct SnapshotLayout<std::pair<A, B>> {
+  static constexpr std::uint32_t kKey = SnapshotCodec<A>::kDescriptor;
+  static constexpr std::uint32_t kMapped = SnapshotCodec<B>::kDescriptor;
+};
+
+template <typename T>
+void writeSnapshotHeader(std::ostream& os, std::uint64_t count) {
+  std::uint32_t key = SnapshotLayout<T>::kKey;
+  std::uint32_t mapped = SnapshotLayout<T>::kMapped;
+  os.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+  os.write(reinterpret_cast<const char*>(&kSnapshotVersion),
+           sizeof(kSnapshotVersion));
+  os.write(reinterpret_cast<const char*>(&kSnapshotByteOrder),
+           sizeof(kSnapshotByteOrder));
+  os.write(reinterpret_cast<const char*>(&key), sizeof(key));
+  os.write(reinterpret_cast<const char*>(&mapped), sizeof(mapped));
+  os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+}
+
+// Returns the element count; throws when the stream does not hold a
+// snapshot of the same element layout.
+template <typename T>
+std::uint64_t readSnapshotHeader(std::istream& is) {
+  char magic[sizeof(kSnapshotMagic)] = {};
+  std::uint16_t version = 0;
+  std::uint16_t byte_order = 0;
+  std::uint32_t key = 0;
+  std::uint32_t mapped = 0;
+  std::uint64_t count = 0;
+  is.read(magic, sizeof(magic));
+  is.read(reinterpret_cast<char*>(&version), sizeof(version));
+  is.read(reinterpret_cast<char*>(&byte_order), sizeof(byte_order));
+  is.read(reinterpret_cast<char*>(&key), sizeof(key));
+  is.read(reinterpret_cast<char*>(&mapped), sizeof(mapped));
+  is.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+  if (!is || std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0) {
+    throw std::runtime_error("snapshot: bad header");
+  }
+  if (version != kSnapshotVersion || byte_order != kSnapshotByteOrder) {
+    throw std::runtime_error("snapshot: unsupported version or byte order");
+  }
+  if (key != SnapshotLayout<T>::kKey || mapped != SnapshotLayout<T>::kMapped) {
+    throw std::runtime_error("snapshot: element layout mismatch");
+  }
+  return count;
+}
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,55 @@
+#include "index_tree.h"
+#include "small_tree.h"
+#include "tree.h"
+
+#ifndef storage_h
+#define storage_h
+
+namespace s21 {
+
+// Storage policies pick the tree core behind s21::set and s21::map.
+// node_storage allocates each node on the heap and links them by pointer.
+struct node_storage {
+  template <typename T, typename Compare>
+  using tree = RBTree<T, Compare>;
+};
+
+// avl_storage and wavl_storage are node_storage with a different balancing
+// policy (see balance.h): AVL keeps lookups shallowest, WAVL sits between
+// it and red-black on update cost.
+struct avl_storage {
+  template <typename T, typename Compare>
+  using tree = RBTree<T, Compare, avl_balance>;
+};
+
+struct wavl_storage {
+  template <typename T, typename Compare>
+  using tree = RBTree<T, Compare, wavl_balance>;
+};
+
+// splay_storage moves every key it inserts or finds to the root: cheapest
+// when a few keys take most lookups. Its find() modifies the tree.
+struct splay_storage {
+  template <typename T, typename Compare>
+  using tree = RBTree<T, Compare, splay_balance>;
+};
+
+// index_storage links nodes by 32-bit indices into a few doubling chunks:
+// half the link overhead on 64-bit builds. Nodes never move, so references
+// stay valid exactly as with node_storage.
+struct index_storage {
+  template <typename T, typename Compare>
+  using tree = IndexRBTree<T, Compare>;
+};
+
+// small_storage<N> keeps up to N elements inline in the container object and
+// only builds a node tree once it outgrows them.
+template <std::size_t N>
+struct small_storage {
+  template <typename T, typename Compare>
+  using tree = SmallRBTree<T, Compare, N>;
+};
+
+}  // namespace s21
+
+#endif
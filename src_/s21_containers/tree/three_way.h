@@ -0,0 +1,60 @@
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#ifndef three_way_h
+#define three_way_h
+
+namespace s21 {
+
+// Tells the trees whether Compare can order two keys in one call. Searches
+// then make one comparison per level instead of `a < b` followed by `b < a`.
+//
+// A comparator opts in by declaring `using is_three_way = void;` and a
+// member `three_way(a, b)` whose result compares with 0 like a
+// std::weak_ordering (an int works too). Comparators that only provide
+// operator() keep the two-call path.
+template <typename Compare, typename Enable = void>
+struct three_way_traits : std::false_type {};
+
+template <typename Compare>
+struct three_way_traits<Compare, std::void_t<typename Compare::is_three_way>>
+    : std::true_type {
+  template <typename A, typename B>
+  static int compare(const Compare& comparator, const A& lhs, const B& rhs) {
+    auto order = comparator.three_way(lhs, rhs);
+    return order < 0 ? -1 : (order == 0 ? 0 : 1);
+  }
+};
+
+// Strings already have a three-way compare(); one memcmp instead of two.
+template <>
+struct three_way_traits<std::less<std::string>> : std::true_type {
+  static int compare(const std::less<std::string>&, const std::string& lhs,
+                     const std::string& rhs) {
+    return lhs.compare(rhs);
+  }
+};
+
+template <>
+struct three_way_traits<std::less<std::string_view>> : std::true_type {
+  static int compare(const std::less<std::string_view>&, std::string_view lhs,
+                     std::string_view rhs) {
+    return lhs.compare(rhs);
+  }
+};
+
+// Returns <0, 0 or >0 as lhs orders before, with or after rhs.
+template <typename Compare, typename A, typename B>
+int compareKeys(const Compare& comparator, const A& lhs, const B& rhs) {
+  if constexpr (three_way_traits<Compare>::value) {
+    return three_way_traits<Compare>::compare(comparator, lhs, rhs);
+  } else {
+    return comparator(lhs, rhs) ? -1 : (comparator(rhs, lhs) ? 1 : 0);
+  }
+}
+
+}  // namespace s21
+
+#endif
@@ -1,15 +1,45 @@
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "balance.h"
+#include "key_prefix.h"
+#include "prefetch.h"
+#include "rb_algorithms.h"
+#include "snapshot.h"
+#include "three_way.h"
+#include "tree_stats.h"
 
 #ifndef tree_h
 #define tree_h
 
 namespace s21 {
 
-template <typename T, typename Compare = std::less<T>>
+template <typename T, typename Compare = std::less<T>,
+          typename Balance = rb_balance>
 class RBTree {
+  friend Balance;
+
  public:
   class Node;
+  class Segment;
+  template <typename K>
+  class Cursor;
 
   template <bool IsConst>
   class RBTreeIteratorBase;
@@ -22,7 +52,13 @@ class RBTree {
 
  protected:
   Node* root_;
-  size_type size_;
+  Node* rightmost_;  // cached maximum for the append fast path
+  // kUnknownSize after a split until size() counts the nodes once. Only
+  // relaxed loads and stores: a const size() may fill it in concurrently
+  // with other readers, and mutators have the tree to themselves.
+  static constexpr size_type kUnknownSize =
+      std::numeric_limits<size_type>::max();
+  mutable std::atomic<size_type> size_;
   Compare comparator_ = Compare();
 
  public:
@@ -44,31 +80,177 @@ class RBTree {
   size_type max_size() const;
 
   void clear();
-  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return insertUnique(value);
+  }
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return insertUnique(std::move(value));
+  }
+  iterator insert(iterator hint, const value_type& value) {
+    return insertHinted(hint, value);
+  }
+  iterator insert(iterator hint, value_type&& value) {
+    return insertHinted(hint, std::move(value));
+  }
+  template <typename... Args>
+  iterator emplace_hint(iterator hint, Args&&... args);
+  iterator push_back_ordered(const value_type& value);
   void erase(iterator pos);
   void swap(RBTree& other);
   void merge(RBTree& other);
 
+  template <typename K>
+  bool split(const K& key, RBTree& right);
+  template <typename K>
+  void split_at(const K& key, RBTree& upper);
+  void join(const value_type& key, RBTree& right);
+  void concat(RBTree& right);
+  void unite(const RBTree& other, unsigned threads = 1);
+  void intersect(const RBTree& other, unsigned threads = 1);
+  void subtract(const RBTree& other, unsigned threads = 1);
+
+  // A splay tree restructures itself on lookup, so there only these
+  // non-const overloads compile; const ones would race between readers.
+  iterator find(const T& key);
+  iterator find(iterator hint, const T& key);
+  bool contains(const T& key);
   iterator find(const T& key) const;
+  iterator find(iterator hint, const T& key) const;
   bool contains(const T& key) const;
 
- private:
-  void copyTree(const Node* source_node, Node* parent);
-  void deleteTree(Node* node);
-  void helper(Node* node);
+  template <typename Keys, typename OutputIt>
+  OutputIt find_many(const Keys& keys, OutputIt out) const;
+  template <typename Keys, typename OutputIt>
+  OutputIt contains_many(const Keys& keys, OutputIt out) const;
+
+  std::vector<Segment> segments(size_type max_count) const;
+
+  void save(std::ostream& os) const;
+  void load(std::istream& is);
+
+  tree_memory_stats memory_stats(stats_mode mode = stats_mode::sampled) const;
+
+ protected:
+  template <typename K>
+  iterator findKey(const K& key);
+  template <typename K>
+  iterator findKey(const K& key) const;
+  template <typename K>
+  iterator lowerBoundKey(const K& key) const;
+  template <typename K>
+  iterator upperBoundKey(const K& key) const;
+  template <typename K>
+  iterator findNear(iterator hint, const K& key);
+  template <typename K>
+  iterator findNear(iterator hint, const K& key) const;
+  template <typename K>
+  Node* lowerBoundNear(Node* finger, const K& key) const;
+  // For containers that keep their own links between nodes.
+  static Node* nodeOf(iterator pos) { return pos.current_; }
+  iterator insertEqual(const value_type& value);
+  template <typename RandomIt>
+  void buildFromSorted(RandomIt first, RandomIt last, unsigned threads = 1);
 
-  Node* createNode(const value_type& value);
-  void attachNodeToTree(Node* new_node, Node* parent);
-  void fixInsertion(Node* node);
+ private:
+  using KeyPrefix = tree_key_prefix_traits<Compare, T>;
+
+  static constexpr std::size_t kSearchLanes = 16;
+  static constexpr int kStatSamples = 64;
+  // Set algebra forks below nodes of this black height: at least 255
+  // nodes each, a few thousand in typical trees.
+  static constexpr int kParallelBlackHeight = 8;
+
+  // A detached red-black tree: its root has no parent and is black.
+  struct Part {
+    Node* root = nullptr;
+    int black_height = 0;
+  };
+
+  static int blackHeight(const Node* root);
+  size_type storedSize() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+  void storeSize(size_type size) const {
+    size_.store(size, std::memory_order_relaxed);
+  }
+  void adjustSize(difference_type delta);
+  static size_type addSizes(size_type lhs, size_type rhs);
+  template <typename K>
+  Node* splitInto(const K& key, RBTree& right, bool keep_key);
+  static Part detachChild(Node* child, int parent_height);
+  Part rootPart();
+  void adopt(Part part, size_type size);
+  Part joinParts(Part left, Node* mid, Part right);
+  Part joinParts(Part left, Part right);
+  std::pair<Part, Node*> splitLast(Part tree);
+  template <typename K>
+  std::pair<Part, Part> splitPart(Part tree, const K& key, Node*& found);
+  Part uniteParts(Part tree, const Node* other, int other_height,
+                  unsigned threads, size_type& added);
+  Part intersectParts(Part tree, const Node* other, int other_height,
+                      unsigned threads, size_type& kept);
+  Part subtractParts(Part tree, const Node* other, int other_height,
+                     unsigned threads, size_type& removed);
+  template <typename LeftTask, typename RightTask>
+  static void forkJoin(bool fork, LeftTask left_task, RightTask right_task);
+
+  template <typename K>
+  static key_prefix_type searchPrefix(const K& key);
+  template <typename K>
+  int compareToNode(const K& key, key_prefix_type prefix,
+                    const Node* node) const;
+
+  template <typename Keys, typename Visitor>
+  void lockstepSearch(const Keys& keys, Visitor visit) const;
+  static void splitSegments(Node* node, int depth,
+                            std::vector<Segment>& result);
+  std::size_t nodeAllocationSize() const;
+  void measureShape(tree_memory_stats& stats) const;
+  void sampleShape(tree_memory_stats& stats) const;
+
+  static Node* copyTree(const Node* source_node, Node* parent);
+  template <typename RandomIt>
+  static Node* buildSubtree(RandomIt first, size_type count, int depth,
+                            int red_depth, unsigned threads);
+  static void deleteTree(Node* node);
+
+  template <typename V>
+  Node* createNode(V&& value);
+  Node* rightmost() const;
+  // V is value_type, copied or moved into the new node.
+  template <typename V>
+  std::pair<iterator, bool> insertUnique(V&& value);
+  template <typename V>
+  iterator insertHinted(iterator hint, V&& value);
+  template <typename V>
+  iterator insertAt(Node* parent, bool as_left, V&& value);
+  void attachNodeToTree(Node* new_node, Node* parent, bool as_left);
+  bool fixInsertion(Node* node);
   void leftRotate(Node* node);
   void rightRotate(Node* node);
 
   void transplant(Node* u, Node* v);
   void deleteFixup(Node* x, Node* x_parent);
-  bool isRed(Node* node);
-  bool isBlack(Node* node);
-  void turnRed(Node* node);
-  void turnBlack(Node* node);
+
+  // Link access for rb_algorithms.
+  struct NodeTraits {
+    using node_ptr = Node*;
+    static Node* parent(Node* node) { return node->parent; }
+    static Node* left(Node* node) { return node->left; }
+    static Node* right(Node* node) { return node->right; }
+    static void setParent(Node* node, Node* parent) { node->parent = parent; }
+    static void setLeft(Node* node, Node* left) { node->left = left; }
+    static void setRight(Node* node, Node* right) { node->right = right; }
+    static bool isRed(Node* node) { return node->color == Node::RED; }
+    static void setRed(Node* node, bool red) {
+      node->color = red ? Node::RED : Node::BLACK;
+    }
+    static void copyBalance(Node* to, Node* from) {
+      to->color = from->color;
+      to->rank = from->rank;
+    }
+  };
+  using Algorithms = rb_algorithms<NodeTraits>;
 
  public:
   // Constructor, Insertion, and other methods...
@@ -78,28 +260,115 @@ class RBTree {
   void deleteNode(iterator pos);
 };
 
-template <typename T, typename Compare>
-class RBTree<T, Compare>::Node {
+// Tree::Cursor<Key> for tree cores that support finger search, void for
+// the others, so containers can name their cursor type for any storage.
+template <typename Tree, typename Key, typename Enable = void>
+struct cursor_traits {
+  using type = void;
+};
+
+template <typename Tree, typename Key>
+struct cursor_traits<Tree, Key,
+                     std::void_t<typename Tree::template Cursor<Key>>> {
+  using type = typename Tree::template Cursor<Key>;
+};
+
+template <typename T, typename Compare, typename Balance>
+class RBTree<T, Compare, Balance>::Node {
  public:
-  enum Color { RED, BLACK };
+  enum Color : std::uint8_t { RED, BLACK };
 
   T data;
   Node* parent;
   Node* left;
   Node* right;
   Color color;
+  // Height-like rank for the AVL and WAVL policies; 1 for a leaf.
+  std::uint8_t rank = 1;
+  // Sits in the padding after color; empty without key_prefix_traits.
+  KeyPrefixSlot<tree_key_prefix_traits<Compare, T>::value> key_prefix;
 
   Node(T val)
-      : data(val),
+      : data(std::move(val)),
         parent(nullptr),
         left(nullptr),
         right(nullptr),
-        color(Color::RED) {}
+        color(Color::RED) {
+    if constexpr (tree_key_prefix_traits<Compare, T>::value) {
+      key_prefix.value = tree_key_prefix_traits<Compare, T>::prefix(data);
+    }
+  }
+};
+
+// A contiguous slice of the in-order sequence: a single node or a whole
+// subtree. Segments returned by segments() cover the tree in order and can be
+// walked independently; a subtree walk uses its own stack instead of parent
+// pointers.
+template <typename T, typename Compare, typename Balance>
+class RBTree<T, Compare, Balance>::Segment {
+ public:
+  Segment(Node* node, bool whole_subtree)
+      : node_(node), whole_subtree_(whole_subtree) {}
+
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    if (!whole_subtree_) {
+      fn(node_->data);
+      return;
+    }
+    std::vector<Node*> stack;
+    Node* current = node_;
+    while (current || !stack.empty()) {
+      while (current) {
+        stack.push_back(current);
+        current = current->left;
+      }
+      current = stack.back();
+      stack.pop_back();
+      fn(current->data);
+      current = current->right;
+    }
+  }
+
+ private:
+  Node* node_;
+  bool whole_subtree_;
+};
+
+// A position that moves by key: each seek() starts from where the last one
+// stopped, so a batch of ascending keys (a sorted-key join) walks the tree
+// about once instead of descending from the root per key. Erasing the
+// element the cursor last stopped at invalidates it, as it does an iterator.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+class RBTree<T, Compare, Balance>::Cursor {
+ public:
+  explicit Cursor(const RBTree& tree) : tree_(&tree), node_(nullptr) {}
+
+  // Moves to the first element not less than key and tells whether it is
+  // equal to key. Past the last element valid() turns false, but the next
+  // seek still starts near the end rather than at the root.
+  bool seek(const K& key) {
+    Node* from = node_ ? node_ : (last_ ? last_ : tree_->root_);
+    node_ = from ? tree_->lowerBoundNear(from, key) : nullptr;
+    if (node_) last_ = node_;
+    return node_ && !tree_->comparator_(key, node_->data);
+  }
+
+  bool valid() const { return node_ != nullptr; }
+  iterator position() const { return node_ ? iterator(node_) : tree_->end(); }
+  T& operator*() const { return node_->data; }
+  T* operator->() const { return &node_->data; }
+
+ private:
+  const RBTree* tree_;
+  Node* node_;
+  Node* last_ = nullptr;  // last element visited, the finger past the end
 };
 
-template <typename T, typename Compare>
+template <typename T, typename Compare, typename Balance>
 template <bool IsConst>
-class RBTree<T, Compare>::RBTreeIteratorBase {
+class RBTree<T, Compare, Balance>::RBTreeIteratorBase {
   friend RBTree;
 
  public:
@@ -183,129 +452,317 @@ class RBTree<T, Compare>::RBTreeIteratorBase {
   Nodeptr root_;  // for end
 };
 
-template <typename T, typename Compare>
-RBTree<T, Compare>::RBTree() : root_(nullptr), size_(0) {}
+template <typename T, typename Compare, typename Balance>
+RBTree<T, Compare, Balance>::RBTree()
+    : root_(nullptr), rightmost_(nullptr), size_(0) {}
 
-template <typename T, typename Compare>
-RBTree<T, Compare>::RBTree(std::initializer_list<value_type> const& items)
+template <typename T, typename Compare, typename Balance>
+RBTree<T, Compare, Balance>::RBTree(
+    std::initializer_list<value_type> const& items)
     : RBTree() {
   for (const auto& i : items) {
     insert(i);
   }
 }
 
-template <typename T, typename Compare>
-RBTree<T, Compare>::RBTree(const RBTree& other)
-    : root_(nullptr), size_(other.size_) {
+template <typename T, typename Compare, typename Balance>
+RBTree<T, Compare, Balance>::RBTree(const RBTree& other)
+    : root_(nullptr), rightmost_(nullptr), size_(other.storedSize()) {
   if (other.root_) {
-    copyTree(other.root_, nullptr);
+    root_ = copyTree(other.root_, nullptr);
+    rightmost_ = rightmost();
   }
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::copyTree(const Node* source_node, Node* parent) {
-  if (source_node) {
-    Node* new_node = new Node(source_node->data);
-    new_node->color = source_node->color;
-    new_node->parent = parent;
+// Copies shape, colors and ranks node for node without comparing, so equal
+// keys in the multi containers keep their order. Walks the parent links
+// instead of recursing, as a splay tree can be a single long path.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::Node*
+RBTree<T, Compare, Balance>::copyTree(const Node* source_node, Node* parent) {
+  auto clone = [](const Node* source, Node* clone_parent) {
+    Node* node = new Node(source->data);
+    node->color = source->color;
+    node->rank = source->rank;
+    node->parent = clone_parent;
+    return node;
+  };
+  if (!source_node) {
+    return nullptr;
+  }
 
-    if (!root_) {
-      root_ = new_node;
-    } else {
-      if (comparator_(new_node->data, parent->data)) {
-        parent->left = new_node;
+  Node* root = clone(source_node, parent);
+  const Node* source = source_node;
+  Node* target = root;
+  try {
+    while (true) {
+      if (source->left && !target->left) {
+        target->left = clone(source->left, target);
+        source = source->left;
+        target = target->left;
+      } else if (source->right && !target->right) {
+        target->right = clone(source->right, target);
+        source = source->right;
+        target = target->right;
+      } else if (source != source_node) {
+        source = source->parent;
+        target = target->parent;
       } else {
-        parent->right = new_node;
+        return root;
+      }
+    }
+  } catch (...) {
+    deleteTree(root);
+    throw;
+  }
+}
+
+// Replaces the contents with the strictly increasing range [first, last) in
+// O(n) without comparisons. Every subtree is split at its middle element, so
+// all levels but the last are full: those nodes are black and the partial
+// last level is red. Extra threads link the upper subtrees concurrently.
+template <typename T, typename Compare, typename Balance>
+template <typename RandomIt>
+void RBTree<T, Compare, Balance>::buildFromSorted(RandomIt first, RandomIt last,
+                                         unsigned threads) {
+  clear();
+  size_type count = last - first;
+  if (!count) {
+    return;
+  }
+
+  int red_depth = 0;
+  while ((size_type(2) << red_depth) - 1 <= count) {
+    ++red_depth;
+  }
+
+  root_ = buildSubtree(first, count, 0, red_depth, threads);
+  root_->parent = nullptr;
+  rightmost_ = rightmost();
+  storeSize(count);
+}
+
+template <typename T, typename Compare, typename Balance>
+template <typename RandomIt>
+typename RBTree<T, Compare, Balance>::Node*
+RBTree<T, Compare, Balance>::buildSubtree(
+    RandomIt first, size_type count, int depth, int red_depth,
+    unsigned threads) {
+  constexpr size_type kParallelCutoff = 1 << 15;
+  if (!count) {
+    return nullptr;
+  }
+
+  size_type middle = count / 2;
+  Node* node = new Node(*(first + middle));
+  bool red = Balance::kUsesColor && depth == red_depth;
+  node->color = red ? Node::RED : Node::BLACK;
+
+  // A throwing copy frees whatever this call has built so far.
+  bool fork = threads > 1 && count >= kParallelCutoff;
+  unsigned left_threads = fork ? threads / 2 : 1;
+  unsigned right_threads = fork ? threads - threads / 2 : 1;
+  try {
+    forkJoin(
+        fork,
+        [&] {
+          node->left =
+              buildSubtree(first, middle, depth + 1, red_depth, left_threads);
+        },
+        [&] {
+          node->right = buildSubtree(first + middle + 1, count - middle - 1,
+                                     depth + 1, red_depth, right_threads);
+        });
+  } catch (...) {
+    deleteTree(node->left);
+    deleteTree(node->right);
+    delete node;
+    throw;
+  }
+
+  if (node->left) node->left->parent = node;
+  if (node->right) node->right->parent = node;
+  // Sibling subtrees differ in height by at most one: a valid AVL and
+  // WAVL rank.
+  node->rank = 1 + std::max(node->left ? node->left->rank : 0,
+                            node->right ? node->right->rank : 0);
+  return node;
+}
+
+// Writes the sorted contents in the format described in snapshot.h. Fixed
+// size elements are packed into 64 KiB blocks, one stream write per block.
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::save(std::ostream& os) const {
+  using Codec = SnapshotCodec<T>;
+  writeSnapshotHeader<T>(os, size());
+
+  if constexpr (Codec::kFixedSize) {
+    using Block = typename SnapshotBlockCodec<T>::type;
+    constexpr size_type kPerBlock =
+        std::max<size_type>(1, (1 << 16) / Block::kSize);
+    std::vector<char> block(kPerBlock * Block::kSize);
+    size_type used = 0;
+    for (auto it = begin(); it != end(); ++it) {
+      Block::encode(block.data() + used * Block::kSize, *it);
+      if (++used == kPerBlock) {
+        os.write(block.data(), used * Block::kSize);
+        used = 0;
+      }
+    }
+    os.write(block.data(), used * Block::kSize);
+  } else {
+    for (auto it = begin(); it != end(); ++it) {
+      Codec::write(os, *it);
+    }
+  }
+
+  if (!os) {
+    throw std::runtime_error("snapshot: write failed");
+  }
+}
+
+// Replaces the contents with a snapshot written by save(). The payload is
+// already sorted, so it is only checked for order and then linked by
+// buildFromSorted in O(n).
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::load(std::istream& is) {
+  using Codec = SnapshotCodec<T>;
+  std::uint64_t count = readSnapshotHeader<T>(is);
+
+  std::vector<typename Codec::plain_type> items;
+  items.reserve(std::min<std::uint64_t>(count, 1 << 20));
+  if constexpr (Codec::kFixedSize) {
+    using Block = typename SnapshotBlockCodec<T>::type;
+    constexpr size_type kPerBlock =
+        std::max<size_type>(1, (1 << 16) / Block::kSize);
+    std::vector<char> block(kPerBlock * Block::kSize);
+    while (is && items.size() < count) {
+      size_type wanted =
+          std::min<std::uint64_t>(kPerBlock, count - items.size());
+      is.read(block.data(), wanted * Block::kSize);
+      for (size_type i = 0; is && i < wanted; ++i) {
+        items.emplace_back();
+        Block::decode(block.data() + i * Block::kSize, items.back());
       }
     }
+  } else {
+    while (is && items.size() < count) {
+      items.emplace_back();
+      Codec::read(is, items.back());
+    }
+  }
 
-    copyTree(source_node->left, new_node);
-    copyTree(source_node->right, new_node);
+  if (!is) {
+    throw std::runtime_error("snapshot: truncated payload");
   }
+  for (size_type i = 1; i < items.size(); ++i) {
+    if (!comparator_(items[i - 1], items[i])) {
+      throw std::runtime_error("snapshot: payload is not strictly ascending");
+    }
+  }
+  buildFromSorted(items.begin(), items.end());
 }
 
-template <typename T, typename Compare>
-RBTree<T, Compare>::RBTree(RBTree&& other)
-    : root_(other.root_), size_(other.size_) {
+template <typename T, typename Compare, typename Balance>
+RBTree<T, Compare, Balance>::RBTree(RBTree&& other)
+    : root_(other.root_),
+      rightmost_(other.rightmost_),
+      size_(other.storedSize()) {
   other.root_ = nullptr;
-  other.size_ = 0;
+  other.rightmost_ = nullptr;
+  other.storeSize(0);
 }
 
-template <typename T, typename Compare>
-RBTree<T, Compare>& RBTree<T, Compare>::operator=(const RBTree& other) {
+template <typename T, typename Compare, typename Balance>
+RBTree<T, Compare, Balance>&
+RBTree<T, Compare, Balance>::operator=(const RBTree& other) {
   if (this == &other) {
     return *this;
   }
 
   clear();
   if (other.root_) {
-    copyTree(other.root_, nullptr);
-    size_ = other.size_;
+    root_ = copyTree(other.root_, nullptr);
+    rightmost_ = rightmost();
+    storeSize(other.storedSize());
   }
   return *this;
 }
 
-template <typename T, typename Compare>
-RBTree<T, Compare>& RBTree<T, Compare>::operator=(RBTree&& other) {
+template <typename T, typename Compare, typename Balance>
+RBTree<T, Compare, Balance>&
+RBTree<T, Compare, Balance>::operator=(RBTree&& other) {
   if (this == &other) {
     return *this;
   }
 
   clear();
   root_ = other.root_;
-  size_ = other.size_;
+  rightmost_ = other.rightmost_;
+  storeSize(other.storedSize());
   other.root_ = nullptr;
-  other.size_ = 0;
+  other.rightmost_ = nullptr;
+  other.storeSize(0);
   return *this;
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::clear() {
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::clear() {
   deleteTree(root_);
   root_ = nullptr;
-  size_ = 0;
-}
-
-template <typename T, typename Compare>
-void RBTree<T, Compare>::deleteTree(Node* node) {
-  if (node) {
-    deleteTree(node->left);
-    deleteTree(node->right);
-    delete node;
-  }
+  rightmost_ = nullptr;
+  storeSize(0);
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::helper(Node* node) {
-  if (node) {
-    // std::cout << node->data << "helper\n";
-    helper(node->left);
-    helper(node->right);
+// Rotates left children up until the node has none, then frees it and
+// moves right: O(n) with no stack, so a path-shaped splay tree is fine.
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::deleteTree(Node* node) {
+  while (node) {
+    if (Node* left = node->left) {
+      node->left = left->right;
+      left->right = node;
+      node = left;
+    } else {
+      Node* right = node->right;
+      delete node;
+      node = right;
+    }
   }
 }
 
-template <typename T, typename Compare>
-RBTree<T, Compare>::~RBTree() {
+template <typename T, typename Compare, typename Balance>
+RBTree<T, Compare, Balance>::~RBTree() {
   clear();
 }
 
-template <typename T, typename Compare>
-bool RBTree<T, Compare>::empty() const {
-  return size_ == 0;
+template <typename T, typename Compare, typename Balance>
+bool RBTree<T, Compare, Balance>::empty() const {
+  return root_ == nullptr;
 }
 
-template <typename T, typename Compare>
-typename RBTree<T, Compare>::size_type RBTree<T, Compare>::size() const {
-  return size_;
+// O(1), except for the first call after a split: that one counts the
+// nodes in O(n) and remembers the result.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::size_type
+RBTree<T, Compare, Balance>::size() const {
+  size_type size = storedSize();
+  if (size == kUnknownSize) {
+    size = std::distance(begin(), end());
+    storeSize(size);
+  }
+  return size;
 }
 
-template <typename T, typename Compare>
-typename RBTree<T, Compare>::size_type RBTree<T, Compare>::max_size() const {
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::size_type
+RBTree<T, Compare, Balance>::max_size() const {
   return std::numeric_limits<difference_type>::max() / sizeof(Node);
 }
 
-template <typename T, typename Compare>
-typename RBTree<T, Compare>::iterator RBTree<T, Compare>::begin() const {
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::begin() const {
   Node* current = root_;
   if (!current) {
     return iterator(nullptr, root_);
@@ -318,444 +775,1153 @@ typename RBTree<T, Compare>::iterator RBTree<T, Compare>::begin() const {
   return iterator(current);
 }
 
-template <typename T, typename Compare>
-typename RBTree<T, Compare>::iterator RBTree<T, Compare>::end() const {
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::end() const {
   return iterator(nullptr, root_);
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::swap(RBTree& other) {
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::swap(RBTree& other) {
   std::swap(root_, other.root_);
-  std::swap(size_, other.size_);
+  std::swap(rightmost_, other.rightmost_);
+  size_type size = storedSize();
+  storeSize(other.storedSize());
+  other.storeSize(size);
   std::swap(comparator_, other.comparator_);
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::merge(RBTree& other) {
-  RBTree<T, Compare> extra;
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::merge(RBTree& other) {
+  RBTree<T, Compare, Balance> extra;
   for (auto it = other.begin(); it != other.end(); ++it) {
     if (insert(*it).second == false) extra.insert(*it);
   }
   other = std::move(extra);
 }
 
-template <typename T, typename Compare>
-typename RBTree<T, Compare>::iterator RBTree<T, Compare>::find(
-    const T& key) const {
-  Node* current = root_;
+// Keeps the elements less than key and moves the greater ones into right,
+// replacing its contents; key itself is erased. O(log n): neither half
+// knows its size until the next size() call counts it in O(n).
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+bool RBTree<T, Compare, Balance>::split(const K& key, RBTree& right) {
+  Node* found = splitInto(key, right, false);
+  delete found;
+  return found != nullptr;
+}
 
-  while (current) {
-    if (comparator_(key, current->data)) {
-      current = current->left;
-    } else if (comparator_(current->data, key)) {
-      current = current->right;
-    } else {
-      return iterator(current);
-    }
+// Like split(), but an element equal to key moves into upper too.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+void RBTree<T, Compare, Balance>::split_at(const K& key, RBTree& upper) {
+  splitInto(key, upper, true);
+}
+
+// Appends key and then all of right, whose elements must order after key as
+// key must after this tree's; right is left empty. O(log n).
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::join(const value_type& key, RBTree& right) {
+  static_assert(std::is_same<Balance, rb_balance>::value,
+                "join() needs the red-black balancing policy");
+  if ((rightmost_ && !comparator_(rightmost_->data, key)) ||
+      (right.root_ && !comparator_(key, *right.begin()))) {
+    throw std::invalid_argument("join: keys out of order");
+  }
+  // Allocated before either tree is detached, so a throw leaves both as
+  // they were.
+  Node* mid = createNode(key);
+  Part joined = joinParts(rootPart(), mid, right.rootPart());
+  size_type size = addSizes(addSizes(storedSize(), 1), right.storedSize());
+  right.storeSize(0);
+  adopt(joined, size);
+}
+
+// join() without a middle element: the inverse of split_at(). O(log n).
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::concat(RBTree& right) {
+  static_assert(std::is_same<Balance, rb_balance>::value,
+                "concat() needs the red-black balancing policy");
+  if (&right == this || !right.root_) return;
+  if (rightmost_ && !comparator_(rightmost_->data, *right.begin())) {
+    throw std::invalid_argument("concat: keys out of order");
+  }
+  Part joined = joinParts(rootPart(), right.rootPart());
+  size_type size = addSizes(storedSize(), right.storedSize());
+  right.storeSize(0);
+  adopt(joined, size);
+}
+
+// Join-based set algebra (Blelloch, Ferizovic, Sun): the recursion follows
+// other and splits this tree at each of its keys, so combining m elements
+// with n costs O(m log(n/m + 1)) whichever is smaller. Independent halves
+// run on up to `threads` threads.
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::unite(const RBTree& other,
+                                        unsigned threads) {
+  static_assert(std::is_same<Balance, rb_balance>::value,
+                "unite() needs the red-black balancing policy");
+  if (&other == this) return;
+  size_type added = 0;
+  Part result;
+  try {
+    result = uniteParts(rootPart(), other.root_, blackHeight(other.root_),
+                        threads, added);
+  } catch (...) {
+    clear();
+    throw;
+  }
+  adopt(result, addSizes(storedSize(), added));
+}
+
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::intersect(const RBTree& other,
+                                            unsigned threads) {
+  static_assert(std::is_same<Balance, rb_balance>::value,
+                "intersect() needs the red-black balancing policy");
+  if (&other == this) return;
+  size_type kept = 0;
+  Part result;
+  try {
+    result = intersectParts(rootPart(), other.root_,
+                            blackHeight(other.root_), threads, kept);
+  } catch (...) {
+    clear();
+    throw;
+  }
+  adopt(result, kept);
+}
+
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::subtract(const RBTree& other,
+                                           unsigned threads) {
+  static_assert(std::is_same<Balance, rb_balance>::value,
+                "subtract() needs the red-black balancing policy");
+  if (&other == this) {
+    clear();
+    return;
+  }
+  size_type removed = 0;
+  Part result;
+  try {
+    result = subtractParts(rootPart(), other.root_,
+                           blackHeight(other.root_), threads, removed);
+  } catch (...) {
+    clear();
+    throw;
   }
-  return iterator(nullptr);
+  size_type size = storedSize();
+  adopt(result, size == kUnknownSize ? size : size - removed);
+}
+
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::find(const T& key) {
+  return findKey(key);
+}
+
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::find(iterator hint, const T& key) {
+  return findNear(hint, key);
 }
 
-template <typename T, typename Compare>
-bool RBTree<T, Compare>::contains(const T& key) const {
+template <typename T, typename Compare, typename Balance>
+bool RBTree<T, Compare, Balance>::contains(const T& key) {
   return find(key) != end();
 }
 
-//-------------
-template <typename T, typename Compare>
-std::pair<typename RBTree<T, Compare>::iterator, bool>
-RBTree<T, Compare>::insert(const value_type& value) {
-  Node* new_node = createNode(value);
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::find(const T& key) const {
+  return findKey(key);
+}
 
-  if (!new_node) {
-    throw std::bad_alloc();  // Handle allocation failure.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::find(iterator hint, const T& key) const {
+  return findNear(hint, key);
+}
+
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+key_prefix_type RBTree<T, Compare, Balance>::searchPrefix(
+    [[maybe_unused]] const K& key) {
+  if constexpr (KeyPrefix::value) {
+    return KeyPrefix::prefix(key);
+  } else {
+    return 0;
   }
+}
 
-  Node* parent = nullptr;
+// Orders key against the node. Different cached prefixes settle it
+// without reading node->data.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+int RBTree<T, Compare, Balance>::compareToNode(const K& key,
+                                      [[maybe_unused]] key_prefix_type prefix,
+                                      const Node* node) const {
+  if constexpr (KeyPrefix::value) {
+    if (prefix != node->key_prefix.value) {
+      return prefix < node->key_prefix.value ? -1 : 1;
+    }
+  }
+  return compareKeys(comparator_, key, node->data);
+}
+
+// Heterogeneous lookup: the comparator is called with the bare key, which
+// lets map search by Key without building a value_type. A self-adjusting
+// policy restructures the tree here.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::findKey(const K& key) {
   Node* current = root_;
+  Node* last = nullptr;
+  key_prefix_type prefix = searchPrefix(key);
+
   while (current) {
-    parent = current;
-    if (comparator_(new_node->data, current->data)) {
+    last = current;
+    int order = compareToNode(key, prefix, current);
+    if (order < 0) {
       current = current->left;
-    } else if (comparator_(current->data, new_node->data)) {
+    } else if (order > 0) {
       current = current->right;
     } else {
-      return std::make_pair(iterator(current), false);
+      break;
     }
   }
+  if constexpr (Balance::kSelfAdjusting) {
+    // A miss adjusts at the last node visited, as the amortized bound needs.
+    if (last) Balance::afterAccess(*this, last);
+  }
+  return iterator(current);
+}
 
-  attachNodeToTree(new_node, parent);
-  fixInsertion(new_node);
-
-  ++size_;
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::findKey(const K& key) const {
+  static_assert(!Balance::kSelfAdjusting,
+                "a splay tree restructures on lookup: search a non-const one");
+  Node* current = root_;
+  key_prefix_type prefix = searchPrefix(key);
+  while (current) {
+    int order = compareToNode(key, prefix, current);
+    if (order == 0) break;
+    current = order < 0 ? current->left : current->right;
+  }
+  return iterator(current);
+}
 
-  return std::make_pair(iterator(new_node), true);
+// First element not less than key.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::lowerBoundKey(const K& key) const {
+  Node* current = root_;
+  Node* result = nullptr;
+  while (current) {
+    if (comparator_(current->data, key)) {
+      current = current->right;
+    } else {
+      result = current;
+      current = current->left;
+    }
+  }
+  return result ? iterator(result) : end();
 }
 
-template <typename T, typename Compare>
-typename RBTree<T, Compare>::Node* RBTree<T, Compare>::createNode(
-    const value_type& value) {
-  Node* new_node = new Node(value);
-  if (!new_node) {
-    throw std::bad_alloc();  // Handle allocation failure.
+// First element greater than key.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::upperBoundKey(const K& key) const {
+  Node* current = root_;
+  Node* result = nullptr;
+  while (current) {
+    if (comparator_(key, current->data)) {
+      result = current;
+      current = current->left;
+    } else {
+      current = current->right;
+    }
   }
-  new_node->color = Node::RED;  // New nodes are initially red.
-  return new_node;
+  return result ? iterator(result) : end();
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::attachNodeToTree(Node* new_node, Node* parent) {
-  new_node->parent = parent;
-  if (!parent) {
-    // The tree was empty; new_node becomes the root.
-    root_ = new_node;
-  } else if (comparator_(new_node->data, parent->data)) {
-    parent->left = new_node;
+// Finger search: starts at hint instead of the root when hint is not
+// end(). A splay tree already keeps the last key it touched at the root,
+// so there it is a plain find.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::findNear(iterator hint, const K& key) {
+  if constexpr (Balance::kSelfAdjusting) {
+    return findKey(key);
   } else {
-    parent->right = new_node;
+    return std::as_const(*this).findNear(hint, key);
   }
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::fixInsertion(Node* node) {
-  while (node != root_ && node->parent->color == Node::RED) {
-    if (node->parent == node->parent->parent->left) {
-      Node* uncle = node->parent->parent->right;
-      if (uncle && uncle->color == Node::RED) {
-        // Case 1: Uncle is red; recolor and move up.
-        node->parent->color = Node::BLACK;
-        uncle->color = Node::BLACK;
-        node->parent->parent->color = Node::RED;
-        node = node->parent->parent;
-      } else {
-        if (node == node->parent->right) {
-          // Case 2: Node is the right child; left-rotate and transform to
-          // case 3.
-          node = node->parent;
-          leftRotate(node);
-        }
-        // Case 3: Node is the left child; recolor and right-rotate the
-        // grandparent.
-        node->parent->color = Node::BLACK;
-        node->parent->parent->color = Node::RED;
-        rightRotate(node->parent->parent);
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::findNear(iterator hint, const K& key) const {
+  if (!hint.current_) {
+    return findKey(key);
+  }
+  Node* node = lowerBoundNear(hint.current_, key);
+  if (node && !comparator_(key, node->data)) {
+    return iterator(node);
+  }
+  return end();
+}
+
+// First element not less than key, searched from finger: climbs only until
+// an ancestor bounds key on the far side, then descends from there. For a
+// key d positions away that is O(log d) levels in each direction, except
+// when the climb has to cross a high ancestor between the two; over keys
+// visited in ascending or descending order each edge is climbed and
+// descended at most once, as in an in-order walk.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+typename RBTree<T, Compare, Balance>::Node*
+RBTree<T, Compare, Balance>::lowerBoundNear(Node* finger,
+                                            const K& key) const {
+  key_prefix_type prefix = searchPrefix(key);
+  int order = compareToNode(key, prefix, finger);
+  if (order == 0) {
+    return finger;
+  }
+
+  // result is the smallest element known to be >= key outside the subtree
+  // the descent starts from.
+  Node* node = finger;
+  Node* result = nullptr;
+  while (Node* parent = node->parent) {
+    bool from_left = parent->left == node;
+    if (from_left == (order > 0)) {
+      int bound = compareToNode(key, prefix, parent);
+      if (bound == 0) {
+        return parent;
       }
+      if ((bound < 0) == from_left) {
+        result = from_left ? parent : nullptr;
+        break;
+      }
+    }
+    node = parent;
+  }
+
+  while (node) {
+    int step = compareToNode(key, prefix, node);
+    if (step > 0) {
+      node = node->right;
     } else {
-      // Same cases as above with "left" and "right" swapped.
-      Node* uncle = node->parent->parent->left;
-      if (uncle && uncle->color == Node::RED) {
-        // Case 1
-        node->parent->color = Node::BLACK;
-        uncle->color = Node::BLACK;
-        node->parent->parent->color = Node::RED;
-        node = node->parent->parent;
-      } else {
-        if (node == node->parent->left) {
-          // Case 2
-          node = node->parent;
-          rightRotate(node);
+      result = node;
+      if (step == 0) break;
+      node = node->left;
+    }
+  }
+  return result;
+}
+
+template <typename T, typename Compare, typename Balance>
+bool RBTree<T, Compare, Balance>::contains(const T& key) const {
+  return find(key) != end();
+}
+
+// Writes one iterator per key (end() when missing), in key order.
+template <typename T, typename Compare, typename Balance>
+template <typename Keys, typename OutputIt>
+OutputIt
+RBTree<T, Compare, Balance>::find_many(const Keys& keys, OutputIt out) const {
+  lockstepSearch(keys, [this, &out](Node* node) {
+    *out++ = node ? iterator(node) : end();
+  });
+  return out;
+}
+
+template <typename T, typename Compare, typename Balance>
+template <typename Keys, typename OutputIt>
+OutputIt RBTree<T, Compare, Balance>::contains_many(const Keys& keys,
+                                           OutputIt out) const {
+  lockstepSearch(keys, [&out](Node* node) { *out++ = node != nullptr; });
+  return out;
+}
+
+// Runs up to kSearchLanes independent descents side by side. Each round moves
+// every unfinished lane one level down and prefetches the child it will read
+// next round, so the cache misses of different keys overlap instead of
+// queueing behind each other.
+template <typename T, typename Compare, typename Balance>
+template <typename Keys, typename Visitor>
+void RBTree<T, Compare, Balance>::lockstepSearch(const Keys& keys,
+                                        Visitor visit) const {
+  auto first = std::begin(keys);
+  auto last = std::end(keys);
+  using KeyType = std::remove_reference_t<decltype(*first)>;
+
+  while (first != last) {
+    const KeyType* lane_key[kSearchLanes];
+    key_prefix_type lane_prefix[kSearchLanes];
+    Node* lane_node[kSearchLanes];
+    Node* found[kSearchLanes];
+    std::size_t lanes = 0;
+    for (; first != last && lanes < kSearchLanes; ++first, ++lanes) {
+      lane_key[lanes] = &*first;
+      lane_prefix[lanes] = searchPrefix(*first);
+      lane_node[lanes] = root_;
+      found[lanes] = nullptr;
+    }
+
+    bool pending = root_ != nullptr;
+    while (pending) {
+      pending = false;
+      for (std::size_t i = 0; i < lanes; ++i) {
+        Node* node = lane_node[i];
+        if (!node) continue;
+        int order = compareToNode(*lane_key[i], lane_prefix[i], node);
+        if (order < 0) {
+          node = node->left;
+        } else if (order > 0) {
+          node = node->right;
+        } else {
+          found[i] = node;
+          node = nullptr;
+        }
+        if (node) {
+          prefetchNode(node);
+          pending = true;
         }
-        // Case 3
-        node->parent->color = Node::BLACK;
-        node->parent->parent->color = Node::RED;
-        leftRotate(node->parent->parent);
+        lane_node[i] = node;
       }
     }
-  }
 
-  root_->color = Node::BLACK;  // Ensure the root is always black.
+    for (std::size_t i = 0; i < lanes; ++i) visit(found[i]);
+  }
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::leftRotate(Node* node) {
-  Node* right_child = node->right;
-  node->right = right_child->left;
+// Cuts the tree into at most max_count ordered segments: the top levels are
+// emitted node by node and everything below becomes whole-subtree segments.
+template <typename T, typename Compare, typename Balance>
+std::vector<typename RBTree<T, Compare, Balance>::Segment>
+RBTree<T, Compare, Balance>::segments(size_type max_count) const {
+  int depth = 0;
+  while ((size_type(4) << depth) <= max_count + 1) {
+    ++depth;
+  }
+  std::vector<Segment> result;
+  splitSegments(root_, depth, result);
+  return result;
+}
 
-  if (right_child->left) {
-    right_child->left->parent = node;
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::splitSegments(Node* node, int depth,
+                                       std::vector<Segment>& result) {
+  if (!node) {
+    return;
+  }
+  if (depth == 0) {
+    result.emplace_back(node, true);
+    return;
   }
+  splitSegments(node->left, depth - 1, result);
+  result.emplace_back(node, false);
+  splitSegments(node->right, depth - 1, result);
+}
 
-  right_child->parent = node->parent;
+template <typename T, typename Compare, typename Balance>
+tree_memory_stats
+RBTree<T, Compare, Balance>::memory_stats(stats_mode mode) const {
+  tree_memory_stats stats;
+  stats.node_count = size();
+  stats.bytes_per_node = nodeAllocationSize();
+  stats.bytes = sizeof(*this) + size() * stats.bytes_per_node;
+  if (!root_) {
+    return stats;
+  }
 
-  if (!node->parent) {
-    // Node was the root; update the root.
-    root_ = right_child;
-  } else if (node == node->parent->left) {
-    node->parent->left = right_child;
+  if constexpr (Balance::kUsesColor) {
+    // Every path has the same number of black nodes; the leftmost will do.
+    stats.black_height = blackHeight(root_);
+  }
+  if (mode == stats_mode::full) {
+    measureShape(stats);
   } else {
-    node->parent->right = right_child;
+    sampleShape(stats);
   }
+  return stats;
+}
 
-  right_child->left = node;
-  node->parent = right_child;
+// What the allocator really hands out per node: glibc reports the usable
+// size, to which its chunk header is added. Elsewhere the node size is
+// rounded up the same way as an estimate.
+template <typename T, typename Compare, typename Balance>
+std::size_t RBTree<T, Compare, Balance>::nodeAllocationSize() const {
+#if defined(__GLIBC__)
+  if (root_) {
+    return ::malloc_usable_size(root_) + sizeof(std::size_t);
+  }
+#endif
+  constexpr std::size_t kAlign = alignof(std::max_align_t);
+  return (sizeof(Node) + sizeof(std::size_t) + kAlign - 1) / kAlign * kAlign;
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::rightRotate(Node* node) {
-  Node* left_child = node->left;
-  node->left = left_child->right;
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::measureShape(tree_memory_stats& stats) const {
+  std::vector<std::pair<const Node*, int>> stack = {{root_, 1}};
+  std::size_t nodes = 0;
+  std::size_t depth_sum = 0;
+  std::size_t reds = 0;
+  while (!stack.empty()) {
+    auto [node, depth] = stack.back();
+    stack.pop_back();
+    ++nodes;
+    depth_sum += depth;
+    reds += node->color == Node::RED;
+    stats.height = std::max(stats.height, depth);
+    if (node->left) stack.emplace_back(node->left, depth + 1);
+    if (node->right) stack.emplace_back(node->right, depth + 1);
+  }
+  stats.node_count = nodes;
+  stats.average_depth = static_cast<double>(depth_sum) / nodes;
+  if constexpr (Balance::kUsesColor) {
+    stats.red_ratio = static_cast<double>(reds) / nodes;
+  }
+}
 
-  if (left_child->right) {
-    left_child->right->parent = node;
+// Knuth's estimator: a descent that picks a child uniformly at random, with
+// each visited node weighted by the product of the branching factors above
+// it, gives unbiased sums over the whole tree. The ratios of the summed
+// depths and red nodes to the summed node count are then close to the
+// exact values. The seed is fixed, so an unchanged tree reports the same
+// numbers every time.
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::sampleShape(tree_memory_stats& stats) const {
+  std::uint64_t state = 0x9e3779b97f4a7c15ULL;
+  double nodes = 0;
+  double depth_sum = 0;
+  double reds = 0;
+  for (int sample = 0; sample < kStatSamples; ++sample) {
+    double weight = 1;
+    int depth = 1;
+    const Node* node = root_;
+    while (true) {
+      nodes += weight;
+      depth_sum += weight * depth;
+      reds += node->color == Node::RED ? weight : 0;
+      stats.height = std::max(stats.height, depth);
+
+      const Node* next = node->left ? node->left : node->right;
+      if (!next) {
+        break;
+      }
+      if (node->left && node->right) {
+        weight *= 2;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        next = state & 1 ? node->right : node->left;
+      }
+      node = next;
+      ++depth;
+    }
+  }
+  stats.average_depth = depth_sum / nodes;
+  if constexpr (Balance::kUsesColor) {
+    stats.red_ratio = reds / nodes;
   }
+  stats.sampled = true;
+}
 
-  left_child->parent = node->parent;
+//-------------
+template <typename T, typename Compare, typename Balance>
+template <typename V>
+std::pair<typename RBTree<T, Compare, Balance>::iterator, bool>
+RBTree<T, Compare, Balance>::insertUnique(V&& value) {
+  if (rightmost_ && comparator_(rightmost_->data, value)) {
+    // Append fast path: a new maximum always goes right of the old one.
+    return std::make_pair(
+        insertAt(rightmost_, false, std::forward<V>(value)), true);
+  }
 
-  if (!node->parent) {
-    // Node was the root; update the root.
-    root_ = left_child;
-  } else if (node == node->parent->right) {
-    node->parent->right = left_child;
-  } else {
-    node->parent->left = left_child;
+  Node* parent = nullptr;
+  Node* current = root_;
+  bool as_left = false;
+  key_prefix_type prefix = searchPrefix(value);
+  while (current) {
+    parent = current;
+    int order = compareToNode(value, prefix, current);
+    if (order < 0) {
+      current = current->left;
+      as_left = true;
+    } else if (order > 0) {
+      current = current->right;
+      as_left = false;
+    } else {
+      return std::make_pair(iterator(current), false);
+    }
   }
 
-  left_child->right = node;
-  node->parent = left_child;
+  return std::make_pair(insertAt(parent, as_left, std::forward<V>(value)),
+                        true);
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::erase(iterator pos) {
-  deleteNode(pos);
+// Inserts after every element equal to value, so equal keys stay in
+// insertion order. Used by multiset and multimap.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::insertEqual(const value_type& value) {
+  if (rightmost_ && !comparator_(value, rightmost_->data)) {
+    return insertAt(rightmost_, false, value);
+  }
+
+  Node* parent = nullptr;
+  Node* current = root_;
+  bool as_left = false;
+  while (current) {
+    parent = current;
+    as_left = comparator_(value, current->data);
+    current = as_left ? current->left : current->right;
+  }
+  return insertAt(parent, as_left, value);
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::deleteNode(int key) {
-  Node* z = root_;
-  while (z != nullptr) {
-    if (key == z->data) {
-      break;
-    } else if (key < z->data) {
-      z = z->left;
-    } else {
-      z = z->right;
+// Checks the free slots on both sides of the hint first; when the value
+// belongs there it is attached without searching from root_, so runs of
+// nearly sorted input cost amortized O(1) each. A wrong hint falls back to
+// the regular insert.
+template <typename T, typename Compare, typename Balance>
+template <typename V>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::insertHinted(iterator hint, V&& value) {
+  Node* pos = hint.current_;
+
+  if (!pos) {
+    if (rightmost_ && comparator_(rightmost_->data, value)) {
+      return insertAt(rightmost_, false, std::forward<V>(value));
     }
+  } else if (comparator_(value, pos->data)) {
+    iterator before(pos);
+    --before;
+    if (!before.current_) {
+      return insertAt(pos, true, std::forward<V>(value));
+    }
+    if (comparator_(*before, value)) {
+      return before.current_->right
+                 ? insertAt(pos, true, std::forward<V>(value))
+                 : insertAt(before.current_, false, std::forward<V>(value));
+    }
+  } else if (comparator_(pos->data, value)) {
+    iterator after(pos);
+    ++after;
+    if (!after.current_) {
+      return insertAt(pos, false, std::forward<V>(value));
+    }
+    if (comparator_(value, *after)) {
+      return pos->right ? insertAt(after.current_, true, std::forward<V>(value))
+                        : insertAt(pos, false, std::forward<V>(value));
+    }
+  } else {
+    return hint;
   }
 
-  if (z == nullptr) {
-    // Node with the given key not found
-    return;
+  return insertUnique(std::forward<V>(value)).first;
+}
+
+template <typename T, typename Compare, typename Balance>
+template <typename... Args>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::emplace_hint(iterator hint, Args&&... args) {
+  return insert(hint, value_type(std::forward<Args>(args)...));
+}
+
+// The caller guarantees value is greater than every stored key; only
+// debug builds check it.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::push_back_ordered(const value_type& value) {
+  assert((!rightmost_ || comparator_(rightmost_->data, value)) &&
+         "push_back_ordered: value is not greater than the current maximum");
+  return insertAt(rightmost_, false, value);
+}
+
+template <typename T, typename Compare, typename Balance>
+template <typename V>
+typename RBTree<T, Compare, Balance>::iterator
+RBTree<T, Compare, Balance>::insertAt(Node* parent, bool as_left, V&& value) {
+  Node* new_node = createNode(std::forward<V>(value));
+  attachNodeToTree(new_node, parent, as_left);
+  if (parent == rightmost_ && !as_left) {
+    rightmost_ = new_node;
   }
+  Balance::afterInsert(*this, new_node);
 
-  Node* y = z;
-  typename Node::Color y_original_color = y->color;
-  Node* x;
+  adjustSize(1);
 
-  if (z->left == nullptr) {
-    x = z->right;
-    transplant(z, z->right);
-  } else if (z->right == nullptr) {
-    x = z->left;
-    transplant(z, z->left);
-  } else {
-    y = z->right;
-    while (y->left != nullptr) {
-      y = y->left;
-    }
-    y_original_color = y->color;
-    x = y->right;
+  return iterator(new_node);
+}
 
-    if (y->parent == z) {
-      if (x) x->parent = y;
-    } else {
-      transplant(y, y->right);
-      y->right = z->right;
-      y->right->parent = y;
-    }
+// Black nodes on the path from root down to a null child.
+template <typename T, typename Compare, typename Balance>
+int RBTree<T, Compare, Balance>::blackHeight(const Node* root) {
+  int height = 0;
+  for (; root; root = root->left) height += root->color == Node::BLACK;
+  return height;
+}
+
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::adjustSize(difference_type delta) {
+  size_type size = storedSize();
+  if (size != kUnknownSize) storeSize(size + delta);
+}
 
-    transplant(z, y);
-    y->left = z->left;
-    y->left->parent = y;
-    y->color = z->color;
+// A sum with an unknown size stays unknown.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::size_type
+RBTree<T, Compare, Balance>::addSizes(size_type lhs, size_type rhs) {
+  return lhs == kUnknownSize || rhs == kUnknownSize ? kUnknownSize
+                                                    : lhs + rhs;
+}
+
+// Moves the elements greater than key (and equal to it with keep_key) into
+// right and returns the node equal to key if it was cut out instead.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+typename RBTree<T, Compare, Balance>::Node*
+RBTree<T, Compare, Balance>::splitInto(const K& key, RBTree& right,
+                                       bool keep_key) {
+  static_assert(std::is_same<Balance, rb_balance>::value,
+                "splitting needs the red-black balancing policy");
+  if (&right == this) {
+    throw std::invalid_argument("split: target is the source tree");
+  }
+  Node* found = nullptr;
+  Part whole = rootPart();
+  Part less, greater;
+  try {
+    std::tie(less, greater) = splitPart(whole, key, found);
+  } catch (...) {
+    deleteTree(whole.root);
+    clear();
+    throw;
   }
+  if (found && keep_key) {
+    greater = joinParts(Part(), found, greater);
+    found = nullptr;
+  }
+  // Counting either half would cost O(n), so only an empty half tells.
+  size_type total = storedSize();
+  if (found && total != kUnknownSize) --total;
+  right.clear();
+  right.adopt(greater, !greater.root ? 0 : !less.root ? total : kUnknownSize);
+  adopt(less, !less.root ? 0 : !greater.root ? total : kUnknownSize);
+  return found;
+}
 
-  if (y_original_color == Node::BLACK) {
-    if (x != nullptr) {
-      deleteFixup(x, x->parent);
-    } else {
-      deleteFixup(x, z->parent);
-    }
+// Cuts child off its black parent of black height parent_height; a red
+// child turns black and grows a level.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::Part
+RBTree<T, Compare, Balance>::detachChild(Node* child, int parent_height) {
+  if (!child) return Part();
+  child->parent = nullptr;
+  int height = parent_height - 1 + (child->color == Node::RED);
+  child->color = Node::BLACK;
+  return Part{child, height};
+}
+
+// Hands the nodes over as a Part; adopt() takes one back with its size.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::Part
+RBTree<T, Compare, Balance>::rootPart() {
+  Part part{root_, blackHeight(root_)};
+  root_ = rightmost_ = nullptr;
+  return part;
+}
+
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::adopt(Part part, size_type size) {
+  root_ = part.root;
+  storeSize(size);
+  rightmost_ = rightmost();
+}
+
+// Links left < mid < right. The shorter tree hangs next to the node of
+// equal black height on the taller tree's inner spine, under mid painted
+// red; the usual insert fixup then repairs a red-red edge. O(difference in
+// black heights).
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::Part
+RBTree<T, Compare, Balance>::joinParts(Part left, Node* mid, Part right) {
+  mid->parent = nullptr;
+  if (left.black_height == right.black_height) {
+    mid->left = left.root;
+    mid->right = right.root;
+    if (left.root) left.root->parent = mid;
+    if (right.root) right.root->parent = mid;
+    mid->color = Node::BLACK;
+    return Part{mid, left.black_height + 1};
   }
 
-  delete z;
-  --size_;
+  bool left_taller = left.black_height > right.black_height;
+  Part tall = left_taller ? left : right;
+  Part low = left_taller ? right : left;
+  Node* spine = tall.root;
+  Node* parent = nullptr;
+  int height = tall.black_height;
+  while (spine && !(spine->color == Node::BLACK &&
+                    height == low.black_height)) {
+    height -= spine->color == Node::BLACK;
+    parent = spine;
+    spine = left_taller ? spine->right : spine->left;
+  }
+  mid->color = Node::RED;
+  mid->parent = parent;
+  (left_taller ? parent->right : parent->left) = mid;
+  (left_taller ? mid->left : mid->right) = spine;
+  (left_taller ? mid->right : mid->left) = low.root;
+  if (spine) spine->parent = mid;
+  if (low.root) low.root->parent = mid;
+
+  RBTree work;
+  work.root_ = tall.root;
+  int joined_height = tall.black_height + work.fixInsertion(mid);
+  Node* root = work.root_;
+  work.root_ = nullptr;
+  return Part{root, joined_height};
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::deleteNode(iterator pos) {
-  if (pos == end()) {
-    return;
+// Join without a middle key: the maximum of left serves as one.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::Part
+RBTree<T, Compare, Balance>::joinParts(Part left, Part right) {
+  if (!left.root) return right;
+  if (!right.root) return left;
+  auto [rest, last] = splitLast(left);
+  return joinParts(rest, last, right);
+}
+
+template <typename T, typename Compare, typename Balance>
+std::pair<typename RBTree<T, Compare, Balance>::Part,
+          typename RBTree<T, Compare, Balance>::Node*>
+RBTree<T, Compare, Balance>::splitLast(Part tree) {
+  Node* root = tree.root;
+  Part left = detachChild(root->left, tree.black_height);
+  if (!root->right) return {left, root};
+  auto [rest, last] =
+      splitLast(detachChild(root->right, tree.black_height));
+  return {joinParts(left, root, rest), last};
+}
+
+// Splits tree into the keys less and greater than key and hands the node
+// equal to it, if any, back in found. The joins on the way up telescope to
+// O(log n) in total. Only the comparison can throw, and it runs before any
+// join, so after a throw the child links of tree are intact and
+// deleteTree(tree.root) frees every node.
+template <typename T, typename Compare, typename Balance>
+template <typename K>
+std::pair<typename RBTree<T, Compare, Balance>::Part,
+          typename RBTree<T, Compare, Balance>::Part>
+RBTree<T, Compare, Balance>::splitPart(Part tree, const K& key,
+                                       Node*& found) {
+  Node* node = tree.root;
+  if (!node) return {Part(), Part()};
+  Part left = detachChild(node->left, tree.black_height);
+  Part right = detachChild(node->right, tree.black_height);
+  int order = compareKeys(comparator_, key, node->data);
+  if (order == 0) {
+    found = node;
+    return {left, right};
   }
-  Node* z = pos.current_;
+  if (order < 0) {
+    auto [less, greater] = splitPart(left, key, found);
+    return {less, joinParts(greater, node, right)};
+  }
+  auto [less, greater] = splitPart(right, key, found);
+  return {joinParts(left, node, less), greater};
+}
 
-  Node* y = z;
-  typename Node::Color y_original_color = y->color;
-  Node* x;
-  std::cout << "delete node started \n"
-            << (y_original_color == Node::BLACK ? 1 : 0);
-
-  if (z->left == nullptr) {
-    x = z->right;
-    transplant(z, z->right);
-  } else if (z->right == nullptr) {
-    x = z->left;
-    transplant(z, z->left);
-  } else {
-    y = z->right;
-    while (y->left != nullptr) {
-      y = y->left;
+// Runs both tasks, left_task on a worker thread if fork is set. Either may
+// throw: the worker's exception is carried over with an exception_ptr and
+// rethrown after the join, the left one first.
+template <typename T, typename Compare, typename Balance>
+template <typename LeftTask, typename RightTask>
+void RBTree<T, Compare, Balance>::forkJoin(bool fork, LeftTask left_task,
+                                           RightTask right_task) {
+  if (!fork) {
+    left_task();
+    right_task();
+    return;
+  }
+  std::exception_ptr left_error, right_error;
+  std::thread worker([&] {
+    try {
+      left_task();
+    } catch (...) {
+      left_error = std::current_exception();
     }
-    y_original_color = y->color;
-    x = y->right;
+  });
+  try {
+    right_task();
+  } catch (...) {
+    right_error = std::current_exception();
+  }
+  worker.join();
+  if (left_error) std::rethrow_exception(left_error);
+  if (right_error) std::rethrow_exception(right_error);
+}
 
-    if (y->parent == z) {
-      if (x) x->parent = y;
-    } else {
-      transplant(y, y->right);
-      y->right = z->right;
-      y->right->parent = y;
-    }
+// The three recursions below split tree at other's root and recurse into
+// other's children. Under a node at least kParallelBlackHeight high the two
+// halves are disjoint, so the left one runs on a worker thread.
+//
+// Each call owns the nodes of tree: it returns them in the result or, when
+// something throws (a comparison, a copy, a thread that cannot start),
+// deletes them before rethrowing. A task takes its half out of less or
+// greater as it starts, so on a throw whatever is still held there or in
+// left, right and found belongs to this call.
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::Part
+RBTree<T, Compare, Balance>::uniteParts(Part tree, const Node* other,
+                                        int other_height, unsigned threads,
+                                        size_type& added) {
+  if (!other) return tree;
+  if (!tree.root) {
+    Node* copy = copyTree(other, nullptr);
+    Node* first = copy;
+    while (first->left) first = first->left;
+    for (iterator it(first); it.current_; ++it) ++added;
+    copy->color = Node::BLACK;
+    return Part{copy, blackHeight(copy)};
+  }
 
-    transplant(z, y);
-    y->left = z->left;
-    y->left->parent = y;
-    y->color = z->color;
+  Node* found = nullptr;
+  Part less, greater, left, right;
+  try {
+    std::tie(less, greater) = splitPart(tree, other->data, found);
+  } catch (...) {
+    deleteTree(tree.root);
+    throw;
+  }
+  bool fork = threads > 1 && other_height >= kParallelBlackHeight;
+  unsigned left_threads = fork ? threads / 2 : 1;
+  unsigned right_threads = fork ? threads - threads / 2 : 1;
+  int child_height = other_height - (other->color == Node::BLACK);
+  size_type left_added = 0;
+  size_type right_added = 0;
+  try {
+    if (!found) {
+      found = createNode(other->data);
+      ++right_added;
+    }
+    forkJoin(
+        fork,
+        [&] {
+          left = uniteParts(std::exchange(less, Part()), other->left,
+                            child_height, left_threads, left_added);
+        },
+        [&] {
+          right = uniteParts(std::exchange(greater, Part()), other->right,
+                             child_height, right_threads, right_added);
+        });
+  } catch (...) {
+    for (Node* root : {less.root, greater.root, left.root, right.root}) {
+      deleteTree(root);
+    }
+    delete found;
+    throw;
   }
+  added += left_added + right_added;
+  return joinParts(left, found, right);
+}
 
-  std::cout << "delete node finshed "
-            << (y_original_color == Node::BLACK ? 1 : 0) << "\n";
-  if (y_original_color == Node::BLACK) {
-    if (x != nullptr) {
-      std::cout << "parent ";  // << x->parent->data.first;
-      deleteFixup(x, x->parent);
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::Part
+RBTree<T, Compare, Balance>::intersectParts(Part tree, const Node* other,
+                                            int other_height,
+                                            unsigned threads,
+                                            size_type& kept) {
+  if (!tree.root) return tree;
+  if (!other) {
+    deleteTree(tree.root);
+    return Part();
+  }
 
-    } else if (z->parent) {
-      std::cout << "no parent ";  // << z->parent->data;  //.first;
-      deleteFixup(x, z->parent);
+  Node* found = nullptr;
+  Part less, greater, left, right;
+  try {
+    std::tie(less, greater) = splitPart(tree, other->data, found);
+  } catch (...) {
+    deleteTree(tree.root);
+    throw;
+  }
+  bool fork = threads > 1 && other_height >= kParallelBlackHeight;
+  unsigned left_threads = fork ? threads / 2 : 1;
+  unsigned right_threads = fork ? threads - threads / 2 : 1;
+  int child_height = other_height - (other->color == Node::BLACK);
+  size_type left_kept = 0;
+  size_type right_kept = 0;
+  try {
+    forkJoin(
+        fork,
+        [&] {
+          left = intersectParts(std::exchange(less, Part()), other->left,
+                                child_height, left_threads, left_kept);
+        },
+        [&] {
+          right = intersectParts(std::exchange(greater, Part()),
+                                 other->right, child_height, right_threads,
+                                 right_kept);
+        });
+  } catch (...) {
+    for (Node* root : {less.root, greater.root, left.root, right.root}) {
+      deleteTree(root);
     }
+    delete found;
+    throw;
   }
+  kept += left_kept + right_kept;
+  if (!found) return joinParts(left, right);
+  ++kept;
+  return joinParts(left, found, right);
+}
 
-  delete z;
-  --size_;
-  helper(root_);
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::Part
+RBTree<T, Compare, Balance>::subtractParts(Part tree, const Node* other,
+                                           int other_height, unsigned threads,
+                                           size_type& removed) {
+  if (!tree.root || !other) return tree;
+
+  Node* found = nullptr;
+  Part less, greater, left, right;
+  try {
+    std::tie(less, greater) = splitPart(tree, other->data, found);
+  } catch (...) {
+    deleteTree(tree.root);
+    throw;
+  }
+  if (found) {
+    delete found;
+    ++removed;
+  }
+  bool fork = threads > 1 && other_height >= kParallelBlackHeight;
+  unsigned left_threads = fork ? threads / 2 : 1;
+  unsigned right_threads = fork ? threads - threads / 2 : 1;
+  int child_height = other_height - (other->color == Node::BLACK);
+  size_type left_removed = 0;
+  size_type right_removed = 0;
+  try {
+    forkJoin(
+        fork,
+        [&] {
+          left = subtractParts(std::exchange(less, Part()), other->left,
+                               child_height, left_threads, left_removed);
+        },
+        [&] {
+          right = subtractParts(std::exchange(greater, Part()), other->right,
+                                child_height, right_threads, right_removed);
+        });
+  } catch (...) {
+    for (Node* root : {less.root, greater.root, left.root, right.root}) {
+      deleteTree(root);
+    }
+    throw;
+  }
+  removed += left_removed + right_removed;
+  return joinParts(left, right);
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::transplant(Node* u, Node* v) {
-  if (u->parent == nullptr) {
-    root_ = v;
-  } else if (u == u->parent->left) {
-    u->parent->left = v;
-  } else {
-    u->parent->right = v;
+template <typename T, typename Compare, typename Balance>
+template <typename V>
+typename RBTree<T, Compare, Balance>::Node*
+RBTree<T, Compare, Balance>::createNode(V&& value) {
+  Node* new_node = new Node(std::forward<V>(value));
+  if (!new_node) {
+    throw std::bad_alloc();  // Handle allocation failure.
   }
-  if (v != nullptr) {
-    v->parent = u->parent;
+  new_node->color = Node::RED;  // New nodes are initially red.
+  return new_node;
+}
+
+template <typename T, typename Compare, typename Balance>
+typename RBTree<T, Compare, Balance>::Node*
+RBTree<T, Compare, Balance>::rightmost() const {
+  Node* node = root_;
+  while (node && node->right) {
+    node = node->right;
   }
+  return node;
 }
 
-template <typename T, typename Compare>
-bool RBTree<T, Compare>::isBlack(Node* node) {
-  return (!node || node->color == Node::BLACK);
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::attachNodeToTree(Node* new_node, Node* parent,
+                                          bool as_left) {
+  Algorithms::link(root_, new_node, parent, as_left);
 }
 
-template <typename T, typename Compare>
-bool RBTree<T, Compare>::isRed(Node* node) {
-  return !isBlack(node);
+// Returns whether the root had to be repainted black, which adds a level
+// to every path.
+template <typename T, typename Compare, typename Balance>
+bool RBTree<T, Compare, Balance>::fixInsertion(Node* node) {
+  return Algorithms::fixInsertion(root_, node);
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::turnRed(Node* node) {
-  node->color = Node::RED;
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::leftRotate(Node* node) {
+  Algorithms::rotateLeft(root_, node);
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::turnBlack(Node* node) {
-  if (node) node->color = Node::BLACK;  ////// SEGMENTATION FAULT????????
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::rightRotate(Node* node) {
+  Algorithms::rotateRight(root_, node);
 }
 
-template <typename T, typename Compare>
-void RBTree<T, Compare>::deleteFixup(Node* x, Node* x_parent) {
-  while (x != root_ && (x == nullptr || isBlack(x))) {
-    if (x == x_parent->left) {
-      Node* w = x_parent->right;  // x's sibling
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::erase(iterator pos) {
+  deleteNode(pos);
+}
 
-      if (isRed(w)) {
-        std::cout << "case 1\n";
-        // Case 1: x's sibling is red
-        turnBlack(w);
-        turnRed(x_parent);
-        leftRotate(x_parent);
-        w = x_parent->right;
-        std::cout << "case 1\n";
-      }
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::deleteNode(int key) {
+  deleteNode(findKey(key));
+}
 
-      if (isBlack(w->left) && isBlack(w->right)) {
-        // Case 2: x's sibling is black, and both of w's children
-        // are black
-        std::cout << "case 2\n";
-        w->color = Node::RED;
-        x = x_parent;
-      } else {
-        if (isBlack(w->right)) {
-          //  Case 3: x's sibling is black, w's left child is red, and w's
-          // right  child is black
-          std::cout << "case 3\n";
-          turnBlack(w->left);
-          w->color = Node::RED;
-          rightRotate(w);
-          w = x_parent->right;
-        }
+// Unlinks the node as in CLRS: a node with two children is replaced by its
+// successor y. If the node actually spliced out was black, x (possibly null)
+// carries an extra black that deleteFixup removes; x_parent is tracked
+// separately because x may be null.
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::deleteNode(iterator pos) {
+  if (pos == end()) {
+    return;
+  }
+  Node* z = pos.current_;
+  if (z == rightmost_) {
+    rightmost_ = (--iterator(z)).current_;
+  }
 
-        // Case 4: x's sibling is black, and w's right child is red
-        // std::cout << "case 4\n";
-        w->color = x_parent->color;
-        turnBlack(x_parent);
-        turnBlack(w->right);
-        leftRotate(x_parent);
-        x = root_;  // Terminate the loop
-      }
+  auto [x, x_parent, removed_red] = Algorithms::unlink(root_, z);
+  Balance::afterErase(*this, x, x_parent,
+                      removed_red ? Node::RED : Node::BLACK);
 
-    } else {
-      // // Symmetric cases for x being a right child
-      // Node* w = x_parent->left;  // x's sibling
-
-      // if (isRed(w)) {
-      //   std::cout << "case 1\n";
-      //   // Case 1: x's sibling is red
-      //   w->color = Node::BLACK;
-      //   x_parent->color = Node::RED;
-      //   rightRotate(x_parent);
-      //   w = x_parent->left;
-      //   std::cout << "case 1\n";
-      // }
-
-      // if (isBlack(w->right) && isBlack(w->left)) {
-      //   // Case 2: x's sibling is black, and both of w's children are black
-      //   w->color = Node::RED;
-      //   x = x_parent;
-      // } else {
-      //   if (isBlack(w->left)) {
-      //     // Case 3: x's sibling is black, w's right child is red, and w's
-      //     left
-      //     // child is black
-      //     w->right->color = Node::BLACK;
-      //     w->color = Node::RED;
-      //     leftRotate(w);
-      //     w = x_parent->left;
-      //   }
-
-      //   // Case 4: x's sibling is black, and w's left child is red
-      //   w->color = x_parent->color;
-      //   x_parent->color = Node::BLACK;
-      //   w->left->color = Node::BLACK;
-      //   rightRotate(x_parent);
-      x = root_;  // Terminate the loop
-      // }
-    }
-  }
-
-  if (x != nullptr) x->color = Node::BLACK;
+  delete z;
+  adjustSize(-1);
+}
+
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::transplant(Node* u, Node* v) {
+  Algorithms::transplant(root_, u, v);
+}
+
+// Pushes the extra black on x up the tree or absorbs it with at most three
+// rotations; the black height of every path is restored on exit.
+template <typename T, typename Compare, typename Balance>
+void RBTree<T, Compare, Balance>::deleteFixup(Node* x, Node* x_parent) {
+  Algorithms::deleteFixup(root_, x, x_parent);
 }
 
 }  // namespace s21
@@ -0,0 +1,54 @@
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+
+#ifndef tree_stats_h
+#define tree_stats_h
+
+namespace s21 {
+
+enum class stats_mode {
+  sampled,  // O(log n) random descents, cheap enough to poll
+  full      // walks every node
+};
+
+// Shape and footprint of a tree. Depths count nodes, so the root has depth 1
+// and a lookup that ends at depth d makes d comparisons; height is therefore
+// also the maximum search depth. In sampled mode average_depth and red_ratio
+// are estimates and height is the deepest path seen. black_height and
+// red_ratio are empty for balancing policies that do not color nodes.
+struct tree_memory_stats {
+  std::size_t node_count = 0;
+  // Nodes with allocator headers and padding, plus the tree object. Heap
+  // memory owned by the elements themselves is not included.
+  std::size_t bytes = 0;
+  std::size_t bytes_per_node = 0;
+  int height = 0;
+  std::optional<int> black_height;
+  double average_depth = 0;
+  std::optional<double> red_ratio;
+  bool sampled = false;
+};
+
+// Writes the stats in the Prometheus text exposition format, one gauge per
+// field, each named "<name>_<field>". Empty fields are left out.
+inline void write_metrics(std::ostream& os, const tree_memory_stats& stats,
+                          const std::string& name) {
+  os << name << "_nodes " << stats.node_count << '\n'
+     << name << "_bytes " << stats.bytes << '\n'
+     << name << "_bytes_per_node " << stats.bytes_per_node << '\n'
+     << name << "_height " << stats.height << '\n';
+  if (stats.black_height) {
+    os << name << "_black_height " << *stats.black_height << '\n';
+  }
+  os << name << "_average_depth " << stats.average_depth << '\n';
+  if (stats.red_ratio) {
+    os << name << "_red_ratio " << *stats.red_ratio << '\n';
+  }
+  os << name << "_sampled " << (stats.sampled ? 1 : 0) << '\n';
+}
+
+}  // namespace s21
+
+#endif
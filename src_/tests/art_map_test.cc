@@ -0,0 +1,142 @@
+#include "../s21_containers/art_map/art_map.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../s21_containers/art_set/art_set.h"
+
+namespace {
+
+// Short keys over a small alphabet, so many are prefixes of others.
+std::string randomKey(std::mt19937 &gen) {
+  std::string key(gen() % 6, 'a');
+  for (auto &c : key) c = static_cast<char>("ab\0\xff"[gen() % 4]);
+  return key;
+}
+
+}  // namespace
+
+TEST(ArtMapTest, MatchesStdMapUnderChurn) {
+  s21::art_map<std::string, int> s21_map;
+  std::map<std::string, int> std_map;
+  std::mt19937 gen(17);
+  for (int step = 0; step < 20000; ++step) {
+    std::string key = randomKey(gen);
+    if (gen() % 3) {
+      EXPECT_EQ(s21_map.insert(key, step).second,
+                std_map.insert({key, step}).second);
+    } else {
+      EXPECT_EQ(s21_map.erase(key), std_map.erase(key));
+    }
+  }
+  ASSERT_EQ(s21_map.size(), std_map.size());
+  EXPECT_TRUE(std::equal(s21_map.begin(), s21_map.end(), std_map.begin(),
+                         std_map.end()));
+  for (const auto &[key, value] : std_map) EXPECT_EQ(s21_map.at(key), value);
+
+  // Backwards from end() too.
+  auto it = s21_map.end();
+  for (auto std_it = std_map.rbegin(); std_it != std_map.rend(); ++std_it) {
+    EXPECT_EQ((--it)->first, std_it->first);
+  }
+
+  while (!s21_map.empty()) s21_map.erase(s21_map.begin());
+  EXPECT_EQ(s21_map.begin(), s21_map.end());
+}
+
+TEST(ArtMapTest, NodesGrowAndShrink) {
+  // Two-byte keys: 256 children under the root, then a handful again.
+  s21::art_map<std::uint16_t, int> s21_map;
+  for (int i = 0; i < 65536; i += 7) s21_map[static_cast<std::uint16_t>(i)] = i;
+  int expected = 0;
+  for (const auto &[key, value] : s21_map) {
+    EXPECT_EQ(key, expected);
+    EXPECT_EQ(value, expected);
+    expected += 7;
+  }
+  for (int i = 0; i < 65536; i += 7) {
+    if (i % 13) s21_map.erase(static_cast<std::uint16_t>(i));
+  }
+  std::vector<int> left;
+  for (const auto &item : s21_map) left.push_back(item.first);
+  ASSERT_EQ(left.size(), s21_map.size());
+  for (std::size_t i = 0; i < left.size(); ++i) EXPECT_EQ(left[i], 91 * i);
+  EXPECT_TRUE(s21_map.contains(0));
+  EXPECT_FALSE(s21_map.contains(7));
+}
+
+TEST(ArtMapTest, SignedKeysSortNumerically) {
+  s21::art_set<int> s21_set = {5, -1, 0, -300000, 42, 2147483647, -2147483647};
+  std::set<int> std_set = {5, -1, 0, -300000, 42, 2147483647, -2147483647};
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                         std_set.end()));
+  EXPECT_EQ(*s21_set.lower_bound(1), 5);
+  EXPECT_EQ(*s21_set.lower_bound(-2), -1);
+  EXPECT_EQ(s21_set.lower_bound(2147483647), --s21_set.end());
+}
+
+TEST(ArtMapTest, PrefixRangeAndLowerBound) {
+  s21::art_set<std::string> s21_set = {
+      "http://a.org/",      "http://a.org/x", "http://a.org/x/y",
+      "http://b.org/index", "http://",        "ftp://a.org/"};
+  std::set<std::string> std_set(s21_set.begin(), s21_set.end());
+
+  for (std::string prefix :
+       {"", "http", "http://a.org/", "http://a.org/x", "http://b", "http:/x",
+        "zz", "http://a.org/x/y/z"}) {
+    auto [first, last] = s21_set.prefix_range(prefix);
+    std::vector<std::string> got(first, last);
+    std::vector<std::string> want;
+    for (const auto &key : std_set) {
+      if (key.compare(0, prefix.size(), prefix) == 0) want.push_back(key);
+    }
+    EXPECT_EQ(got, want) << prefix;
+  }
+
+  std::mt19937 gen(5);
+  s21::art_set<std::string> random_set;
+  std::set<std::string> random_std;
+  for (int i = 0; i < 2000; ++i) {
+    std::string key = randomKey(gen);
+    random_set.insert(key);
+    random_std.insert(key);
+  }
+  for (int i = 0; i < 2000; ++i) {
+    std::string probe = randomKey(gen);
+    auto want = random_std.lower_bound(probe);
+    auto got = random_set.lower_bound(probe);
+    if (want == random_std.end()) {
+      EXPECT_EQ(got, random_set.end());
+    } else {
+      ASSERT_NE(got, random_set.end());
+      EXPECT_EQ(*got, *want);
+    }
+  }
+}
+
+TEST(ArtMapTest, CopyMoveAndMerge) {
+  s21::art_map<std::string, int> first = {{"one", 1}, {"two", 2}};
+  s21::art_map<std::string, int> copy(first);
+  copy["three"] = 3;
+  EXPECT_EQ(first.size(), 2u);
+  EXPECT_EQ(copy.size(), 3u);
+
+  s21::art_map<std::string, int> moved(std::move(copy));
+  EXPECT_EQ(moved.size(), 3u);
+  EXPECT_TRUE(copy.empty());
+
+  EXPECT_FALSE(first.insert_or_assign("one", 10).second);
+  EXPECT_EQ(first.at("one"), 10);
+  EXPECT_THROW(first.at("none"), std::out_of_range);
+
+  moved.merge(first);
+  EXPECT_EQ(moved.size(), 3u);
+  EXPECT_EQ(first.size(), 2u);
+  EXPECT_EQ(moved.at("one"), 1);
+}
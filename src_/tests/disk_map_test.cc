@@ -0,0 +1,180 @@
+#include "../s21_containers/disk_map/disk_map.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Small pages and a minimal cache force splits and evictions early.
+constexpr std::size_t kPageSize = 256;
+constexpr std::size_t kCachePages = 8;
+
+std::string freshPath(const std::string& name) {
+  std::string path = (std::filesystem::temp_directory_path() / name).string();
+  std::remove(path.c_str());
+  return path;
+}
+
+}  // namespace
+
+TEST(DiskMapTest, MatchesStdMap) {
+  std::string path = freshPath("s21_disk_map_random.bin");
+  s21::disk_map<int, long> disk(path, kCachePages, kPageSize);
+  std::map<int, long> reference;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> dist(0, 20000);
+
+  for (int i = 0; i < 20000; ++i) {
+    int key = dist(gen);
+    bool inserted = disk.insert(key, key * 3L).second;
+    EXPECT_EQ(inserted, reference.insert({key, key * 3L}).second);
+  }
+  for (int i = 0; i < 8000; ++i) {
+    int key = dist(gen);
+    EXPECT_EQ(disk.erase(key), reference.erase(key));
+  }
+
+  ASSERT_EQ(disk.size(), reference.size());
+  auto expected = reference.begin();
+  for (auto entry : disk) {
+    ASSERT_NE(expected, reference.end());
+    EXPECT_EQ(entry.first, expected->first);
+    EXPECT_EQ(entry.second, expected->second);
+    ++expected;
+  }
+  EXPECT_EQ(expected, reference.end());
+  EXPECT_GT(disk.stats().evictions, 0u);
+  std::remove(path.c_str());
+}
+
+TEST(DiskMapTest, FindLowerBoundAt) {
+  std::string path = freshPath("s21_disk_map_lookup.bin");
+  s21::disk_map<int, int> disk(path, kCachePages, kPageSize);
+  for (int i = 0; i < 3000; ++i) disk.insert({i * 2, i});
+
+  EXPECT_TRUE(disk.contains(1000));
+  EXPECT_FALSE(disk.contains(1001));
+  EXPECT_EQ(disk.find(1001), disk.end());
+  EXPECT_EQ(disk.find(600)->second, 300);
+  EXPECT_EQ(disk.lower_bound(1001)->first, 1002);
+  EXPECT_EQ(disk.lower_bound(-5)->first, 0);
+  EXPECT_EQ(disk.lower_bound(5999), disk.end());
+  EXPECT_EQ(disk.at(4), 2);
+  EXPECT_THROW(disk.at(3), std::out_of_range);
+
+  EXPECT_FALSE(disk.insert_or_assign(4, 40).second);
+  EXPECT_EQ(disk.at(4), 40);
+  disk.erase(disk.find(4));
+  EXPECT_FALSE(disk.contains(4));
+  EXPECT_EQ(disk.size(), 2999u);
+  std::remove(path.c_str());
+}
+
+TEST(DiskMapTest, EmptyLeavesAreSkipped) {
+  std::string path = freshPath("s21_disk_map_holes.bin");
+  s21::disk_map<int, int> disk(path, kCachePages, kPageSize);
+  for (int i = 0; i < 2000; ++i) disk.insert(i, i);
+  for (int i = 100; i < 1900; ++i) disk.erase(i);
+
+  std::vector<int> keys;
+  for (auto entry : disk) keys.push_back(entry.first);
+  ASSERT_EQ(keys.size(), 200u);
+  EXPECT_EQ(keys[99], 99);
+  EXPECT_EQ(keys[100], 1900);
+  EXPECT_EQ(disk.lower_bound(500)->first, 1900);
+  std::remove(path.c_str());
+}
+
+TEST(DiskMapTest, ReopenKeepsContents) {
+  std::string path = freshPath("s21_disk_map_reopen.bin");
+  {
+    s21::disk_map<int, double> disk(path, kCachePages, kPageSize);
+    for (int i = 0; i < 5000; ++i) disk.insert(i, i * 0.5);
+  }
+  {
+    s21::disk_map<int, double> disk(path, kCachePages);
+    EXPECT_EQ(disk.size(), 5000u);
+    EXPECT_EQ(disk.at(4999), 2499.5);
+    disk.clear();
+    EXPECT_TRUE(disk.empty());
+    EXPECT_EQ(disk.begin(), disk.end());
+    disk.insert(1, 1.0);
+  }
+  s21::disk_map<int, double> disk(path, kCachePages);
+  EXPECT_EQ(disk.size(), 1u);
+  EXPECT_THROW((s21::disk_map<long, double>(path, kCachePages)),
+               std::runtime_error);
+  EXPECT_THROW((s21::disk_map<int, int>(path, 2)), std::invalid_argument);
+  std::remove(path.c_str());
+}
+
+TEST(DiskMapTest, ErasedPagesAreReused) {
+  std::string path = freshPath("s21_disk_map_reuse.bin");
+  s21::disk_map<int, int> disk(path, kCachePages, kPageSize);
+  for (int i = 0; i < 5000; ++i) disk.insert(i, i);
+  disk.flush();
+  auto file_size = std::filesystem::file_size(path);
+
+  for (int i = 0; i < 5000; i += 3) disk.erase(i);
+  for (int i = 0; i < 5000; ++i) {
+    ASSERT_EQ(disk.contains(i), i % 3 != 0) << i;
+  }
+  for (int i = 0; i < 5000; ++i) disk.erase(i);
+  EXPECT_TRUE(disk.empty());
+  EXPECT_EQ(disk.begin(), disk.end());
+
+  for (int i = 4999; i >= 0; --i) disk.insert(i, -i);
+  disk.flush();
+  EXPECT_EQ(std::filesystem::file_size(path), file_size);
+  EXPECT_EQ(disk.size(), 5000u);
+  int expected = 0;
+  for (auto entry : disk) {
+    EXPECT_EQ(entry.first, expected);
+    EXPECT_EQ(entry.second, -expected);
+    ++expected;
+  }
+  std::remove(path.c_str());
+}
+
+TEST(DiskMapTest, UnflushedFileIsRejected) {
+  std::string path = freshPath("s21_disk_map_unclean.bin");
+  s21::disk_map<int, int> disk(path, kCachePages, kPageSize);
+  for (int i = 0; i < 1000; ++i) disk.insert(i, i);
+  EXPECT_THROW((s21::disk_map<int, int>(path, kCachePages)),
+               std::runtime_error);
+  disk.flush();
+  {
+    s21::disk_map<int, int> reopened(path, kCachePages);
+    EXPECT_EQ(reopened.size(), 1000u);
+  }
+  disk.erase(5);
+  EXPECT_THROW((s21::disk_map<int, int>(path, kCachePages)),
+               std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(DiskMapTest, FailedReadLeavesFrameFree) {
+  s21::PageCache cache(2);
+  cache.attach(-1, kPageSize);
+  EXPECT_THROW(cache.pin(5), std::runtime_error);
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  cache.attach(fileno(file), kPageSize);
+  cache.pin(5);
+  cache.unpin(5, false);
+  // Page 7 takes the frame the failed read had claimed, not page 5's.
+  cache.pin(7);
+  cache.unpin(7, false);
+  cache.pin(5);
+  cache.unpin(5, false);
+  EXPECT_EQ(cache.hits(), 1u);
+  EXPECT_EQ(cache.evictions(), 0u);
+  std::fclose(file);
+}
@@ -0,0 +1,112 @@
+#include "../s21_containers/frozen_map/frozen_map.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "../s21_containers/frozen_set/frozen_set.h"
+#include "../s21_containers/map/map.h"
+#include "../s21_containers/set/set.h"
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+}  // namespace
+
+TEST(FrozenMapTest, FreezeLookups) {
+  s21::map<int, double> s21_map;
+  for (int i = 0; i < 1000; ++i) s21_map.insert(i * 2, i * 0.25);
+
+  s21::frozen_map<int, double> frozen = s21::freeze(s21_map);
+  EXPECT_EQ(frozen.size(), 1000);
+  for (int i = -3; i < 2003; ++i) {
+    EXPECT_EQ(frozen.contains(i), s21_map.contains(i));
+  }
+  EXPECT_EQ(frozen.at(0), 0.0);
+  EXPECT_EQ(frozen.at(1998), 249.75);
+  EXPECT_EQ(frozen.find(7), nullptr);
+  EXPECT_THROW(frozen.at(7), std::out_of_range);
+}
+
+TEST(FrozenMapTest, Empty) {
+  s21::map<int, int> s21_map;
+  s21::frozen_map<int, int> frozen = s21::freeze(s21_map);
+  EXPECT_TRUE(frozen.empty());
+  EXPECT_FALSE(frozen.contains(0));
+
+  s21::frozen_map<int, int> default_constructed;
+  EXPECT_FALSE(default_constructed.contains(1));
+}
+
+TEST(FrozenMapTest, SaveAndMap) {
+  std::string path = tempPath("s21_frozen_map_test.bin");
+  s21::map<long, int> s21_map;
+  for (int i = 1; i <= 777; ++i) s21_map.insert(i * 10L, -i);
+  s21::freeze(s21_map).save(path);
+
+  auto mapped = s21::frozen_map<long, int>::open(path);
+  EXPECT_EQ(mapped.size(), 777);
+  EXPECT_EQ(mapped.at(10), -1);
+  EXPECT_EQ(mapped.at(7770), -777);
+  EXPECT_FALSE(mapped.contains(15));
+
+  auto copy = mapped;
+  EXPECT_EQ(copy.at(500), -50);
+
+  EXPECT_THROW((s21::frozen_map<long, double>::open(path)),
+               std::runtime_error);
+  std::remove(path.c_str());
+  EXPECT_THROW((s21::frozen_map<long, int>::open(path)), std::runtime_error);
+}
+
+TEST(FrozenMapTest, CorruptHeaderIsRejected) {
+  std::string path = tempPath("s21_frozen_map_corrupt.bin");
+  s21::map<long, int> s21_map;
+  for (int i = 1; i <= 100; ++i) s21_map.insert(i, i);
+  s21::frozen_map<long, int> frozen = s21::freeze(s21_map);
+
+  auto patched = [&](std::size_t offset, std::uint64_t value) {
+    frozen.save(path);
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    file.close();
+    return s21::frozen_map<long, int>::open(path);
+  };
+  const std::size_t count = offsetof(s21::FrozenHeader, count);
+  const std::size_t keys = offsetof(s21::FrozenHeader, keys_offset);
+  const std::size_t values = offsetof(s21::FrozenHeader, values_offset);
+
+  // (count + 1) * sizeof(long) wraps around to 0 here.
+  EXPECT_THROW(patched(count, (std::uint64_t(1) << 62) - 1),
+               std::runtime_error);
+  EXPECT_THROW(patched(count, 100000), std::runtime_error);
+  EXPECT_THROW(patched(keys, 72), std::runtime_error);
+  EXPECT_THROW(patched(keys, 0), std::runtime_error);
+  EXPECT_THROW(patched(values, 1000000), std::runtime_error);
+  EXPECT_THROW(patched(values, ~std::uint64_t(0) - 63), std::runtime_error);
+  EXPECT_EQ(patched(count, 100).at(100), 100);
+  std::remove(path.c_str());
+}
+
+TEST(FrozenMapTest, FrozenSet) {
+  std::string path = tempPath("s21_frozen_set_test.bin");
+  s21::set<unsigned> s21_set;
+  for (unsigned i = 0; i < 100; ++i) s21_set.insert(i * i);
+
+  s21::frozen_set<unsigned> frozen = s21::freeze(s21_set);
+  frozen.save(path);
+  auto mapped = s21::frozen_set<unsigned>::open(path);
+  for (unsigned i = 0; i < 10000; ++i) {
+    EXPECT_EQ(mapped.contains(i), s21_set.contains(i));
+  }
+  std::remove(path.c_str());
+}
@@ -0,0 +1,172 @@
+#include "../s21_containers/intrusive_set/intrusive_set.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Account {
+  int id = 0;
+  std::string name;
+  s21::intrusive_set_hook by_id;
+  s21::intrusive_set_hook by_name;
+};
+
+struct IdLess {
+  bool operator()(const Account &lhs, const Account &rhs) const {
+    return lhs.id < rhs.id;
+  }
+  bool operator()(int lhs, const Account &rhs) const { return lhs < rhs.id; }
+  bool operator()(const Account &lhs, int rhs) const { return lhs.id < rhs; }
+};
+
+struct NameLess {
+  bool operator()(const Account &lhs, const Account &rhs) const {
+    return lhs.name < rhs.name;
+  }
+};
+
+using ById = s21::intrusive_set<Account, &Account::by_id, IdLess>;
+using ByName = s21::intrusive_set<Account, &Account::by_name, NameLess>;
+
+// Black height of the subtree, or -1 when a red-black rule or a parent link
+// is broken.
+int blackHeight(s21::intrusive_set_hook *node,
+                s21::intrusive_set_hook *parent) {
+  using Traits = s21::intrusive_hook_traits;
+  if (!node) return 0;
+  if (Traits::parent(node) != parent) return -1;
+  if (Traits::isRed(node) && parent && Traits::isRed(parent)) return -1;
+  int left = blackHeight(Traits::left(node), node);
+  int right = blackHeight(Traits::right(node), node);
+  if (left < 0 || left != right) return -1;
+  return left + !Traits::isRed(node);
+}
+
+int blackHeightFrom(Account &any) {
+  using Traits = s21::intrusive_hook_traits;
+  s21::intrusive_set_hook *root = &any.by_id;
+  while (Traits::parent(root)) root = Traits::parent(root);
+  if (Traits::isRed(root)) return -1;
+  return blackHeight(root, nullptr);
+}
+
+}  // namespace
+
+TEST(IntrusiveSetTest, LinksObjectsWithoutOwningThem) {
+  std::vector<Account> pool(5);
+  const char *names[] = {"eve", "bob", "dan", "amy", "cat"};
+  for (int i = 0; i < 5; ++i) {
+    pool[i].id = 10 * (5 - i);
+    pool[i].name = names[i];
+  }
+
+  ById by_id;
+  ByName by_name;
+  for (Account &account : pool) {
+    EXPECT_TRUE(by_id.insert(account).second);
+    EXPECT_TRUE(by_name.insert(account).second);
+  }
+  EXPECT_EQ(by_id.size(), 5);
+
+  std::vector<int> ids;
+  for (const Account &account : by_id) ids.push_back(account.id);
+  EXPECT_EQ(ids, (std::vector<int>{10, 20, 30, 40, 50}));
+  std::string order;
+  for (const Account &account : by_name) order += account.name[0];
+  EXPECT_EQ(order, "abcde");
+  EXPECT_EQ((--by_name.end())->name, "eve");
+
+  // Searches compare on the objects; IdLess also takes a bare id.
+  EXPECT_EQ(&*by_id.find(30), &pool[2]);
+  EXPECT_TRUE(by_id.find(35) == by_id.end());
+  EXPECT_EQ(by_id.lower_bound(35)->id, 40);
+  Account probe;
+  probe.name = "dan";
+  EXPECT_EQ(&*by_name.find(probe), &pool[2]);
+
+  // An equal key is refused; an already linked object throws.
+  Account twin;
+  twin.id = 30;
+  auto [existing, inserted] = by_id.insert(twin);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(&*existing, &pool[2]);
+  EXPECT_FALSE(twin.by_id.is_linked());
+  EXPECT_THROW(by_id.insert(pool[0]), std::invalid_argument);
+
+  by_id.erase(pool[2]);
+  EXPECT_FALSE(pool[2].by_id.is_linked());
+  EXPECT_TRUE(pool[2].by_name.is_linked());
+  EXPECT_FALSE(by_id.contains(30));
+  EXPECT_EQ(by_id.size(), 4);
+  auto next = by_id.erase(by_id.find(20));
+  EXPECT_EQ(next->id, 40);
+
+  ById moved(std::move(by_id));
+  EXPECT_TRUE(by_id.empty());
+  EXPECT_EQ(moved.size(), 3);
+  moved.clear();
+  for (const Account &account : pool) EXPECT_FALSE(account.by_id.is_linked());
+  EXPECT_TRUE(by_id.insert(pool[0]).second);  // free to link again
+}
+
+TEST(IntrusiveSetTest, RandomChurnKeepsInvariants) {
+  std::vector<Account> pool(3000);
+  for (int i = 0; i < 3000; ++i) pool[i].id = i;
+  ById set;
+  std::set<int> expected;
+
+  std::srand(71);
+  for (int i = 0; i < 40000; ++i) {
+    Account &account = pool[std::rand() % 3000];
+    if (account.by_id.is_linked()) {
+      set.erase(account);
+      expected.erase(account.id);
+    } else {
+      set.insert(account);
+      expected.insert(account.id);
+    }
+    if (i % 1000 == 0 && !set.empty()) {
+      ASSERT_GE(blackHeightFrom(*set.begin()), 0) << i;
+    }
+  }
+  ASSERT_EQ(set.size(), expected.size());
+  auto it = set.begin();
+  for (int id : expected) {
+    EXPECT_EQ(it->id, id);
+    ++it;
+  }
+}
+
+TEST(IntrusiveSetTest, ObjectIteratorsSurviveMoveAndSwap) {
+  std::vector<Account> pool(4);
+  for (int i = 0; i < 4; ++i) pool[i].id = i;
+  ById first;
+  for (Account &account : pool) first.insert(account);
+  auto it = first.find(2);
+
+  ById second(std::move(first));
+  ById third;
+  third.swap(second);
+  EXPECT_TRUE(second.empty());
+  EXPECT_EQ(&*it, &pool[2]);
+  EXPECT_EQ((++it)->id, 3);
+  EXPECT_EQ(&*third.find(1), &pool[1]);
+  EXPECT_EQ((--third.end())->id, 3);
+
+  // The set swapped with a never-used one still links and finds objects.
+  ById fresh;
+  fresh.swap(third);
+  EXPECT_EQ(fresh.size(), 4);
+  Account extra;
+  extra.id = 9;
+  EXPECT_TRUE(third.insert(extra).second);
+  EXPECT_EQ(&*third.find(9), &extra);
+  EXPECT_EQ(&*fresh.find(0), &pool[0]);
+  third.clear();
+  fresh.clear();
+}
@@ -0,0 +1,204 @@
+#include "../s21_containers/lru_cache/lru_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace {
+
+struct FakeClock {
+  using duration = std::chrono::milliseconds;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::time_point<FakeClock>;
+  static constexpr bool is_steady = true;
+
+  static time_point now() { return current; }
+  static void advance(duration step) { current += step; }
+
+  static time_point current;
+};
+
+FakeClock::time_point FakeClock::current;
+
+// Counts how often values are copied into the cache.
+struct Counted {
+  Counted() = default;
+  Counted(const Counted &other) : id(other.id) { ++copies; }
+  Counted(Counted &&other) noexcept : id(other.id) {}
+  Counted &operator=(const Counted &other) {
+    id = other.id;
+    ++copies;
+    return *this;
+  }
+  Counted &operator=(Counted &&other) noexcept {
+    id = other.id;
+    return *this;
+  }
+
+  int id = 0;
+  static int copies;
+};
+
+int Counted::copies = 0;
+
+struct StringBytes {
+  std::size_t operator()(int, const std::string &value) const {
+    return value.size();
+  }
+};
+
+}  // namespace
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+  s21::lru_cache<int, std::string> cache(3);
+  cache.put(1, "one");
+  cache.put(2, "two");
+  cache.put(3, "three");
+  ASSERT_NE(cache.get(1), nullptr);  // 2 is now the oldest
+  cache.put(4, "four");
+
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_FALSE(cache.contains(2));
+  EXPECT_EQ(*cache.get(1), "one");
+  EXPECT_EQ(*cache.get(4), "four");
+  EXPECT_EQ(cache.get(2), nullptr);
+  EXPECT_EQ(cache.hits(), 3);
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(cache.evictions(), 1);
+
+  // Overwriting refreshes recency; peek does not.
+  cache.put(3, "THREE");
+  EXPECT_EQ(*cache.peek(1), "one");
+  cache.put(5, "five");
+  EXPECT_FALSE(cache.contains(1));
+  EXPECT_EQ(*cache.peek(3), "THREE");
+  EXPECT_EQ(cache.hits(), 3);
+
+  EXPECT_TRUE(cache.erase(3));
+  EXPECT_FALSE(cache.erase(3));
+  EXPECT_EQ(cache.size(), 2);
+  cache.clear();
+  EXPECT_TRUE(cache.empty());
+  EXPECT_EQ(cache.bytes(), 0);
+}
+
+TEST(LruCacheTest, PutCopiesValueOnce) {
+  s21::lru_cache<int, Counted> cache(4);
+  Counted value;
+  value.id = 1;
+  Counted::copies = 0;
+  cache.put(1, value);
+  EXPECT_EQ(Counted::copies, 1);
+  value.id = 2;
+  cache.put(1, value);
+  EXPECT_EQ(Counted::copies, 2);
+  EXPECT_EQ(cache.get(1)->id, 2);
+
+  cache.put(2, Counted(value));
+  cache.put(2, std::move(value));
+  EXPECT_EQ(Counted::copies, 3);  // only the explicit Counted(value)
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.get(2)->id, 2);
+}
+
+TEST(LruCacheTest, ByteBound) {
+  using Cache = s21::lru_cache<int, std::string, StringBytes>;
+  Cache probe(1);
+  probe.put(0, "");
+  const std::size_t node_bytes = probe.bytes();
+
+  Cache cache(Cache::kUnlimited, 3 * node_bytes + 10);
+  cache.put(1, "aaaa");
+  cache.put(2, "bbbb");
+  EXPECT_EQ(cache.bytes(), 2 * node_bytes + 8);
+  cache.put(3, "cccc");  // 12 extra bytes: evicts 1
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_FALSE(cache.contains(1));
+
+  cache.put(2, "");  // shrinking an entry frees its bytes
+  cache.put(4, "dd");
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_EQ(cache.bytes(), 3 * node_bytes + 6);
+
+  cache.put(5, std::string(4 * node_bytes, 'x'));  // over the whole bound
+  EXPECT_TRUE(cache.empty());
+  EXPECT_EQ(cache.bytes(), 0);
+}
+
+TEST(LruCacheTest, TtlExpiry) {
+  using Cache = s21::lru_cache<int, int, s21::lru_no_extra_bytes, FakeClock>;
+  Cache cache(100, Cache::kUnlimited, std::chrono::milliseconds(200));
+  for (int i = 0; i < 10; ++i) {
+    cache.put(i, i);  // written at 10 * i
+    FakeClock::advance(std::chrono::milliseconds(10));
+  }
+  // Reads do not extend the ttl, writes do.
+  EXPECT_NE(cache.get(0), nullptr);
+  cache.put(1, 100);
+  FakeClock::advance(std::chrono::milliseconds(105));
+
+  EXPECT_EQ(cache.get(0), nullptr);  // expired at 200, now 205
+  EXPECT_EQ(cache.expirations(), 1);
+  EXPECT_NE(cache.peek(2), nullptr);
+  FakeClock::advance(std::chrono::milliseconds(40));
+  EXPECT_EQ(cache.peek(2), nullptr);
+  EXPECT_EQ(cache.expire(), 3);  // 2, 3 and 4
+  EXPECT_EQ(cache.size(), 6);
+  EXPECT_EQ(*cache.get(1), 100);
+  EXPECT_EQ(*cache.get(5), 5);
+
+  FakeClock::advance(std::chrono::milliseconds(1000));
+  EXPECT_EQ(cache.expire(), 6);
+  EXPECT_TRUE(cache.empty());
+  EXPECT_EQ(cache.expirations(), 10);
+}
+
+TEST(LruCacheTest, MatchesReferenceLru) {
+  s21::lru_cache<int, int> cache(64);
+  std::list<std::pair<int, int>> order;  // most recent first
+  std::map<int, std::list<std::pair<int, int>>::iterator> index;
+
+  std::srand(61);
+  for (int i = 0; i < 50000; ++i) {
+    int key = std::rand() % 200;
+    auto found = index.find(key);
+    switch (std::rand() % 3) {
+      case 0: {
+        int *value = cache.get(key);
+        ASSERT_EQ(value != nullptr, found != index.end()) << i;
+        if (value) {
+          EXPECT_EQ(*value, found->second->second);
+          order.splice(order.begin(), order, found->second);
+        }
+        break;
+      }
+      case 1:
+        cache.put(key, i);
+        if (found != index.end()) {
+          found->second->second = i;
+          order.splice(order.begin(), order, found->second);
+        } else {
+          order.emplace_front(key, i);
+          index[key] = order.begin();
+          if (order.size() > 64) {
+            index.erase(order.back().first);
+            order.pop_back();
+          }
+        }
+        break;
+      default:
+        EXPECT_EQ(cache.erase(key), found != index.end());
+        if (found != index.end()) {
+          order.erase(found->second);
+          index.erase(found);
+        }
+    }
+    ASSERT_EQ(cache.size(), order.size());
+  }
+}
@@ -2,7 +2,14 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <cstring>
 #include <map>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 TEST(MapTest, DefaultConstructor) {
   s21::map<int, std::string> s21_map;
@@ -390,4 +397,340 @@ TEST(MapTest, ContainsMethod) {
 
   s21::map<int, std::string> empty_map;
   EXPECT_FALSE(empty_map.contains(1));
-}
\ No newline at end of file
+}
+
+TEST(MapTest, IndexStorage) {
+  s21::map<std::string, int, s21::index_storage> s21_map = {
+      {"apple", 2}, {"banana", 5}, {"cherry", 3}};
+
+  EXPECT_EQ(s21_map.at("banana"), 5);
+  EXPECT_THROW(s21_map.at("orange"), std::out_of_range);
+  EXPECT_EQ(s21_map["orange"], 0);
+  EXPECT_FALSE(s21_map.insert_or_assign("apple", 7).second);
+  EXPECT_EQ(s21_map["apple"], 7);
+
+  s21_map.erase(s21_map.begin());
+  EXPECT_FALSE(s21_map.contains("apple"));
+  EXPECT_TRUE(s21_map.contains("orange"));
+  EXPECT_EQ(s21_map.size(), 3);
+
+  std::string expected[] = {"banana", "cherry", "orange"};
+  int i = 0;
+  for (const auto& pair : s21_map) {
+    EXPECT_EQ(pair.first, expected[i++]);
+  }
+}
+
+// Growth and erasing other keys must not move a node, as with node storage.
+TEST(MapTest, IndexStorageReferencesStayValid) {
+  s21::map<int, std::string, s21::index_storage> s21_map;
+  auto kept_it = s21_map.insert(500, "kept").first;
+  std::string& kept = s21_map[500];
+  for (int i = 0; i < 5000; ++i) s21_map.insert(i, std::to_string(i));
+  for (auto it = s21_map.begin(); it != s21_map.end();) {
+    int key = (*it).first;
+    auto current = it++;
+    if (key % 2 == 0 && key != 500) s21_map.erase(current);
+  }
+  EXPECT_EQ(&kept, &s21_map.at(500));
+  EXPECT_EQ(&(*kept_it).second, &kept);
+  EXPECT_EQ(kept, "kept");
+
+  // The copy takes the freed slots over and reuses them.
+  auto copy = s21_map;
+  for (int i = 0; i < 5000; i += 2) copy.insert(i, "again");
+  EXPECT_EQ(copy.size(), 5000);
+  EXPECT_EQ(copy.at(500), "kept");
+  EXPECT_EQ(copy.at(4998), "again");
+  EXPECT_EQ(s21_map.size(), 2501);
+}
+
+TEST(MapTest, FindManyByKey) {
+  s21::map<std::string, int> s21_map = {
+      {"apple", 2}, {"banana", 5}, {"cherry", 3}};
+  std::vector<std::string> keys = {"cherry", "kiwi", "apple"};
+
+  std::vector<s21::map<std::string, int>::iterator> found;
+  s21_map.find_many(keys, std::back_inserter(found));
+  EXPECT_EQ(found[0]->second, 3);
+  EXPECT_TRUE(found[1] == s21_map.end());
+  EXPECT_EQ(found[2]->second, 2);
+
+  bool present[3];
+  s21_map.contains_many(keys, present);
+  EXPECT_TRUE(present[0]);
+  EXPECT_FALSE(present[1]);
+  EXPECT_TRUE(present[2]);
+}
+
+TEST(MapTest, InsertWithHint) {
+  s21::map<int, std::string> s21_map;
+  auto hint = s21_map.end();
+  for (int i = 0; i < 50; ++i) {
+    hint = s21_map.insert(hint, {i, std::to_string(i)});
+  }
+  hint = s21_map.emplace_hint(s21_map.begin(), -1, "minus one");
+  EXPECT_EQ(hint->second, "minus one");
+
+  EXPECT_EQ(s21_map.size(), 51);
+  int expected = -1;
+  for (const auto& pair : s21_map) {
+    EXPECT_EQ(pair.first, expected++);
+  }
+}
+
+TEST(MapTest, FromUnsorted) {
+  std::vector<std::pair<int, std::string>> input = {
+      {3, "three"}, {1, "one"}, {2, "two"}, {3, "again"}, {0, "zero"}};
+  auto s21_map = s21::map<int, std::string>::from_unsorted(input.begin(),
+                                                           input.end(), 2);
+
+  EXPECT_EQ(s21_map.size(), 4);
+  EXPECT_EQ(s21_map.at(3), "three");
+  int expected = 0;
+  for (const auto& pair : s21_map) {
+    EXPECT_EQ(pair.first, expected++);
+  }
+}
+
+TEST(MapTest, ParallelReducePreservesOrder) {
+  s21::map<int, std::string> s21_map;
+  for (int i = 0; i < 26; ++i) s21_map.insert(i, std::string(1, 'a' + i));
+
+  std::string joined = s21::parallel_reduce(
+      s21_map, std::string(),
+      [](std::string acc, const std::pair<const int, std::string>& pair) {
+        return acc + pair.second;
+      },
+      [](std::string lhs, std::string rhs) { return lhs + rhs; }, 4);
+  EXPECT_EQ(joined, "abcdefghijklmnopqrstuvwxyz");
+
+  s21::parallel_for_each(
+      s21_map,
+      [](std::pair<const int, std::string>& pair) { pair.second += "!"; }, 2);
+  auto entries = s21::to_vector(s21_map, 2);
+  EXPECT_EQ(entries.front().second, "a!");
+  EXPECT_EQ(entries.back().first, 25);
+}
+
+TEST(MapTest, SaveLoadFixedSize) {
+  s21::map<int, double> s21_map;
+  for (int i = 0; i < 20000; ++i) s21_map.insert(i * 3, i * 0.5);
+
+  std::stringstream buffer;
+  s21_map.save(buffer);
+
+  s21::map<int, double> loaded = {{-1, 1.0}};
+  loaded.load(buffer);
+  EXPECT_EQ(loaded.size(), s21_map.size());
+  EXPECT_FALSE(loaded.contains(-1));
+  EXPECT_EQ(loaded.at(2997), 499.5);
+  auto it = s21_map.begin();
+  for (const auto& pair : loaded) {
+    EXPECT_EQ(pair.first, it->first);
+    EXPECT_EQ(pair.second, it->second);
+    ++it;
+  }
+  loaded.insert(-5, 0.0);
+  EXPECT_EQ(loaded.begin()->first, -5);
+}
+
+TEST(MapTest, SaveLoadStrings) {
+  s21::map<std::string, std::string> s21_map = {
+      {"apple", "red"}, {"banana", ""}, {"cherry", std::string(300, 'x')}};
+  std::stringstream buffer;
+  s21_map.save(buffer);
+
+  s21::map<std::string, std::string> loaded;
+  loaded.load(buffer);
+  EXPECT_EQ(loaded.size(), 3);
+  EXPECT_EQ(loaded.at("apple"), "red");
+  EXPECT_EQ(loaded.at("banana"), "");
+  EXPECT_EQ(loaded.at("cherry").size(), 300);
+}
+
+TEST(MapTest, LoadRejectsBadSnapshots) {
+  s21::map<int, int> s21_map = {{1, 1}, {2, 2}};
+  std::stringstream buffer;
+  s21_map.save(buffer);
+  std::string bytes = buffer.str();
+
+  s21::map<int, double> other_layout;
+  std::stringstream same(bytes);
+  EXPECT_THROW(other_layout.load(same), std::runtime_error);
+
+  s21::map<int, int> target = {{7, 7}};
+  std::stringstream truncated(bytes.substr(0, bytes.size() - 2));
+  EXPECT_THROW(target.load(truncated), std::runtime_error);
+  EXPECT_TRUE(target.contains(7));
+
+  std::stringstream garbage("not a snapshot at all");
+  EXPECT_THROW(target.load(garbage), std::runtime_error);
+}
+
+TEST(MapTest, LoadRejectsOversizedStringLength) {
+  s21::map<std::string, int> s21_map = {{"key", 1}};
+  std::stringstream buffer;
+  s21_map.save(buffer);
+  std::string bytes = buffer.str();
+
+  // The first string length follows the 24-byte header.
+  for (std::uint64_t length : {std::uint64_t(1) << 62, std::uint64_t(4096)}) {
+    std::memcpy(&bytes[24], &length, sizeof(length));
+    std::stringstream corrupt(bytes);
+    s21::map<std::string, int> target = {{"kept", 7}};
+    EXPECT_THROW(target.load(corrupt), std::runtime_error);
+    EXPECT_EQ(target.at("kept"), 7);
+  }
+}
+
+TEST(MapTest, SmallStorage) {
+  s21::map<std::string, int, s21::small_storage<3>> s21_map = {
+      {"apple", 2}, {"banana", 5}};
+  EXPECT_TRUE(s21_map.is_inline());
+  EXPECT_EQ(s21_map.at("banana"), 5);
+  EXPECT_THROW(s21_map.at("orange"), std::out_of_range);
+  EXPECT_EQ(s21_map["cherry"], 0);
+  EXPECT_FALSE(s21_map.insert_or_assign("apple", 7).second);
+  EXPECT_EQ(s21_map["apple"], 7);
+  EXPECT_TRUE(s21_map.is_inline());
+
+  s21_map.insert("date", 4);
+  EXPECT_FALSE(s21_map.is_inline());
+  EXPECT_EQ(s21_map.at("apple"), 7);
+  s21_map["banana"] = 6;
+
+  std::map<std::string, int> expected = {
+      {"apple", 7}, {"banana", 6}, {"cherry", 0}, {"date", 4}};
+  auto std_it = expected.begin();
+  for (const auto& pair : s21_map) {
+    EXPECT_EQ(pair.first, std_it->first);
+    EXPECT_EQ(pair.second, std_it->second);
+    ++std_it;
+  }
+}
+
+TEST(MapTest, StringKeysWithCachedPrefix) {
+  // Keys that tie on the first 8 bytes, embedded zero bytes and bytes above
+  // 0x7f all have to fall back to the full comparison correctly.
+  std::vector<std::string> keys = {"",
+                                   std::string(1, '\0'),
+                                   std::string("ab\0", 3),
+                                   "ab",
+                                   "abcdefgh",
+                                   "abcdefgh1",
+                                   "abcdefgh0",
+                                   "abcdefg",
+                                   "\xff\xfe",
+                                   "\x80",
+                                   "zzzzzzzzzzzzzzzz"};
+  s21::map<std::string, int> s21_map;
+  std::map<std::string, int> std_map;
+  for (int i = 0; i < 3; ++i) {
+    for (std::size_t k = 0; k < keys.size(); ++k) {
+      std::string key = keys[(k * 7 + i) % keys.size()] + std::string(i, 'x');
+      EXPECT_EQ(s21_map.insert(key, i).second,
+                std_map.insert({key, i}).second);
+    }
+  }
+  ASSERT_EQ(s21_map.size(), std_map.size());
+  auto std_it = std_map.begin();
+  for (const auto& pair : s21_map) {
+    EXPECT_EQ(pair.first, std_it->first);
+    ++std_it;
+  }
+  for (const auto& [key, value] : std_map) {
+    EXPECT_EQ(s21_map.at(key), value);
+  }
+  EXPECT_FALSE(s21_map.contains("abcdefgh2"));
+  EXPECT_FALSE(s21_map.contains(std::string("a\0", 2)));
+}
+
+TEST(MapTest, PairFirstComparatorIsAPlainType) {
+  static_assert(std::is_same_v<s21::map<int, int>::MyBase,
+                               s21::RBTree<std::pair<const int, int>,
+                                           s21::PairFirstComparator>>);
+  // Map still caches string key prefixes through the plain comparator.
+  static_assert(s21::tree_key_prefix_traits<
+                s21::PairFirstComparator,
+                std::pair<const std::string, int>>::value);
+
+  // Pairs with a non-const first order on first, as they always have.
+  s21::RBTree<std::pair<int, char>, s21::PairFirstComparator> tree;
+  tree.insert({3, 'c'});
+  tree.insert({1, 'a'});
+  EXPECT_FALSE(tree.insert({3, 'x'}).second);
+  tree.insert({2, 'b'});
+  std::string order;
+  for (const auto& pair : tree) order += pair.second;
+  EXPECT_EQ(order, "abc");
+  EXPECT_EQ((*tree.find({2, '?'})).second, 'b');
+}
+
+TEST(MapTest, CursorJoinsSortedKeys) {
+  s21::map<int, std::string> s21_map;
+  for (int i = 0; i < 300; i += 3) s21_map.insert(i, std::to_string(i));
+
+  // Join the multiples of 2 against the multiples of 3.
+  std::vector<int> joined;
+  s21::map<int, std::string>::cursor cursor(s21_map);
+  for (int key = 0; key < 300; key += 2) {
+    if (cursor.seek(key)) joined.push_back(std::stoi(cursor->second));
+  }
+  ASSERT_EQ(joined.size(), 50);
+  for (std::size_t i = 0; i < joined.size(); ++i) {
+    EXPECT_EQ(joined[i], 6 * static_cast<int>(i));
+  }
+
+  auto hint = s21_map.find(s21_map.begin(), 150);
+  EXPECT_EQ(hint->second, "150");
+  EXPECT_EQ(s21_map.find(hint, 153)->second, "153");
+  EXPECT_EQ(s21_map.find(hint, 3)->second, "3");
+  EXPECT_TRUE(s21_map.find(hint, 154) == s21_map.end());
+}
+
+TEST(MapTest, SplitAtAndConcat) {
+  s21::map<int, std::string> s21_map;
+  for (int i = 0; i < 1000; ++i) s21_map.insert(i * 2, std::to_string(i));
+
+  s21::map<int, std::string> upper = s21_map.split_at(1000);
+  EXPECT_EQ(s21_map.size(), 500);
+  EXPECT_EQ(upper.size(), 500);
+  EXPECT_EQ(upper.begin()->first, 1000);
+  EXPECT_EQ((--s21_map.end())->first, 998);
+  EXPECT_EQ(upper.at(1998), "999");
+  EXPECT_FALSE(s21_map.contains(1000));
+
+  // A key between two elements and the extremes.
+  s21::map<int, std::string> tail = upper.split_at(1501);
+  EXPECT_EQ(tail.begin()->first, 1502);
+  EXPECT_EQ(upper.size(), 251);
+  EXPECT_EQ(tail.size(), 249);
+  EXPECT_TRUE(tail.split_at(5000).empty());
+  s21::map<int, std::string> all = tail.split_at(-1);
+  EXPECT_TRUE(tail.empty());
+  EXPECT_EQ(all.size(), 249);
+
+  upper.concat(all);
+  s21_map.concat(upper);
+  EXPECT_TRUE(upper.empty());
+  EXPECT_EQ(s21_map.size(), 1000);
+  int expected = 0;
+  for (const auto &pair : s21_map) {
+    EXPECT_EQ(pair.first, expected);
+    expected += 2;
+  }
+  s21_map.insert(5000, "after");
+  EXPECT_EQ(s21_map.size(), 1001);
+
+  // Inserts and erases before the first size() after a split.
+  s21::map<int, std::string> lazy = s21_map.split_at(500);
+  lazy.insert(5001, "x");
+  lazy.erase(lazy.begin());
+  EXPECT_EQ(lazy.size(), 751);
+  EXPECT_EQ(s21_map.size(), 250);
+
+  s21::map<int, std::string> overlapping;
+  overlapping.insert(10, "ten");
+  EXPECT_THROW(s21_map.concat(overlapping), std::invalid_argument);
+}
@@ -0,0 +1,225 @@
+#include "../s21_containers/multi_index/multi_index.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Record {
+  int id = 0;
+  long timestamp = 0;
+  int priority = 0;
+  std::string name;
+};
+
+using Records = s21::multi_index<
+    Record, s21::ordered_unique<s21::member_key<&Record::id>>,
+    s21::ordered_non_unique<s21::member_key<&Record::timestamp>>,
+    s21::ordered_non_unique<s21::member_key<&Record::priority>,
+                            std::greater<>>,
+    s21::ordered_unique<s21::member_key<&Record::name>>>;
+
+template <std::size_t I, typename Container>
+std::vector<int> idsIn(const Container &records) {
+  std::vector<int> ids;
+  auto view = records.template get<I>();
+  for (auto it = view.begin(); it != view.end(); ++it) ids.push_back(it->id);
+  return ids;
+}
+
+// Copying throws when asked to; an assignment asked to throw does so
+// after writing the key, leaving the target half assigned.
+struct Touchy {
+  Touchy(int key, bool throw_on_copy = false, bool throw_on_assign = false)
+      : key(key),
+        throw_on_copy(throw_on_copy),
+        throw_on_assign(throw_on_assign) {}
+  Touchy(const Touchy &other)
+      : key(other.key), throw_on_assign(other.throw_on_assign) {
+    if (other.throw_on_copy) throw std::runtime_error("copy");
+  }
+  Touchy &operator=(const Touchy &other) {
+    key = other.key;
+    if (other.throw_on_assign) throw std::runtime_error("assign");
+    return *this;
+  }
+
+  int key;
+  bool throw_on_copy = false;
+  bool throw_on_assign = false;
+};
+
+}  // namespace
+
+TEST(MultiIndexTest, OneElementInEveryIndex) {
+  Records records{{3, 300, 1, "c"}, {1, 200, 5, "a"}, {2, 200, 3, "b"}};
+  EXPECT_EQ(records.size(), 3);
+  EXPECT_EQ(idsIn<0>(records), (std::vector<int>{1, 2, 3}));
+  // Equal timestamps keep insertion order.
+  EXPECT_EQ(idsIn<1>(records),
+            (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(idsIn<2>(records),
+            (std::vector<int>{1, 2, 3}));
+
+  auto by_time = records.get<1>();
+  EXPECT_EQ(by_time.count(200), 2);
+  EXPECT_EQ(by_time.find(200)->id, 1);
+  EXPECT_EQ(by_time.lower_bound(250)->id, 3);
+  EXPECT_TRUE(by_time.upper_bound(300) == by_time.end());
+  EXPECT_FALSE(by_time.contains(100));
+  EXPECT_EQ((--by_time.end())->id, 3);
+  EXPECT_EQ(records.get<3>().find(std::string("b"))->id, 2);
+
+  // A clash in any unique index leaves every index untouched.
+  auto [existing, inserted] = records.insert({4, 50, 9, "a"});
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(existing->id, 1);
+  EXPECT_FALSE(records.get<1>().contains(50));
+  EXPECT_FALSE(records.emplace(Record{2, 1, 1, "z"}).second);
+  EXPECT_EQ(records.size(), 3);
+  EXPECT_TRUE(records.emplace(Record{4, 50, 9, "d"}).second);
+
+  // Erasing through one index removes the element from all of them.
+  auto by_priority = records.get<2>();
+  auto next = records.erase(by_priority.begin());
+  EXPECT_EQ(next->id, 1);
+  EXPECT_FALSE(records.get<0>().contains(4));
+  EXPECT_FALSE(records.get<1>().contains(50));
+  EXPECT_EQ(records.erase<1>(200), 2);
+  EXPECT_EQ(idsIn<0>(records), (std::vector<int>{3}));
+
+  auto by_id = records.get<0>();
+  auto found = records.project<3>(by_id.find(3));
+  EXPECT_EQ(found->name, "c");
+
+  Records copy(records);
+  records.clear();
+  EXPECT_TRUE(records.empty());
+  EXPECT_TRUE(records.get<2>().begin() == records.get<2>().end());
+  EXPECT_EQ(copy.get<3>().begin()->id, 3);
+}
+
+TEST(MultiIndexTest, ModifyAndReplaceMoveTheElement) {
+  Records records{{1, 10, 1, "a"}, {2, 20, 2, "b"}, {3, 30, 3, "c"}};
+  auto by_id = records.get<0>();
+
+  // Moves within the indices whose keys changed.
+  EXPECT_TRUE(records.modify(by_id.find(1), [](Record &record) {
+    record.timestamp = 40;
+    record.priority = 9;
+  }));
+  EXPECT_EQ(idsIn<1>(records),
+            (std::vector<int>{2, 3, 1}));
+  EXPECT_EQ(records.get<2>().begin()->id, 1);
+
+  // replace() refuses a clash and keeps the old value.
+  EXPECT_FALSE(records.replace(by_id.find(2), Record{3, 0, 0, "x"}));
+  EXPECT_EQ(by_id.find(2)->name, "b");
+  EXPECT_TRUE(records.replace(by_id.find(2), Record{7, 5, 0, "b"}));
+  EXPECT_EQ(idsIn<0>(records), (std::vector<int>{1, 3, 7}));
+  EXPECT_EQ(records.get<1>().begin()->id, 7);
+
+  // modify() cannot undo fn, so a clash erases the element.
+  EXPECT_FALSE(records.modify(by_id.find(7),
+                              [](Record &record) { record.name = "a"; }));
+  EXPECT_EQ(records.size(), 2);
+  EXPECT_FALSE(records.get<1>().contains(5));
+
+  EXPECT_THROW(records.modify(by_id.find(3),
+                              [](Record &) { throw std::runtime_error(""); }),
+               std::runtime_error);
+  EXPECT_EQ(idsIn<0>(records), (std::vector<int>{1}));
+}
+
+TEST(MultiIndexTest, ThrowingReplaceNeverMisplacesTheElement) {
+  s21::multi_index<Touchy, s21::ordered_unique<s21::member_key<&Touchy::key>>>
+      touchy{Touchy(1), Touchy(2), Touchy(3)};
+  auto view = touchy.get<0>();
+  auto keys = [&] {
+    std::vector<int> result;
+    for (const Touchy &item : view) result.push_back(item.key);
+    return result;
+  };
+
+  // A failed copy leaves the element untouched.
+  EXPECT_THROW(touchy.replace(view.find(2), Touchy(5, true)),
+               std::runtime_error);
+  EXPECT_EQ(keys(), (std::vector<int>{1, 2, 3}));
+
+  // A half-done assignment erases the element rather than leave it
+  // out of order.
+  EXPECT_THROW(touchy.replace(view.find(2), Touchy(0, false, true)),
+               std::runtime_error);
+  EXPECT_EQ(keys(), (std::vector<int>{1, 3}));
+  EXPECT_EQ(touchy.size(), 2);
+  EXPECT_FALSE(view.contains(0));
+}
+
+TEST(MultiIndexTest, MatchesSeparateMaps) {
+  using ByIdThenTime = s21::multi_index<
+      Record, s21::ordered_unique<s21::member_key<&Record::id>>,
+      s21::ordered_non_unique<s21::member_key<&Record::timestamp>>>;
+  ByIdThenTime records;
+  std::map<int, long> by_id;
+  std::multiset<std::pair<long, int>> by_time;
+
+  std::srand(83);
+  for (int i = 0; i < 20000; ++i) {
+    int id = std::rand() % 500;
+    long timestamp = std::rand() % 100;
+    auto it = records.get<0>().find(id);
+    switch (std::rand() % 3) {
+      case 0:
+        EXPECT_EQ(records.insert({id, timestamp, 0, ""}).second,
+                  it == records.get<0>().end());
+        if (!by_id.count(id)) {
+          by_id[id] = timestamp;
+          by_time.insert({timestamp, id});
+        }
+        break;
+      case 1:
+        if (it != records.get<0>().end()) {
+          records.modify(it, [&](Record &record) {
+            record.timestamp = timestamp;
+          });
+          by_time.erase(by_time.find({by_id[id], id}));
+          by_id[id] = timestamp;
+          by_time.insert({timestamp, id});
+        }
+        break;
+      default:
+        if (it != records.get<0>().end()) {
+          records.erase(it);
+          by_time.erase(by_time.find({by_id[id], id}));
+          by_id.erase(id);
+        }
+    }
+  }
+
+  ASSERT_EQ(records.size(), by_id.size());
+  auto id_it = by_id.begin();
+  for (const Record &record : records.get<0>()) {
+    EXPECT_EQ(record.id, id_it->first);
+    EXPECT_EQ(record.timestamp, id_it->second);
+    ++id_it;
+  }
+  std::vector<long> times;
+  for (const Record &record : records.get<1>()) {
+    times.push_back(record.timestamp);
+  }
+  std::vector<long> expected;
+  for (const auto &entry : by_time) expected.push_back(entry.first);
+  EXPECT_EQ(times, expected);
+  for (long timestamp : {0L, 50L, 99L}) {
+    EXPECT_EQ(records.get<1>().count(timestamp),
+              std::count(expected.begin(), expected.end(), timestamp));
+  }
+}
@@ -0,0 +1,172 @@
+#include "../s21_containers/multiset/multiset.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../s21_containers/multimap/multimap.h"
+#include "../s21_containers/set/set.h"
+
+namespace {
+
+// Members that assume unique keys must not be reachable on the multi
+// containers.
+template <typename T, typename = void>
+struct HasSplitAt : std::false_type {};
+template <typename T>
+struct HasSplitAt<T, std::void_t<decltype(std::declval<T &>().split_at(
+                         *std::declval<T &>().begin(), std::declval<T &>()))>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct HasUnite : std::false_type {};
+template <typename T>
+struct HasUnite<T, std::void_t<decltype(std::declval<T &>().unite(
+                       std::declval<const T &>()))>> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasCursor : std::false_type {};
+template <typename T>
+struct HasCursor<T, std::void_t<typename T::template Cursor<int>>>
+    : std::true_type {};
+
+static_assert(HasSplitAt<s21::set<int>>::value);
+static_assert(HasUnite<s21::set<int>>::value);
+static_assert(!HasSplitAt<s21::multiset<int>>::value);
+static_assert(!HasSplitAt<s21::multimap<int, int>>::value);
+static_assert(!HasUnite<s21::multiset<int>>::value);
+static_assert(!HasUnite<s21::multimap<int, int>>::value);
+static_assert(!HasCursor<s21::multiset<int>>::value);
+static_assert(!HasCursor<s21::multimap<int, int>>::value);
+
+}  // namespace
+
+TEST(MultisetTest, InsertKeepsDuplicates) {
+  s21::multiset<int> s21_multiset = {5, 1, 5, 3, 5, 1};
+  std::multiset<int> std_multiset = {5, 1, 5, 3, 5, 1};
+  s21_multiset.insert(3);
+  std_multiset.insert(3);
+
+  EXPECT_EQ(s21_multiset.size(), std_multiset.size());
+  EXPECT_TRUE(std::equal(s21_multiset.begin(), s21_multiset.end(),
+                         std_multiset.begin(), std_multiset.end()));
+  EXPECT_EQ(s21_multiset.count(5), 3u);
+  EXPECT_EQ(s21_multiset.count(4), 0u);
+}
+
+TEST(MultisetTest, EqualRangeAndBounds) {
+  s21::multiset<int> s21_multiset;
+  std::multiset<int> std_multiset;
+  for (int i = 0; i < 300; ++i) {
+    s21_multiset.insert(i % 30);
+    std_multiset.insert(i % 30);
+  }
+
+  for (int key = -1; key <= 30; ++key) {
+    auto range = s21_multiset.equal_range(key);
+    auto expected = std_multiset.equal_range(key);
+    EXPECT_EQ(std::distance(range.first, range.second),
+              std::distance(expected.first, expected.second));
+    if (expected.first != std_multiset.end()) {
+      EXPECT_EQ(*s21_multiset.lower_bound(key), *expected.first);
+    } else {
+      EXPECT_EQ(s21_multiset.lower_bound(key), s21_multiset.end());
+    }
+  }
+  EXPECT_EQ(s21_multiset.upper_bound(29), s21_multiset.end());
+  EXPECT_EQ(*s21_multiset.find(7), 7);
+  EXPECT_EQ(s21_multiset.find(30), s21_multiset.end());
+}
+
+TEST(MultisetTest, EraseKey) {
+  s21::multiset<int> s21_multiset = {1, 2, 2, 2, 3};
+  EXPECT_EQ(s21_multiset.erase(2), 3u);
+  EXPECT_EQ(s21_multiset.erase(2), 0u);
+  EXPECT_EQ(s21_multiset.size(), 2u);
+  EXPECT_FALSE(s21_multiset.contains(2));
+  EXPECT_EQ(*s21_multiset.begin(), 1);
+  EXPECT_EQ(*--s21_multiset.end(), 3);
+}
+
+TEST(MultisetTest, CopyAndMerge) {
+  s21::multiset<int> s21_multiset = {4, 4, 4, 2, 2, 9};
+  s21::multiset<int> copy(s21_multiset);
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(), s21_multiset.begin(),
+                         s21_multiset.end()));
+
+  s21::multiset<int> other = {4, 1};
+  copy.merge(other);
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(copy.size(), 8u);
+  EXPECT_EQ(copy.count(4), 4u);
+}
+
+TEST(MultimapTest, EqualKeysKeepInsertionOrder) {
+  s21::multimap<std::string, int> s21_multimap;
+  for (int i = 0; i < 50; ++i) {
+    s21_multimap.insert(i % 2 ? "odd" : "even", i);
+  }
+  s21_multimap.insert({"a", -1});
+
+  EXPECT_EQ(s21_multimap.count("odd"), 25u);
+  auto range = s21_multimap.equal_range("odd");
+  std::vector<int> values;
+  for (auto it = range.first; it != range.second; ++it) {
+    values.push_back(it->second);
+  }
+  ASSERT_EQ(values.size(), 25u);
+  for (int i = 0; i < 25; ++i) EXPECT_EQ(values[i], 2 * i + 1);
+
+  EXPECT_EQ(s21_multimap.find("even")->second, 0);
+  EXPECT_EQ(s21_multimap.begin()->first, "a");
+  EXPECT_FALSE(s21_multimap.contains("none"));
+}
+
+TEST(MultimapTest, EraseKeyMatchesStd) {
+  s21::multimap<int, int> s21_multimap;
+  std::multimap<int, int> std_multimap;
+  for (int i = 0; i < 200; ++i) {
+    s21_multimap.insert(i % 17, i);
+    std_multimap.insert({i % 17, i});
+  }
+  for (int key : {3, 16, 0, 42}) {
+    EXPECT_EQ(s21_multimap.erase(key), std_multimap.erase(key));
+  }
+
+  ASSERT_EQ(s21_multimap.size(), std_multimap.size());
+  auto expected = std_multimap.begin();
+  for (auto it = s21_multimap.begin(); it != s21_multimap.end();
+       ++it, ++expected) {
+    EXPECT_EQ(it->first, expected->first);
+    EXPECT_EQ(it->second, expected->second);
+  }
+}
+
+TEST(MultisetTest, RandomChurnMatchesStd) {
+  s21::multiset<int> s21_multiset;
+  std::multiset<int> std_multiset;
+  std::mt19937 gen(3);
+  for (int i = 0; i < 5000; ++i) {
+    int value = gen() % 64;
+    if (gen() % 2) {
+      s21_multiset.insert(value);
+      std_multiset.insert(value);
+    } else {
+      auto found = s21_multiset.find(value);
+      EXPECT_EQ(found != s21_multiset.end(), std_multiset.count(value) > 0);
+      if (found != s21_multiset.end()) {
+        s21_multiset.erase(found);
+        std_multiset.erase(std_multiset.find(value));
+      }
+    }
+  }
+  ASSERT_EQ(s21_multiset.size(), std_multiset.size());
+  EXPECT_TRUE(std::equal(s21_multiset.begin(), s21_multiset.end(),
+                         std_multiset.begin(), std_multiset.end()));
+}
@@ -2,7 +2,16 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
 #include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 TEST(SetTest, DefaultConstuctor) {
   s21::set<int> s21_set;
@@ -375,4 +384,1044 @@ TEST(SetTest, EraseInsertFindRandom) {
 
     EXPECT_EQ(s21_set.size(), std_set.size());
   }
-}
\ No newline at end of file
+}
+
+TEST(SetTest, IndexStorageInsertFindErase) {
+  s21::set<int, s21::index_storage> s21_set = {10, 20, 15, 1, 22, 0, 12, 78};
+  std::set<int> std_set = {10, 20, 15, 1, 22, 0, 12, 78};
+
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  EXPECT_TRUE(s21_set.contains(15));
+  EXPECT_FALSE(s21_set.insert(15).second);
+
+  s21_set.erase(s21_set.find(15));
+  std_set.erase(15);
+  s21_set.erase(s21_set.begin());
+  std_set.erase(std_set.begin());
+  s21_set.erase(--s21_set.end());
+  std_set.erase(--std_set.end());
+
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  auto std_it = std_set.begin();
+  for (auto it = s21_set.begin(); it != s21_set.end(); ++it, ++std_it) {
+    EXPECT_EQ(*it, *std_it);
+  }
+}
+
+TEST(SetTest, IndexStorageRandomChurn) {
+  s21::set<int, s21::index_storage> s21_set;
+  std::set<int> std_set;
+  std::srand(42);
+  for (int i = 0; i < 2000; i++) {
+    int value = std::rand() % 500;
+    if (std::rand() % 3 == 0) {
+      auto it = s21_set.find(value);
+      EXPECT_EQ(it != s21_set.end(), std_set.count(value) == 1);
+      if (it != s21_set.end()) s21_set.erase(it);
+      std_set.erase(value);
+    } else {
+      EXPECT_EQ(s21_set.insert(value).second, std_set.insert(value).second);
+    }
+  }
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  auto std_it = std_set.rbegin();
+  for (auto it = --s21_set.end(); std_it != std_set.rend(); --it, ++std_it) {
+    EXPECT_EQ(*it, *std_it);
+  }
+}
+
+TEST(SetTest, IndexStorageCopyMoveClear) {
+  s21::set<std::string, s21::index_storage> s21_set1 = {"b", "a", "c"};
+  s21::set<std::string, s21::index_storage> s21_set2 = s21_set1;
+  s21_set1.clear();
+  EXPECT_TRUE(s21_set1.empty());
+  EXPECT_EQ(s21_set2.size(), 3);
+  EXPECT_EQ(*s21_set2.begin(), "a");
+
+  s21::set<std::string, s21::index_storage> s21_set3 = std::move(s21_set2);
+  EXPECT_EQ(s21_set2.size(), 0);
+  EXPECT_TRUE(s21_set3.contains("c"));
+  s21_set3.insert("d");
+  EXPECT_EQ(*(--s21_set3.end()), "d");
+}
+
+TEST(SetTest, IndexStorageIteratorsSurviveMoveAndSwap) {
+  s21::set<int, s21::index_storage> s21_set;
+  for (int i = 0; i < 100; ++i) s21_set.insert(i);
+  auto it = s21_set.find(50);
+  auto last = s21_set.end();
+
+  s21::set<int, s21::index_storage> moved = std::move(s21_set);
+  s21_set.insert(-1);
+  EXPECT_EQ(*it, 50);
+  EXPECT_EQ(*++it, 51);
+  EXPECT_EQ(*--last, 99);
+
+  s21::set<int, s21::index_storage> other = {1000, 2000};
+  moved.swap(other);
+  EXPECT_EQ(*--it, 50);
+  auto next = it;
+  for (int i = 0; i < 49; ++i) ++next;
+  EXPECT_EQ(*next, 99);
+  EXPECT_TRUE(++next == other.end());
+}
+
+TEST(SetTest, FindManyContainsMany) {
+  s21::set<int> s21_set;
+  for (int i = 0; i < 1000; i += 2) s21_set.insert(i);
+
+  std::vector<int> keys;
+  for (int i = -5; i < 1005; i += 3) keys.push_back(i);
+
+  std::vector<s21::set<int>::iterator> found;
+  s21_set.find_many(keys, std::back_inserter(found));
+  std::vector<bool> present;
+  s21_set.contains_many(keys, std::back_inserter(present));
+
+  ASSERT_EQ(found.size(), keys.size());
+  ASSERT_EQ(present.size(), keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_TRUE(found[i] == s21_set.find(keys[i]));
+    EXPECT_EQ(present[i], s21_set.contains(keys[i]));
+  }
+
+  s21::set<int> empty;
+  std::vector<bool> none;
+  empty.contains_many(keys, std::back_inserter(none));
+  EXPECT_EQ(none, std::vector<bool>(keys.size(), false));
+}
+
+TEST(SetTest, IndexStorageFindMany) {
+  s21::set<int, s21::index_storage> s21_set = {5, 1, 9, 3, 7};
+  std::vector<int> keys = {9, 2, 1, 7, 8};
+  std::vector<s21::set<int, s21::index_storage>::iterator> found;
+  s21_set.find_many(keys, std::back_inserter(found));
+
+  EXPECT_EQ(*found[0], 9);
+  EXPECT_TRUE(found[1] == s21_set.end());
+  EXPECT_EQ(*found[2], 1);
+  EXPECT_EQ(*found[3], 7);
+  EXPECT_TRUE(found[4] == s21_set.end());
+}
+
+TEST(SetTest, InsertWithHint) {
+  s21::set<int> s21_set;
+  std::set<int> std_set;
+
+  auto hint = s21_set.end();
+  for (int i = 0; i < 200; ++i) {
+    int value = i % 10 == 9 ? i - 5 : i * 2;
+    hint = s21_set.insert(hint, value);
+    std_set.insert(value);
+    EXPECT_EQ(*hint, value);
+  }
+  hint = s21_set.insert(s21_set.begin(), -1);
+  EXPECT_EQ(*hint, -1);
+  hint = s21_set.insert(s21_set.find(100), 1001);
+  EXPECT_EQ(*hint, 1001);
+  hint = s21_set.insert(s21_set.find(100), 100);
+  EXPECT_EQ(*hint, 100);
+  std_set.insert({-1, 1001});
+
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  auto std_it = std_set.begin();
+  for (auto it = s21_set.begin(); it != s21_set.end(); ++it, ++std_it) {
+    EXPECT_EQ(*it, *std_it);
+  }
+}
+
+TEST(SetTest, EmplaceHint) {
+  s21::set<std::string> s21_set = {"b", "d"};
+  auto it = s21_set.emplace_hint(s21_set.find("d"), 1, 'c');
+  EXPECT_EQ(*it, "c");
+  EXPECT_EQ(*(++it), "d");
+  EXPECT_EQ(s21_set.size(), 3);
+}
+
+TEST(SetTest, PushBackOrdered) {
+  s21::set<int> s21_set;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(*s21_set.push_back_ordered(i * 3), i * 3);
+  }
+  EXPECT_EQ(s21_set.size(), 100);
+  EXPECT_EQ(*(--s21_set.end()), 297);
+
+  s21_set.erase(--s21_set.end());
+  s21_set.erase(--s21_set.end());
+  s21_set.push_back_ordered(295);
+  EXPECT_TRUE(s21_set.insert(400).second);
+  EXPECT_FALSE(s21_set.insert(295).second);
+  EXPECT_EQ(*(--s21_set.end()), 400);
+  EXPECT_EQ(*(-- --s21_set.end()), 295);
+
+  s21::set<int> copy = s21_set;
+  copy.push_back_ordered(500);
+  EXPECT_EQ(*(--copy.end()), 500);
+  EXPECT_EQ(copy.size(), s21_set.size() + 1);
+
+  int expected = 0;
+  for (auto it = s21_set.begin(); expected < 294; ++it, expected += 3) {
+    EXPECT_EQ(*it, expected);
+  }
+}
+
+TEST(SetTest, FromUnsorted) {
+  std::vector<int> input;
+  std::srand(7);
+  for (int i = 0; i < 200000; ++i) input.push_back(std::rand() % 150000);
+
+  auto s21_set = s21::set<int>::from_unsorted(input.begin(), input.end(), 4);
+  std::set<int> std_set(input.begin(), input.end());
+
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  auto std_it = std_set.begin();
+  for (auto it = s21_set.begin(); it != s21_set.end(); ++it, ++std_it) {
+    ASSERT_EQ(*it, *std_it);
+  }
+  EXPECT_EQ(*(--s21_set.end()), *std_set.rbegin());
+
+  s21_set.insert(-1);
+  s21_set.erase(s21_set.find(input[0]));
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  EXPECT_EQ(*s21_set.begin(), -1);
+
+  std::vector<int> empty;
+  EXPECT_TRUE(s21::set<int>::from_unsorted(empty.begin(), empty.end()).empty());
+}
+
+TEST(SetTest, ParallelForEachReduce) {
+  std::vector<int> input(50000);
+  for (int i = 0; i < 50000; ++i) input[i] = (i * 7919) % 50000;
+  auto s21_set = s21::set<int>::from_unsorted(input.begin(), input.end());
+
+  std::atomic<long long> sum{0};
+  s21::parallel_for_each(s21_set, [&sum](int value) { sum += value; }, 4);
+  EXPECT_EQ(sum.load(), 50000LL * 49999 / 2);
+
+  long long reduced = s21::parallel_reduce(
+      s21_set, 0LL, [](long long acc, int value) { return acc + value; },
+      [](long long lhs, long long rhs) { return lhs + rhs; }, 4);
+  EXPECT_EQ(reduced, 50000LL * 49999 / 2);
+
+  // bool results from different workers must not share a word.
+  auto any = [](bool lhs, bool rhs) { return lhs || rhs; };
+  EXPECT_TRUE(s21::parallel_reduce(
+      s21_set, false, [](bool acc, int value) { return acc || value == 49999; },
+      any, 4));
+  EXPECT_FALSE(s21::parallel_reduce(
+      s21_set, false, [](bool acc, int value) { return acc || value < 0; },
+      any, 4));
+
+  std::vector<int> ordered = s21::to_vector(s21_set, 3);
+  ASSERT_EQ(ordered.size(), s21_set.size());
+  for (int i = 0; i < 50000; ++i) EXPECT_EQ(ordered[i], i);
+
+  s21::set<int> empty;
+  EXPECT_TRUE(s21::to_vector(empty).empty());
+
+  // Small containers stay on the calling thread.
+  auto small = s21::set<int>::from_unsorted(input.begin(), input.begin() + 100);
+  std::thread::id caller = std::this_thread::get_id();
+  bool elsewhere = false;
+  s21::parallel_for_each(
+      small, [&](int) { elsewhere |= std::this_thread::get_id() != caller; },
+      4);
+  EXPECT_FALSE(elsewhere);
+}
+
+template <typename Storage>
+class SetStorageTest : public ::testing::Test {};
+
+using BulkStorages = ::testing::Types<s21::node_storage, s21::avl_storage,
+                                      s21::index_storage>;
+TYPED_TEST_SUITE(SetStorageTest, BulkStorages);
+
+TYPED_TEST(SetStorageTest, FromUnsortedAndParallelWalks) {
+  using Set = s21::set<int, TypeParam>;
+  std::vector<int> input;
+  std::srand(11);
+  for (int i = 0; i < 100000; ++i) input.push_back(std::rand() % 60000);
+  std::set<int> std_set(input.begin(), input.end());
+
+  Set s21_set = Set::from_unsorted(input.begin(), input.end(), 4);
+  ASSERT_EQ(s21_set.size(), std_set.size());
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), std_set.begin()));
+  EXPECT_EQ(*(--s21_set.end()), *std_set.rbegin());
+  s21_set.insert(-1);
+  s21_set.erase(s21_set.find(*std_set.begin()));
+  EXPECT_EQ(*s21_set.begin(), -1);
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  s21_set.erase(s21_set.begin());
+  s21_set.insert(*std_set.begin());
+
+  long long expected = 0;
+  for (int value : std_set) expected += value;
+  std::atomic<long long> sum{0};
+  s21::parallel_for_each(s21_set, [&sum](int value) { sum += value; }, 4);
+  EXPECT_EQ(sum.load(), expected);
+  long long reduced = s21::parallel_reduce(
+      s21_set, 0LL, [](long long acc, int value) { return acc + value; },
+      [](long long lhs, long long rhs) { return lhs + rhs; }, 4);
+  EXPECT_EQ(reduced, expected);
+  std::vector<int> ordered = s21::to_vector(s21_set, 3);
+  EXPECT_TRUE(std::equal(ordered.begin(), ordered.end(), std_set.begin(),
+                         std_set.end()));
+
+  std::vector<int> empty;
+  EXPECT_TRUE(Set::from_unsorted(empty.begin(), empty.end()).empty());
+}
+
+TEST(SetTest, SaveLoad) {
+  s21::set<std::string> s21_set = {"b", "a", "c", ""};
+  std::stringstream buffer;
+  s21_set.save(buffer);
+
+  s21::set<std::string> loaded;
+  loaded.load(buffer);
+  EXPECT_EQ(loaded.size(), 4);
+  EXPECT_EQ(*loaded.begin(), "");
+  EXPECT_EQ(*(--loaded.end()), "c");
+
+  s21::set<long> numbers;
+  std::stringstream empty_buffer;
+  numbers.save(empty_buffer);
+  numbers.insert(3);
+  numbers.load(empty_buffer);
+  EXPECT_TRUE(numbers.empty());
+}
+
+TEST(SetTest, MemoryStats) {
+  s21::set<int> s21_set;
+  s21::tree_memory_stats empty = s21_set.memory_stats(s21::stats_mode::full);
+  EXPECT_EQ(empty.node_count, 0u);
+  EXPECT_EQ(empty.height, 0);
+
+  for (int i = 0; i < 4095; ++i) s21_set.insert(i);
+  s21::tree_memory_stats full = s21_set.memory_stats(s21::stats_mode::full);
+  EXPECT_EQ(full.node_count, 4095u);
+  EXPECT_GE(full.bytes_per_node, sizeof(int) + 3 * sizeof(void *));
+  EXPECT_GE(full.bytes, full.node_count * full.bytes_per_node);
+  // Red-black bounds: height <= 2 log2(n + 1), black height >= height / 2.
+  EXPECT_GE(full.height, 12);
+  EXPECT_LE(full.height, 24);
+  ASSERT_TRUE(full.black_height && full.red_ratio);
+  EXPECT_GE(2 * *full.black_height, full.height);
+  EXPECT_LE(full.average_depth, full.height);
+  EXPECT_GT(*full.red_ratio, 0.0);
+  EXPECT_FALSE(full.sampled);
+
+  s21::tree_memory_stats sampled = s21_set.memory_stats();
+  EXPECT_TRUE(sampled.sampled);
+  EXPECT_EQ(sampled.black_height, full.black_height);
+  EXPECT_LE(sampled.height, full.height);
+  EXPECT_NEAR(sampled.average_depth, full.average_depth,
+              0.25 * full.average_depth);
+
+  std::ostringstream metrics;
+  s21::write_metrics(metrics, full, "orders_index");
+  EXPECT_NE(metrics.str().find("orders_index_nodes 4095\n"),
+            std::string::npos);
+  EXPECT_NE(metrics.str().find("orders_index_sampled 0\n"), std::string::npos);
+
+  // AVL nodes carry no meaningful color, so those fields stay empty.
+  s21::set<int, s21::avl_storage> avl_set;
+  for (int i = 0; i < 1000; ++i) avl_set.insert(i);
+  s21::tree_memory_stats avl = avl_set.memory_stats(s21::stats_mode::full);
+  EXPECT_FALSE(avl.black_height);
+  EXPECT_FALSE(avl.red_ratio);
+  EXPECT_FALSE(avl_set.memory_stats().red_ratio);
+  std::ostringstream avl_metrics;
+  s21::write_metrics(avl_metrics, avl, "avl");
+  EXPECT_EQ(avl_metrics.str().find("black_height"), std::string::npos);
+  EXPECT_EQ(avl_metrics.str().find("red_ratio"), std::string::npos);
+}
+
+TEST(SetTest, SmallStoragePromotesAndDemotes) {
+  s21::set<int, s21::small_storage<4>> s21_set = {3, 1, 2};
+  std::set<int> std_set = {3, 1, 2};
+  EXPECT_TRUE(s21_set.is_inline());
+  EXPECT_FALSE(s21_set.insert(2).second);
+  EXPECT_EQ(*s21_set.insert(0).first, 0);
+  EXPECT_TRUE(s21_set.is_inline());
+  std_set.insert(0);
+
+  for (int value : {9, 4, 7, 5}) {
+    EXPECT_TRUE(s21_set.insert(value).second);
+    std_set.insert(value);
+  }
+  EXPECT_FALSE(s21_set.is_inline());
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                         std_set.end()));
+  EXPECT_EQ(*--s21_set.end(), 9);
+
+  while (!s21_set.empty()) s21_set.erase(s21_set.begin());
+  EXPECT_TRUE(s21_set.is_inline());
+  s21_set.insert(42);
+  EXPECT_EQ(*s21_set.begin(), 42);
+}
+
+TEST(SetTest, SmallStorageRandomChurn) {
+  s21::set<int, s21::small_storage<8>> s21_set;
+  std::set<int> std_set;
+  std::srand(7);
+  for (int i = 0; i < 3000; i++) {
+    int value = std::rand() % 24;
+    if (!s21_set.is_inline() && std::rand() % 16 == 0) {
+      s21_set.clear();
+      std_set.clear();
+    } else if (std::rand() % 2 == 0) {
+      auto it = s21_set.find(value);
+      EXPECT_EQ(it != s21_set.end(), std_set.count(value) == 1);
+      if (it != s21_set.end()) s21_set.erase(it);
+      std_set.erase(value);
+    } else {
+      EXPECT_EQ(s21_set.insert(value).second, std_set.insert(value).second);
+    }
+    ASSERT_EQ(s21_set.size(), std_set.size());
+    ASSERT_TRUE(std::equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                           std_set.end()));
+  }
+  auto std_it = std_set.rbegin();
+  for (auto it = s21_set.end(); std_it != std_set.rend(); ++std_it) {
+    EXPECT_EQ(*--it, *std_it);
+  }
+}
+
+TEST(SetTest, SmallStorageCopyMoveSwap) {
+  using SmallSet = s21::set<std::string, s21::small_storage<2>>;
+  SmallSet small = {"b", "a"};
+  SmallSet large = {"x", "z", "y"};
+  EXPECT_LE(sizeof(SmallSet),
+            2 * sizeof(std::string) + 2 * sizeof(std::size_t));
+
+  SmallSet small_copy = small;
+  SmallSet large_copy = large;
+  EXPECT_EQ(*small_copy.begin(), "a");
+  EXPECT_EQ(*--large_copy.end(), "z");
+
+  small_copy.swap(large_copy);
+  EXPECT_EQ(small_copy.size(), 3);
+  EXPECT_EQ(large_copy.size(), 2);
+
+  SmallSet moved = std::move(small_copy);
+  EXPECT_TRUE(small_copy.empty());
+  EXPECT_TRUE(moved.contains("y"));
+  moved = large_copy;
+  EXPECT_TRUE(moved.is_inline());
+  EXPECT_EQ(moved.size(), 2);
+
+  std::vector<int> few = {5, 3, 5, 1};
+  auto built = s21::set<int, s21::small_storage<4>>::from_unsorted(
+      few.begin(), few.end(), 1);
+  EXPECT_TRUE(built.is_inline());
+  EXPECT_EQ(built.size(), 3);
+  std::vector<int> many = {8, 6, 4, 2, 0};
+  built = s21::set<int, s21::small_storage<4>>::from_unsorted(many.begin(),
+                                                               many.end(), 1);
+  EXPECT_FALSE(built.is_inline());
+  EXPECT_EQ(*built.begin(), 0);
+}
+
+namespace {
+
+// Its copy and move constructors throw once budget of them have run.
+struct Fragile {
+  static inline int budget = -1;
+  int value;
+
+  Fragile(int v) : value(v) {}
+  Fragile(const Fragile &other) : value(other.value) { spend(); }
+  Fragile(Fragile &&other) : value(other.value) { spend(); }
+  static void spend() {
+    if (budget-- == 0) throw std::runtime_error("copy");
+  }
+  bool operator<(const Fragile &other) const { return value < other.value; }
+};
+
+template <typename Set>
+std::vector<int> valuesOf(const Set &set) {
+  std::vector<int> values;
+  for (const Fragile &item : set) values.push_back(item.value);
+  return values;
+}
+
+}  // namespace
+
+TEST(SetTest, SmallStorageThrowingMoves) {
+  s21::set<Fragile, s21::small_storage<4>> s21_set = {1, 3};
+
+  // The value is copied before anything moves.
+  Fragile::budget = 0;
+  EXPECT_THROW(s21_set.insert(Fragile(2)), std::runtime_error);
+  EXPECT_EQ(valuesOf(s21_set), std::vector<int>({1, 3}));
+  // Relocating 3 throws: nothing has moved yet.
+  Fragile::budget = 1;
+  EXPECT_THROW(s21_set.insert(Fragile(2)), std::runtime_error);
+  EXPECT_EQ(valuesOf(s21_set), std::vector<int>({1, 3}));
+  // Placing 2 throws after 3 moved up: 3 is dropped, the rest stays sorted.
+  Fragile::budget = 2;
+  EXPECT_THROW(s21_set.insert(Fragile(2)), std::runtime_error);
+  EXPECT_EQ(valuesOf(s21_set), std::vector<int>({1}));
+
+  Fragile::budget = -1;
+  for (int value : {4, 2, 3}) s21_set.insert(Fragile(value));
+  // A failed switch to a tree keeps the full array.
+  Fragile::budget = 3;
+  EXPECT_THROW(s21_set.insert(Fragile(5)), std::runtime_error);
+  EXPECT_TRUE(s21_set.is_inline());
+  EXPECT_EQ(valuesOf(s21_set), std::vector<int>({1, 2, 3, 4}));
+  Fragile::budget = -1;
+  s21_set.insert(Fragile(5));
+  EXPECT_FALSE(s21_set.is_inline());
+  EXPECT_EQ(valuesOf(s21_set), std::vector<int>({1, 2, 3, 4, 5}));
+}
+
+namespace {
+
+// Counts calls so the test can tell which search path the tree took.
+struct CountingThreeWay {
+  using is_three_way = void;
+  static inline int less_calls = 0;
+  static inline int three_way_calls = 0;
+
+  bool operator()(int lhs, int rhs) const {
+    ++less_calls;
+    return lhs < rhs;
+  }
+  int three_way(int lhs, int rhs) const {
+    ++three_way_calls;
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+  }
+};
+
+}  // namespace
+
+TEST(SetTest, ThreeWayComparatorOneCallPerLevel) {
+  s21::RBTree<int, CountingThreeWay> tree;
+  for (int i = 0; i < 1023; ++i) tree.insert((i * 37) % 1023);
+  int height = tree.memory_stats(s21::stats_mode::full).height;
+
+  CountingThreeWay::less_calls = 0;
+  CountingThreeWay::three_way_calls = 0;
+  for (int i = 0; i < 1023; ++i) EXPECT_TRUE(tree.contains(i));
+  EXPECT_FALSE(tree.contains(5000));
+  EXPECT_EQ(CountingThreeWay::less_calls, 0);
+  EXPECT_LE(CountingThreeWay::three_way_calls, 1024 * height);
+
+  // insert() only adds the single less call of its append check.
+  EXPECT_FALSE(tree.insert(17).second);
+  EXPECT_EQ(CountingThreeWay::less_calls, 1);
+}
+
+namespace {
+
+// Opens the tree core's links to check each balancing policy's rules.
+template <typename Balance>
+struct CheckedTree : s21::RBTree<int, std::less<int>, Balance> {
+  using Base = s21::RBTree<int, std::less<int>, Balance>;
+  using Node = typename Base::Node;
+  using Base::buildFromSorted;
+
+  // Black height of the subtree, or -1 if a rule or a parent link is broken.
+  static int blackHeight(const Node *node, const Node *parent) {
+    if (!node) return 1;
+    if (node->parent != parent) return -1;
+    bool red = node->color == Node::RED;
+    if (red && ((node->left && node->left->color == Node::RED) ||
+                (node->right && node->right->color == Node::RED))) {
+      return -1;
+    }
+    int left = blackHeight(node->left, node);
+    int right = blackHeight(node->right, node);
+    if (left < 0 || left != right) return -1;
+    return left + (red ? 0 : 1);
+  }
+
+  // Checks the rank rules bottom-up; returns the true height or -1.
+  static int rankedHeight(const Node *node, const Node *parent) {
+    if (!node) return 0;
+    if (node->parent != parent) return -1;
+    int left = rankedHeight(node->left, node);
+    int right = rankedHeight(node->right, node);
+    if (left < 0 || right < 0) return -1;
+    int rank = node->rank;
+    int left_rank = node->left ? node->left->rank : 0;
+    int right_rank = node->right ? node->right->rank : 0;
+    if (std::is_same<Balance, s21::avl_balance>::value) {
+      if (rank != 1 + std::max(left, right) || std::abs(left - right) > 1) {
+        return -1;
+      }
+    } else {
+      // WAVL: rank differences 1 or 2, leaves have rank 1.
+      if (rank - left_rank < 1 || rank - left_rank > 2) return -1;
+      if (rank - right_rank < 1 || rank - right_rank > 2) return -1;
+      if (!node->left && !node->right && rank != 1) return -1;
+    }
+    return 1 + std::max(left, right);
+  }
+
+  bool balanced() const {
+    double n = static_cast<double>(this->size());
+    int height = this->memory_stats(s21::stats_mode::full).height;
+    if (std::is_same<Balance, s21::rb_balance>::value) {
+      if (this->root_ && this->root_->color != Node::BLACK) return false;
+      if (blackHeight(this->root_, nullptr) < 0) return false;
+      return height <= 2 * std::log2(n + 1);
+    }
+    if (rankedHeight(this->root_, nullptr) < 0) return false;
+    if (std::is_same<Balance, s21::avl_balance>::value) {
+      return height <= 1.4405 * std::log2(n + 2);
+    }
+    return height <= 2 * std::log2(n + 1);
+  }
+
+  // Whether size() returns without counting the nodes.
+  bool sizeCounted() const {
+    return this->size_.load() != Base::kUnknownSize;
+  }
+};
+
+// Descending erase, erase from alternating ends and random churn, checking
+// the policy's invariants along the way.
+template <typename Balance>
+void checkErasePatterns() {
+  constexpr int kCount = 4096;
+  auto fill = [](CheckedTree<Balance> &tree) {
+    for (int i = 0; i < kCount; ++i) tree.insert((i * 1237) % kCount);
+  };
+
+  CheckedTree<Balance> descending;
+  fill(descending);
+  ASSERT_TRUE(descending.balanced());
+  for (int i = kCount - 1; i >= 0; --i) {
+    descending.erase(descending.find(i));
+    if (i % 256 == 0) {
+      ASSERT_TRUE(descending.balanced()) << i;
+    }
+  }
+  EXPECT_TRUE(descending.empty());
+
+  CheckedTree<Balance> alternating;
+  fill(alternating);
+  for (int i = 0; !alternating.empty(); ++i) {
+    alternating.erase(i % 2 ? --alternating.end() : alternating.begin());
+    if (i % 256 == 0) {
+      ASSERT_TRUE(alternating.balanced()) << i;
+    }
+  }
+
+  CheckedTree<Balance> churn;
+  std::set<int> expected;
+  std::srand(11);
+  for (int i = 0; i < 20000; ++i) {
+    int value = std::rand() % kCount;
+    if (std::rand() % 2) {
+      churn.insert(value);
+      expected.insert(value);
+    } else if (churn.contains(value)) {
+      churn.erase(churn.find(value));
+      expected.erase(value);
+    }
+    if (i % 500 == 0) {
+      ASSERT_TRUE(churn.balanced()) << i;
+    }
+  }
+  EXPECT_TRUE(churn.balanced());
+  EXPECT_TRUE(std::equal(churn.begin(), churn.end(), expected.begin(),
+                         expected.end()));
+
+  // Bulk-built trees start out valid too.
+  std::vector<int> sorted(kCount);
+  for (int i = 0; i < kCount; ++i) sorted[i] = 2 * i;
+  CheckedTree<Balance> built;
+  built.buildFromSorted(sorted.begin(), sorted.end());
+  EXPECT_TRUE(built.balanced());
+  for (int i = 1; i < 2 * kCount; i += 2) built.insert(i);
+  EXPECT_TRUE(built.balanced());
+}
+
+}  // namespace
+
+TEST(SetTest, EraseKeepsRedBlackInvariants) {
+  checkErasePatterns<s21::rb_balance>();
+}
+
+TEST(SetTest, AvlBalanceInvariants) { checkErasePatterns<s21::avl_balance>(); }
+
+TEST(SetTest, WavlBalanceInvariants) {
+  checkErasePatterns<s21::wavl_balance>();
+}
+
+TEST(SetTest, BalancePoliciesBehindSetAndMap) {
+  s21::set<int, s21::avl_storage> avl_set = {5, 3, 8, 1};
+  s21::set<int, s21::wavl_storage> wavl_set = {5, 3, 8, 1};
+  std::set<int> std_set = {5, 3, 8, 1};
+  for (int i = 0; i < 500; ++i) {
+    int value = (i * 37) % 200;
+    if (i % 3 == 0 && avl_set.contains(value)) {
+      avl_set.erase(avl_set.find(value));
+      wavl_set.erase(wavl_set.find(value));
+      std_set.erase(value);
+    } else {
+      avl_set.insert(value);
+      wavl_set.insert(value);
+      std_set.insert(value);
+    }
+  }
+  EXPECT_TRUE(std::equal(avl_set.begin(), avl_set.end(), std_set.begin(),
+                         std_set.end()));
+  EXPECT_TRUE(std::equal(wavl_set.begin(), wavl_set.end(), std_set.begin(),
+                         std_set.end()));
+
+  // A sorted insert gives a complete tree under AVL, not under red-black.
+  s21::set<int> rb_sorted;
+  s21::set<int, s21::avl_storage> avl_sorted;
+  for (int i = 0; i < 1023; ++i) {
+    rb_sorted.insert(i);
+    avl_sorted.insert(i);
+  }
+  EXPECT_EQ(avl_sorted.memory_stats(s21::stats_mode::full).height, 10);
+  EXPECT_GT(rb_sorted.memory_stats(s21::stats_mode::full).height, 10);
+}
+
+namespace {
+
+struct SplayProbe : s21::RBTree<int, std::less<int>, s21::splay_balance> {
+  int rootValue() const { return root_->data; }
+};
+
+}  // namespace
+
+TEST(SetTest, SplayMovesAccessedKeysToRoot) {
+  SplayProbe tree;
+  for (int i = 0; i < 1000; ++i) tree.insert((i * 389) % 1000);
+  EXPECT_EQ(tree.rootValue(), (999 * 389) % 1000);
+  EXPECT_NE(tree.find(123), tree.end());
+  EXPECT_EQ(tree.rootValue(), 123);
+  EXPECT_EQ(tree.find(5000), tree.end());
+  EXPECT_EQ(tree.rootValue(), 999);
+  tree.erase(tree.find(500));
+  EXPECT_EQ(tree.size(), 999u);
+  EXPECT_EQ(tree.find(500), tree.end());
+  EXPECT_TRUE(tree.contains(499));
+  EXPECT_EQ(tree.rootValue(), 499);
+}
+
+TEST(SetTest, SplayStorageMatchesStd) {
+  s21::set<int, s21::splay_storage> s21_set;
+  std::set<int> std_set;
+  std::srand(23);
+  for (int i = 0; i < 20000; ++i) {
+    int value = std::rand() % 3000;
+    switch (std::rand() % 3) {
+      case 0:
+        EXPECT_EQ(s21_set.insert(value).second, std_set.insert(value).second);
+        break;
+      case 1:
+        EXPECT_EQ(s21_set.contains(value), std_set.count(value) == 1);
+        break;
+      default:
+        if (s21_set.contains(value)) s21_set.erase(s21_set.find(value));
+        std_set.erase(value);
+    }
+  }
+  ASSERT_EQ(s21_set.size(), std_set.size());
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                         std_set.end()));
+
+  // Sorted inserts leave one long path: copy and destruction must not
+  // recurse along it.
+  s21::set<int, s21::splay_storage> path;
+  for (int i = 0; i < 200000; ++i) path.insert(i);
+  EXPECT_EQ(path.memory_stats(s21::stats_mode::full).height, 200000);
+  s21::set<int, s21::splay_storage> copy(path);
+  EXPECT_EQ(copy.size(), path.size());
+  EXPECT_EQ(*--copy.end(), 199999);
+  EXPECT_TRUE(copy.contains(0));
+}
+
+template <typename Set>
+void checkFingerSearch() {
+  Set s21_set;
+  std::set<int> std_set;
+  std::srand(31);
+  for (int i = 0; i < 2000; ++i) {
+    int value = std::rand() % 6000;
+    s21_set.insert(value);
+    std_set.insert(value);
+  }
+  std::vector<int> present(std_set.begin(), std_set.end());
+  for (int i = 0; i < 5000; ++i) {
+    auto hint = s21_set.find(present[std::rand() % present.size()]);
+    if (i % 7 == 0) hint = s21_set.end();
+    int key = std::rand() % 6200 - 100;
+    auto found = s21_set.find(hint, key);
+    if (std_set.count(key)) {
+      ASSERT_TRUE(found != s21_set.end());
+      EXPECT_EQ(*found, key);
+    } else {
+      EXPECT_TRUE(found == s21_set.end());
+    }
+  }
+}
+
+TEST(SetTest, FingerSearchMatchesFind) {
+  checkFingerSearch<s21::set<int>>();
+  checkFingerSearch<s21::set<int, s21::avl_storage>>();
+  checkFingerSearch<s21::set<int, s21::splay_storage>>();
+}
+
+TEST(SetTest, CursorSeeksInBothDirections) {
+  s21::set<int> s21_set;
+  for (int i = 0; i < 1000; i += 2) s21_set.insert(i);
+
+  s21::set<int>::cursor cursor(s21_set);
+  EXPECT_FALSE(cursor.valid());
+  EXPECT_TRUE(cursor.seek(10));
+  EXPECT_EQ(*cursor, 10);
+  EXPECT_FALSE(cursor.seek(11));
+  EXPECT_EQ(*cursor, 12);
+  EXPECT_TRUE(cursor.seek(4));
+  EXPECT_FALSE(cursor.seek(-5));
+  EXPECT_EQ(*cursor, 0);
+  EXPECT_FALSE(cursor.seek(5000));
+  EXPECT_FALSE(cursor.valid());
+  EXPECT_TRUE(cursor.position() == s21_set.end());
+  EXPECT_TRUE(cursor.seek(998));
+  EXPECT_TRUE(cursor.position() == s21_set.find(998));
+
+  // Every lower bound along an ascending and a descending sweep.
+  std::set<int> std_set(s21_set.begin(), s21_set.end());
+  for (int key = -3; key < 1003; key += 3) {
+    bool hit = cursor.seek(key);
+    auto expected = std_set.lower_bound(key);
+    ASSERT_EQ(cursor.valid(), expected != std_set.end());
+    if (cursor.valid()) {
+      EXPECT_EQ(*cursor, *expected);
+    }
+    EXPECT_EQ(hit, std_set.count(key) == 1);
+  }
+  for (int key = 1003; key > -3; key -= 7) {
+    cursor.seek(key);
+    auto expected = std_set.lower_bound(key);
+    ASSERT_EQ(cursor.valid(), expected != std_set.end());
+    if (cursor.valid()) {
+      EXPECT_EQ(*cursor, *expected);
+    }
+  }
+
+  s21::set<int> empty;
+  s21::set<int>::cursor empty_cursor(empty);
+  EXPECT_FALSE(empty_cursor.seek(1));
+}
+
+namespace {
+
+std::vector<int> randomKeys(int count, int range, unsigned seed) {
+  std::srand(seed);
+  std::vector<int> keys(count);
+  for (int &key : keys) key = std::rand() % range;
+  return keys;
+}
+
+}  // namespace
+
+TEST(SetTest, SplitAndJoin) {
+  CheckedTree<s21::rb_balance> tree;
+  for (int i = 0; i < 3000; ++i) tree.insert((i * 1237) % 3000);
+
+  for (int key : {1500, 0, 2999, 7, -5, 4000}) {
+    CheckedTree<s21::rb_balance> left(tree), right;
+    right.insert(123456);  // replaced by the split
+    bool present = key >= 0 && key < 3000;
+    EXPECT_EQ(left.split(key, right), present);
+    ASSERT_TRUE(left.balanced()) << key;
+    ASSERT_TRUE(right.balanced()) << key;
+    int below = std::min(std::max(key, 0), 3000);
+    EXPECT_EQ(left.size(), static_cast<std::size_t>(below));
+    EXPECT_EQ(left.size() + right.size(), 3000u - present);
+    if (!left.empty()) {
+      EXPECT_LT(*--left.end(), key);
+    }
+    if (!right.empty()) {
+      EXPECT_GT(*right.begin(), key);
+    }
+
+    if (present) {
+      left.join(key, right);
+      EXPECT_TRUE(right.empty());
+      ASSERT_TRUE(left.balanced());
+      EXPECT_EQ(left.size(), 3000u);
+      EXPECT_TRUE(std::equal(left.begin(), left.end(), tree.begin(),
+                             tree.end()));
+    }
+  }
+
+  // Very different heights join in place; out-of-order keys are refused.
+  CheckedTree<s21::rb_balance> small, large;
+  small.insert(1);
+  for (int i = 10; i < 5000; ++i) large.insert(i);
+  small.join(5, large);
+  EXPECT_TRUE(small.balanced());
+  EXPECT_EQ(small.size(), 4992u);
+  CheckedTree<s21::rb_balance> tail;
+  tail.insert(3);
+  EXPECT_THROW(small.join(6000, tail), std::invalid_argument);
+  EXPECT_EQ(tail.size(), 1u);
+}
+
+TEST(SetTest, SplitLeavesCountingToSize) {
+  CheckedTree<s21::rb_balance> tree, right;
+  for (int i = 0; i < 1 << 16; ++i) tree.insert(i);
+
+  // The cut touches O(log n) nodes, so neither half is counted yet.
+  tree.split_at(1000, right);
+  EXPECT_FALSE(tree.sizeCounted());
+  EXPECT_FALSE(right.sizeCounted());
+  right.insert(1 << 16);
+  right.erase(right.begin());
+  EXPECT_FALSE(right.sizeCounted());
+  EXPECT_EQ(right.size(), (1u << 16) - 1000);
+  EXPECT_TRUE(right.sizeCounted());
+  right.erase(right.begin());
+  EXPECT_EQ(right.size(), (1u << 16) - 1001);
+
+  tree.concat(right);
+  EXPECT_FALSE(tree.sizeCounted());
+  EXPECT_EQ(tree.size(), (1u << 16) - 1);
+  EXPECT_TRUE(tree.balanced());
+
+  // An empty half hands its known size over to the other one.
+  CheckedTree<s21::rb_balance> upper;
+  tree.split_at(-1, upper);
+  EXPECT_TRUE(tree.sizeCounted());
+  EXPECT_TRUE(upper.sizeCounted());
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(upper.size(), (1u << 16) - 1);
+}
+
+TEST(SetTest, SetAlgebraMatchesStd) {
+  for (auto sizes : {std::pair<int, int>{5000, 5000}, {20000, 40},
+                     {30, 20000}, {0, 100}, {100, 0}}) {
+    std::vector<int> a_keys = randomKeys(sizes.first, 30000, 41);
+    std::vector<int> b_keys = randomKeys(sizes.second, 30000, 43);
+    std::set<int> a_std(a_keys.begin(), a_keys.end());
+    std::set<int> b_std(b_keys.begin(), b_keys.end());
+    CheckedTree<s21::rb_balance> a, b;
+    for (int key : a_keys) a.insert(key);
+    for (int key : b_keys) b.insert(key);
+
+    std::vector<int> expected;
+    CheckedTree<s21::rb_balance> united(a);
+    united.unite(b);
+    std::set_union(a_std.begin(), a_std.end(), b_std.begin(), b_std.end(),
+                   std::back_inserter(expected));
+    ASSERT_TRUE(united.balanced());
+    EXPECT_EQ(united.size(), expected.size());
+    EXPECT_TRUE(std::equal(united.begin(), united.end(), expected.begin(),
+                           expected.end()));
+
+    expected.clear();
+    CheckedTree<s21::rb_balance> common(a);
+    common.intersect(b);
+    std::set_intersection(a_std.begin(), a_std.end(), b_std.begin(),
+                          b_std.end(), std::back_inserter(expected));
+    ASSERT_TRUE(common.balanced());
+    EXPECT_EQ(common.size(), expected.size());
+    EXPECT_TRUE(std::equal(common.begin(), common.end(), expected.begin(),
+                           expected.end()));
+
+    expected.clear();
+    CheckedTree<s21::rb_balance> rest(a);
+    rest.subtract(b);
+    std::set_difference(a_std.begin(), a_std.end(), b_std.begin(),
+                        b_std.end(), std::back_inserter(expected));
+    ASSERT_TRUE(rest.balanced());
+    EXPECT_EQ(rest.size(), expected.size());
+    EXPECT_TRUE(std::equal(rest.begin(), rest.end(), expected.begin(),
+                           expected.end()));
+  }
+}
+
+namespace {
+
+// Throws once budget comparisons have run; shared by every thread.
+struct ThrowingLess {
+  static inline std::atomic<long> budget{-1};
+
+  bool operator()(int lhs, int rhs) const {
+    if (budget.fetch_sub(1) == 0) throw std::runtime_error("comparison");
+    return lhs < rhs;
+  }
+};
+
+}  // namespace
+
+TEST(SetTest, ThrowingSetAlgebraLeavesEmptyTree) {
+  using Tree = s21::RBTree<int, ThrowingLess>;
+  Tree even, odd;
+  for (int i = 0; i < 40000; i += 2) even.insert(i);
+  for (int i = 1; i < 40000; i += 2) odd.insert(i);
+
+  for (long budget : {0L, 10L, 3000L, 20000L}) {
+    for (unsigned threads : {1u, 4u}) {
+      Tree united(even), common(even), rest(even), split(even), right;
+      ThrowingLess::budget = budget;
+      EXPECT_THROW(united.unite(odd, threads), std::runtime_error);
+      ThrowingLess::budget = budget;
+      EXPECT_THROW(common.intersect(odd, threads), std::runtime_error);
+      ThrowingLess::budget = budget;
+      EXPECT_THROW(rest.subtract(odd, threads), std::runtime_error);
+      ThrowingLess::budget = budget % 20;
+      EXPECT_THROW(split.split(777, right), std::runtime_error);
+      ThrowingLess::budget = -1;
+
+      // Nothing leaks, and the trees stay usable.
+      for (Tree* tree : {&united, &common, &rest, &split}) {
+        EXPECT_TRUE(tree->empty());
+        EXPECT_EQ(tree->size(), 0u);
+        tree->insert(5);
+        EXPECT_EQ(tree->size(), 1u);
+      }
+    }
+  }
+  EXPECT_EQ(odd.size(), 20000u);
+}
+
+TEST(SetTest, ParallelSetAlgebraOnSets) {
+  std::vector<int> a_keys = randomKeys(60000, 200000, 47);
+  std::vector<int> b_keys = randomKeys(60000, 200000, 53);
+  s21::set<int> a, b;
+  for (int key : a_keys) a.insert(key);
+  for (int key : b_keys) b.insert(key);
+  std::set<int> a_std(a_keys.begin(), a_keys.end());
+  std::set<int> b_std(b_keys.begin(), b_keys.end());
+
+  std::vector<int> expected;
+  std::set_union(a_std.begin(), a_std.end(), b_std.begin(), b_std.end(),
+                 std::back_inserter(expected));
+  s21::set<int> united = s21::set_union(a, b, 4);
+  EXPECT_EQ(united.size(), expected.size());
+  EXPECT_TRUE(std::equal(united.begin(), united.end(), expected.begin(),
+                         expected.end()));
+
+  expected.clear();
+  std::set_intersection(a_std.begin(), a_std.end(), b_std.begin(),
+                        b_std.end(), std::back_inserter(expected));
+  s21::set<int> common = s21::set_intersection(a, b, 4);
+  EXPECT_EQ(common.size(), expected.size());
+  EXPECT_TRUE(std::equal(common.begin(), common.end(), expected.begin(),
+                         expected.end()));
+
+  expected.clear();
+  std::set_difference(a_std.begin(), a_std.end(), b_std.begin(), b_std.end(),
+                      std::back_inserter(expected));
+  s21::set<int> rest = s21::set_difference(a, b, 4);
+  EXPECT_EQ(rest.size(), expected.size());
+  EXPECT_TRUE(std::equal(rest.begin(), rest.end(), expected.begin(),
+                         expected.end()));
+  EXPECT_EQ(a.size(), a_std.size());  // the inputs are untouched
+
+  a.subtract(a);
+  EXPECT_TRUE(a.empty());
+}
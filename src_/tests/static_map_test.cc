@@ -0,0 +1,111 @@
+#include "../s21_containers/static_map/static_map.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <map>
+#include <string_view>
+
+namespace {
+
+enum class Status { ok = 200, created = 201, not_found = 404, teapot = 418 };
+
+constexpr auto kOpcodes = s21::make_static_map<int, std::string_view>(
+    {{0x20, "store"}, {0x01, "nop"}, {0x10, "load"}, {0x02, "halt"}});
+
+constexpr auto kStatusText = s21::make_static_map<Status, std::string_view>(
+    {{Status::not_found, "Not Found"},
+     {Status::ok, "OK"},
+     {Status::teapot, "I'm a teapot"},
+     {Status::created, "Created"},
+     {static_cast<Status>(500), "Internal Server Error"},
+     {static_cast<Status>(301), "Moved Permanently"},
+     {static_cast<Status>(204), "No Content"},
+     {static_cast<Status>(403), "Forbidden"},
+     {static_cast<Status>(503), "Service Unavailable"}});
+
+constexpr auto kMnemonics = s21::make_static_map<std::string_view, int>(
+    {{"nop", 0x01}, {"halt", 0x02}, {"load", 0x10}, {"store", 0x20},
+     {"add", 0x30}, {"sub", 0x31}, {"mul", 0x32}, {"div", 0x33},
+     {"jmp", 0x40}, {"jz", 0x41}, {"call", 0x50}, {"ret", 0x51}});
+
+// Built and searched entirely at compile time.
+static_assert(!decltype(kOpcodes)::kHashed);
+static_assert(decltype(kStatusText)::kHashed);
+static_assert(decltype(kMnemonics)::kHashed);
+static_assert(kOpcodes.at(0x10) == "load");
+static_assert(kOpcodes.begin()->first == 0x01);
+static_assert(!kOpcodes.contains(0x03));
+static_assert(kStatusText.at(Status::teapot) == "I'm a teapot");
+static_assert(kMnemonics.at("call") == 0x50);
+static_assert(kMnemonics.find("hcf") == nullptr);
+
+}  // namespace
+
+TEST(StaticMapTest, SortedLookupTable) {
+  EXPECT_EQ(kOpcodes.size(), 4);
+  int previous = 0;
+  for (const auto &entry : kOpcodes) {
+    EXPECT_LT(previous, entry.first);
+    previous = entry.first;
+  }
+  EXPECT_EQ(*kOpcodes.find(0x20), "store");
+  EXPECT_EQ(kOpcodes.find(0x21), nullptr);
+  EXPECT_EQ(kOpcodes.lower_bound(0x11)->first, 0x20);
+  EXPECT_EQ(kOpcodes.lower_bound(0x21), kOpcodes.end());
+  EXPECT_THROW(kOpcodes.at(0), std::out_of_range);
+
+  EXPECT_EQ(kStatusText.at(Status::not_found), "Not Found");
+  EXPECT_FALSE(kStatusText.contains(static_cast<Status>(402)));
+  EXPECT_EQ(kMnemonics.at("jz"), 0x41);
+  EXPECT_FALSE(kMnemonics.contains("jnz"));
+  EXPECT_EQ(kMnemonics.begin()->first, "add");
+}
+
+TEST(StaticMapTest, HashAndSearchAgree) {
+  constexpr int kCount = 300;
+  std::pair<long, int> items[kCount] = {};
+  std::map<long, int> expected;
+  std::srand(97);
+  for (int i = 0; i < kCount; ++i) {
+    long key = 0;
+    do {
+      key = std::rand() % 100000 - 50000;
+    } while (expected.count(key));
+    items[i] = {key, i};
+    expected[key] = i;
+  }
+
+  s21::static_map<long, int, kCount, std::less<long>,
+                  s21::static_map_lookup::perfect_hash>
+      hashed(items);
+  s21::static_map<long, int, kCount, std::less<long>,
+                  s21::static_map_lookup::binary_search>
+      searched(items);
+  auto it = expected.begin();
+  for (const auto &entry : hashed) {
+    EXPECT_EQ(entry.first, it->first);
+    ++it;
+  }
+  for (long key = -50010; key < 50010; key += 7) {
+    auto found = expected.find(key);
+    const int *in_hash = hashed.find(key);
+    const int *in_search = searched.find(key);
+    if (found == expected.end()) {
+      EXPECT_EQ(in_hash, nullptr) << key;
+      EXPECT_EQ(in_search, nullptr) << key;
+    } else {
+      ASSERT_NE(in_hash, nullptr) << key;
+      ASSERT_NE(in_search, nullptr) << key;
+      EXPECT_EQ(*in_hash, found->second);
+      EXPECT_EQ(*in_search, found->second);
+    }
+  }
+  for (const auto &[key, value] : expected) {
+    EXPECT_EQ(hashed.at(key), value);
+    EXPECT_EQ(searched.at(key), value);
+  }
+
+  std::pair<int, int> duplicate[] = {{1, 1}, {2, 2}, {1, 3}};
+  EXPECT_THROW(s21::make_static_map(duplicate), std::invalid_argument);
+}